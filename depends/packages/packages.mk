@@ -1,7 +1,7 @@
-packages:=boost openssl libevent zeromq
+packages:=boost openssl libevent zeromq zlib
 
 qt_native_packages = native_protobuf
-qt_packages = qrencode protobuf zlib
+qt_packages = qrencode protobuf
 
 qt_linux_packages:=qt expat dbus libxcb xcb_proto libXau xproto freetype fontconfig libX11 xextproto libXext xtrans
 
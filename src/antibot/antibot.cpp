@@ -235,13 +235,13 @@ bool AntiBot::check_post_edit(UniValue oitm, BlockVTX& blockVtx, bool checkMempo
     }
 
     // You are author? Really?
-    if (_original_post_itm["address"].As<string>() != _address) {
+    if (PocketSchema::Posts::address.String(_original_post_itm) != _address) {
         result = ANTIBOTRESULT::PostEditUnauthorized;
         return false;
     }
 
     // Original post edit only 24 hours
-    if (_time - _original_post_itm["time"].As<int64_t>() > GetActualLimit(Limit::edit_post_timeout, chainActive.Height() + 1)) {
+    if (_time - PocketSchema::Posts::time.Int64(_original_post_itm) > GetActualLimit(Limit::edit_post_timeout, chainActive.Height() + 1)) {
         result = ANTIBOTRESULT::PostEditLimit;
         return false;
     }
@@ -304,7 +304,7 @@ bool AntiBot::check_score(UniValue oitm, BlockVTX& blockVtx, bool checkMempool,
     std::string _post_address;
     reindexer::Item postItm;
     if (g_pocketdb->SelectOne(reindexer::Query("Posts").Where("txid", CondEq, _post), postItm).ok()) {
-        _post_address = postItm["address"].As<string>();
+        _post_address = PocketSchema::Posts::address.String(postItm);
 
         // Score to self post
         if (_post_address == _address) {
@@ -446,7 +446,7 @@ bool AntiBot::check_complain(UniValue oitm, BlockVTX& blockVtx, bool checkMempoo
         postItm
     ).ok()) {
         // Score to self post
-        if (postItm["address"].As<string>() == _address) {
+        if (PocketSchema::Posts::address.String(postItm) == _address) {
             result = ANTIBOTRESULT::SelfComplain;
             return false;
         }
@@ -564,7 +564,7 @@ bool AntiBot::check_changeInfo(UniValue oitm, BlockVTX& blockVtx, bool checkMemp
         reindexer::Query("UsersView").Where("address", CondEq, _address),
         userItm
     ).ok()) {
-        int64_t userUpdateTime = userItm["time"].As<int64_t>();
+        int64_t userUpdateTime = PocketSchema::UsersView::time.Int64(userItm);
         if (_time - userUpdateTime <= GetActualLimit(Limit::change_info_timeout, chainActive.Height() + 1)) {
             result = ANTIBOTRESULT::ChangeInfoLimit;
             return false;
@@ -816,7 +816,7 @@ bool AntiBot::check_comment(UniValue oitm, BlockVTX& blockVtx, bool checkMempool
     }
 
     // Blocking
-    if (g_pocketdb->Exists(Query("BlockingView").Where("address", CondEq, post_itm["address"].As<string>()).Where("address_to", CondEq, _address))) {
+    if (g_pocketdb->Exists(Query("BlockingView").Where("address", CondEq, PocketSchema::Posts::address.String(post_itm)).Where("address_to", CondEq, _address))) {
         result = ANTIBOTRESULT::Blocking;
         return false;
     }
@@ -902,19 +902,19 @@ bool AntiBot::check_comment_edit(UniValue oitm, BlockVTX& blockVtx, bool checkMe
     }
 
     // Parent comment
-    if (_parentid != _original_comment_itm["parentid"].As<string>() || (_parentid != "" && !g_pocketdb->Exists(Query("Comment").Where("otxid", CondEq, _parentid).Where("last", CondEq, true).Not().Where("msg", CondEq, "")))) {
+    if (_parentid != PocketSchema::Comment::parentid.String(_original_comment_itm) || (_parentid != "" && !g_pocketdb->Exists(Query("Comment").Where("otxid", CondEq, _parentid).Where("last", CondEq, true).Not().Where("msg", CondEq, "")))) {
         result = ANTIBOTRESULT::InvalidParentComment;
         return false;
     }
 
     // Answer comment
-    if (_answerid != _original_comment_itm["answerid"].As<string>() || (_answerid != "" && !g_pocketdb->Exists(Query("Comment").Where("otxid", CondEq, _answerid).Where("last", CondEq, true).Not().Where("msg", CondEq, "")))) {
+    if (_answerid != PocketSchema::Comment::answerid.String(_original_comment_itm) || (_answerid != "" && !g_pocketdb->Exists(Query("Comment").Where("otxid", CondEq, _answerid).Where("last", CondEq, true).Not().Where("msg", CondEq, "")))) {
         result = ANTIBOTRESULT::InvalidAnswerComment;
         return false;
     }
 
     // Original comment edit only 24 hours
-    if (_time - _original_comment_itm["time"].As<int64_t>() > GetActualLimit(Limit::edit_comment_timeout, chainActive.Height() + 1)) {
+    if (_time - PocketSchema::Comment::time.Int64(_original_comment_itm) > GetActualLimit(Limit::edit_comment_timeout, chainActive.Height() + 1)) {
         result = ANTIBOTRESULT::CommentEditLimit;
         return false;
     }
@@ -926,7 +926,7 @@ bool AntiBot::check_comment_edit(UniValue oitm, BlockVTX& blockVtx, bool checkMe
     }
 
     // Blocking
-    if (g_pocketdb->Exists(Query("BlockingView").Where("address", CondEq, post_itm["address"].As<string>()).Where("address_to", CondEq, _address))) {
+    if (g_pocketdb->Exists(Query("BlockingView").Where("address", CondEq, PocketSchema::Posts::address.String(post_itm)).Where("address_to", CondEq, _address))) {
         result = ANTIBOTRESULT::Blocking;
         return false;
     }
@@ -1005,13 +1005,13 @@ bool AntiBot::check_comment_delete(UniValue oitm, BlockVTX& blockVtx, bool check
     }
 
     // Parent comment
-    if (_parentid != _original_comment_itm["parentid"].As<string>()) {
+    if (_parentid != PocketSchema::Comment::parentid.String(_original_comment_itm)) {
         result = ANTIBOTRESULT::InvalidParentComment;
         return false;
     }
 
     // Answer comment
-    if (_answerid != _original_comment_itm["answerid"].As<string>()) {
+    if (_answerid != PocketSchema::Comment::answerid.String(_original_comment_itm)) {
         result = ANTIBOTRESULT::InvalidAnswerComment;
         return false;
     }
@@ -1071,7 +1071,7 @@ bool AntiBot::check_comment_score(UniValue oitm, BlockVTX& blockVtx, bool checkM
     std::string _comment_address;
     reindexer::Item commentItm;
     if (g_pocketdb->SelectOne(reindexer::Query("Comment").Where("otxid", CondEq, _comment_id), commentItm).ok()) {
-        _comment_address = commentItm["address"].As<string>();
+        _comment_address = PocketSchema::Comment::address.String(commentItm);
 
         // Score to self comment
         if (_comment_address == _address) {
@@ -1205,35 +1205,66 @@ void AntiBot::CheckTransactionRIItem(UniValue oitm, ANTIBOTRESULT& resultCode) {
 void AntiBot::CheckTransactionRIItem(UniValue oitm, BlockVTX& blockVtx, bool checkMempool, ANTIBOTRESULT& resultCode) {
     resultCode = ANTIBOTRESULT::Success;
     std::string table = oitm["table"].get_str();
-    std::string tx_type = oitm["type"].get_str();
     
     // If `item` with `txid` already in reindexer db - skip checks
     std::string _txid_check_exists = oitm["txid"].get_str();
     if (table == "Posts" && oitm["txidEdit"].get_str() != "") _txid_check_exists = oitm["txidEdit"].get_str();
     if (g_addrindex->CheckRItemExists(table, _txid_check_exists)) return;
 
+    if (!CheckOpReturnHash(oitm, resultCode)) return;
+
+    check_item_state(oitm, blockVtx, checkMempool, resultCode);
+}
+
+void AntiBot::CheckTransactionRIItemState(UniValue oitm, ANTIBOTRESULT opReturnResult, ANTIBOTRESULT& resultCode) {
+    resultCode = ANTIBOTRESULT::Success;
+    std::string table = oitm["table"].get_str();
+    
+    // If `item` with `txid` already in reindexer db - skip checks
+    std::string _txid_check_exists = oitm["txid"].get_str();
+    if (table == "Posts" && oitm["txidEdit"].get_str() != "") _txid_check_exists = oitm["txidEdit"].get_str();
+    if (g_addrindex->CheckRItemExists(table, _txid_check_exists)) return;
+
+    if (opReturnResult != ANTIBOTRESULT::Success) {
+        resultCode = opReturnResult;
+        return;
+    }
+
+    BlockVTX blockVtx;
+    check_item_state(oitm, blockVtx, true, resultCode);
+}
+
+bool AntiBot::CheckOpReturnHash(const UniValue& oitm, ANTIBOTRESULT& resultCode) {
+    resultCode = ANTIBOTRESULT::Success;
+    std::string table = oitm["table"].get_str();
+
     // Check consistent transaction and reindexer::Item
-    {
-        // Sorry, this life can be a lot of things.:)
-        std::map<std::string, std::string> op_return_checkpoints;
-        op_return_checkpoints.insert_or_assign("5741a02961547b401f9f9be17bd2c220bc6a98b4ff4d7909543e44adf3cb57e9", "603d2953b635a5963ad26da7f4d945e58ad511707c983cf11f96eadaa8511fa6");
-        op_return_checkpoints.insert_or_assign("551932e47d978aed0b955db0081f093634330fff3d473fc4de1c59c660558783", "26b5d9a177eecfc2387bb140acdaa5b26855dd8cd730fb11224df5fb403cd681");
-
-        std::vector<std::string> vasm;
-        boost::split(vasm, oitm["asm"].get_str(), boost::is_any_of("\t "));
-        if (vasm.size() < 3) {
-            resultCode = ANTIBOTRESULT::FailedOpReturn;
-            return;
-        }
+    // Sorry, this life can be a lot of things.:)
+    std::map<std::string, std::string> op_return_checkpoints;
+    op_return_checkpoints.insert_or_assign("5741a02961547b401f9f9be17bd2c220bc6a98b4ff4d7909543e44adf3cb57e9", "603d2953b635a5963ad26da7f4d945e58ad511707c983cf11f96eadaa8511fa6");
+    op_return_checkpoints.insert_or_assign("551932e47d978aed0b955db0081f093634330fff3d473fc4de1c59c660558783", "26b5d9a177eecfc2387bb140acdaa5b26855dd8cd730fb11224df5fb403cd681");
 
-        if ( ( vasm[2] != oitm["data_hash"].get_str() && vasm[2] != op_return_checkpoints[oitm["txid"].get_str()] ) ) {
-            if (table == "Users" && vasm[2] != oitm["data_hash_without_ref"].get_str()) {
-                resultCode = ANTIBOTRESULT::FailedOpReturn;
-                return;
-            }
+    std::vector<std::string> vasm;
+    boost::split(vasm, oitm["asm"].get_str(), boost::is_any_of("\t "));
+    if (vasm.size() < 3) {
+        resultCode = ANTIBOTRESULT::FailedOpReturn;
+        return false;
+    }
+
+    if ( ( vasm[2] != oitm["data_hash"].get_str() && vasm[2] != op_return_checkpoints[oitm["txid"].get_str()] ) ) {
+        if (table == "Users" && vasm[2] != oitm["data_hash_without_ref"].get_str()) {
+            resultCode = ANTIBOTRESULT::FailedOpReturn;
+            return false;
         }
     }
 
+    return true;
+}
+
+void AntiBot::check_item_state(UniValue oitm, BlockVTX& blockVtx, bool checkMempool, ANTIBOTRESULT& resultCode) {
+    std::string table = oitm["table"].get_str();
+    std::string tx_type = oitm["type"].get_str();
+
     // Hard fork for old inconcistents antibot rules
     if (chainActive.Height() <= Params().GetConsensus().nHeight_version_1_0_0_pre) return;
 
@@ -187,6 +187,9 @@ private:
     // Check new score to comment
     bool check_comment_score(UniValue oitm, BlockVTX& blockVtx, bool checkMempool, ANTIBOTRESULT& result);
 
+    // Checks of item against chain, mempool and RIDB state
+    void check_item_state(UniValue oitm, BlockVTX& blockVtx, bool checkMempool, ANTIBOTRESULT& resultCode);
+
 public:
     explicit AntiBot();
     ~AntiBot();
@@ -201,6 +204,17 @@ public:
 	*/
 	void CheckTransactionRIItem(UniValue oitm, BlockVTX& blockVtx, bool checkMempool, ANTIBOTRESULT& resultCode);
     void CheckTransactionRIItem(UniValue oitm, ANTIBOTRESULT& resultCode);
+    /*
+        Part of CheckTransactionRIItem that reads no chain state:
+        item data hash must match OP_RETURN of transaction.
+        Runs without cs_main.
+    */
+    bool CheckOpReturnHash(const UniValue& oitm, ANTIBOTRESULT& resultCode);
+    /*
+        CheckTransactionRIItem for item already checked
+        by CheckOpReturnHash with result `opReturnResult`
+    */
+    void CheckTransactionRIItemState(UniValue oitm, ANTIBOTRESULT opReturnResult, ANTIBOTRESULT& resultCode);
     /*
         Check inputs for exists utxo
     */
@@ -239,6 +239,18 @@ public:
     //! (memory only) Maximum nTime in the chain up to and including this block.
     unsigned int nTimeMax;
 
+    //! (memory only) Stake index, built by BuildStakeIndex when the block is connected or loaded.
+    //! Most recent proof-of-stake and proof-of-work blocks up to and including this block
+    const CBlockIndex* pindexLastStake;
+    const CBlockIndex* pindexLastWork;
+    //! (memory only) Most recent block that generated a stake modifier, or the genesis block
+    const CBlockIndex* pindexLastModifier;
+    //! (memory only) Oldest proof-of-stake block of the difficulty window ending at pindexLastStake
+    const CBlockIndex* pindexStakeWindow;
+    //! (memory only) Number of proof-of-stake blocks and sum of their difficulties up to and including this block
+    unsigned int nChainStakeBlocks;
+    double dChainStakeDifficulty;
+
     void SetNull()
     {
         phashBlock = nullptr;
@@ -254,6 +266,12 @@ public:
         nStatus = 0;
         nSequenceId = 0;
         nTimeMax = 0;
+        pindexLastStake = nullptr;
+        pindexLastWork = nullptr;
+        pindexLastModifier = nullptr;
+        pindexStakeWindow = nullptr;
+        nChainStakeBlocks = 0;
+        dChainStakeDifficulty = 0;
         nMint = 0;
         nMoneySupply = 0;
         nFlags = 0;
@@ -428,6 +446,11 @@ public:
         return (nFlags & BLOCK_STAKE_MODIFIER);
     }
 
+    bool HasStakeIndex() const
+    {
+        return pindexLastModifier != nullptr;
+    }
+
     //! Build the skiplist pointer for this entry.
     void BuildSkip();
 
@@ -102,8 +102,13 @@ typedef void* sockopt_arg_type;
 typedef char* sockopt_arg_type;
 #endif
 
+// Linux sockets are watched with epoll and poll, which are not limited by FD_SETSIZE
+#if defined(__linux__)
+#define USE_EPOLL
+#endif
+
 bool static inline IsSelectableSocket(const SOCKET& s) {
-#ifdef WIN32
+#if defined(USE_EPOLL) || defined(WIN32)
     return true;
 #else
     return (s < FD_SETSIZE);
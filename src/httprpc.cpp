@@ -9,6 +9,7 @@
 #include <key_io.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
+#include <rpc/stats.h>
 #include <random.h>
 #include <sync.h>
 #include <util.h>
@@ -16,8 +17,10 @@
 #include <ui_interface.h>
 #include <walletinitinterface.h>
 #include <crypto/hmac_sha256.h>
+#include <hash.h>
 #include <stdio.h>
 
+#include <cstring>
 #include <memory>
 
 #include <boost/algorithm/string.hpp> // boost::trim
@@ -145,6 +148,21 @@ static bool RPCAuthorized(const std::string& strAuth, std::string& strAuthUserna
     return multiUserAuthorized(strUserPass);
 }
 
+/** Check If-None-Match header value against ETag of reply */
+static bool ETagMatches(const std::string& header, const std::string& etag)
+{
+    std::vector<std::string> tags;
+    boost::split(tags, header, boost::is_any_of(","));
+    for (std::string tag : tags) {
+        boost::trim(tag);
+        if (tag == "*") return true;
+        // Weak comparison is enough for GET-like reads
+        if (tag.compare(0, 2, "W/") == 0) tag = tag.substr(2);
+        if (tag == etag) return true;
+    }
+    return false;
+}
+
 static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
 {
     // JSONRPC handles only POST
@@ -189,10 +207,23 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
         if (valRequest.isObject()) {
             jreq.parse(valRequest);
 
+            // Reply to calls depending only on chain tip is the same until the next block
+            std::string tipKey = tableRPC.GetTipCacheKey(jreq);
+            if (!tipKey.empty()) {
+                std::string etag = "\"" + Hash(tipKey.begin(), tipKey.end()).GetHex().substr(0, 32) + "\"";
+                req->WriteHeader("ETag", etag);
+                std::pair<bool, std::string> ifNoneMatch = req->GetHeader("If-None-Match");
+                if (ifNoneMatch.first && ETagMatches(ifNoneMatch.second, etag)) {
+                    req->WriteReply(HTTP_NOT_MODIFIED);
+                    return true;
+                }
+            }
+
             UniValue result = tableRPC.execute(jreq);
 
             // Send reply
             strReply = JSONRPCReply(result, NullUniValue, jreq.id);
+            g_rpc_stats.AddBytes(jreq.strMethod, strReply.size());
 
         // array of requests
         } else if (valRequest.isArray())
@@ -212,6 +243,129 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
     return true;
 }
 
+/** RPC counters in Prometheus text format */
+static bool HTTPReq_Metrics(HTTPRequest* req, const std::string &)
+{
+    if (req->GetRequestMethod() != HTTPRequest::GET) {
+        req->WriteReply(HTTP_BAD_METHOD, "Metrics are served only for GET requests");
+        return false;
+    }
+    // Call counts and latencies are served to the same users as RPC
+    std::pair<bool, std::string> authHeader = req->GetHeader("authorization");
+    std::string authUser;
+    if (!authHeader.first || !RPCAuthorized(authHeader.second, authUser)) {
+        if (authHeader.first) {
+            LogPrintf("ThreadRPCServer incorrect password attempt from %s\n", req->GetPeer().ToString());
+            MilliSleep(250);
+        }
+
+        req->WriteHeader("WWW-Authenticate", WWW_AUTH_HEADER_DATA);
+        req->WriteReply(HTTP_UNAUTHORIZED);
+        return false;
+    }
+
+    req->WriteHeader("Content-Type", "text/plain; version=0.0.4");
+    req->WriteReply(HTTP_OK, g_rpc_stats.ToPrometheus());
+    return true;
+}
+
+/** Bodies longer than this are not scanned for methods and go to the node queue */
+static const size_t MAX_QUEUE_SCAN_SIZE = 64 * 1024;
+
+/**
+ * Collect "method" values of a JSON-RPC request or batch without parsing the
+ * body. Only members of the top-level object, or of objects in the top-level
+ * array, are taken. Returns false if a method can not be read this way.
+ */
+static bool ScanJSONRPCMethods(const char* data, size_t size, std::vector<std::string>& methods)
+{
+    size_t i = 0;
+    auto skipSpace = [&]() { while (i < size && isspace((unsigned char)data[i])) i++; };
+
+    skipSpace();
+    if (i == size || (data[i] != '{' && data[i] != '[')) return false;
+    // Depth of objects holding request members
+    const int memberDepth = (data[i] == '[' ? 2 : 1);
+
+    int depth = 0;
+    while (i < size) {
+        char c = data[i];
+        if (c == '{' || c == '[') {
+            depth++;
+            i++;
+        } else if (c == '}' || c == ']') {
+            depth--;
+            i++;
+        } else if (c == '"') {
+            // Read string, escapes are only skipped
+            size_t start = ++i;
+            bool escaped = false;
+            while (i < size && data[i] != '"') {
+                if (data[i] == '\\') {
+                    escaped = true;
+                    i++;
+                }
+                i++;
+            }
+            if (i >= size) return false;
+            size_t end = i++;
+
+            if (depth != memberDepth || escaped || end - start != 6 || memcmp(data + start, "method", 6) != 0) continue;
+            skipSpace();
+            if (i == size || data[i] != ':') continue;
+            i++;
+            skipSpace();
+            if (i == size || data[i] != '"') return false;
+            start = ++i;
+            while (i < size && data[i] != '"' && data[i] != '\\') i++;
+            if (i == size || data[i] != '"') return false;
+            methods.emplace_back(data + start, i - start);
+            i++;
+        } else {
+            i++;
+        }
+    }
+
+    return !methods.empty();
+}
+
+/** Work queue of single JSON-RPC method */
+static HTTPWorkQueueClass JSONRPCQueueClass(const std::string& method)
+{
+    const CRPCCommand* pcmd = tableRPC[method];
+    if (!pcmd) return HTTP_QUEUE_NODE;
+    if (pcmd->category == "mining" || pcmd->category == "generating") return HTTP_QUEUE_MINING;
+    if (pcmd->readOnly) return HTTP_QUEUE_PUBLIC;
+    return HTTP_QUEUE_NODE;
+}
+
+/** Route JSON-RPC request by its method. Batch goes to the public queue
+ * only if all its calls are read-only. Runs in the HTTP event loop, so the
+ * body is only scanned, and only for authorized requests of limited size. */
+static HTTPWorkQueueClass HTTPReq_JSONRPC_Queue(HTTPRequest* req, const std::string &)
+{
+    if (req->GetRequestMethod() != HTTPRequest::POST) return HTTP_QUEUE_NODE;
+
+    // Unauthorized requests are rejected by the node queue
+    std::pair<bool, std::string> authHeader = req->GetHeader("authorization");
+    std::string authUser;
+    if (!authHeader.first || !RPCAuthorized(authHeader.second, authUser)) return HTTP_QUEUE_NODE;
+
+    std::pair<const char*, size_t> body = req->PeekBody();
+    if (!body.first || body.second > MAX_QUEUE_SCAN_SIZE) return HTTP_QUEUE_NODE;
+
+    std::vector<std::string> methods;
+    if (!ScanJSONRPCMethods(body.first, body.second, methods)) return HTTP_QUEUE_NODE;
+
+    HTTPWorkQueueClass result = HTTP_QUEUE_PUBLIC;
+    for (const std::string& method : methods) {
+        HTTPWorkQueueClass itemClass = JSONRPCQueueClass(method);
+        if (itemClass == HTTP_QUEUE_MINING) return itemClass;
+        if (itemClass == HTTP_QUEUE_NODE) result = itemClass;
+    }
+    return result;
+}
+
 static bool InitRPCAuthentication()
 {
     if (gArgs.GetArg("-rpcpassword", "") == "")
@@ -240,7 +394,11 @@ bool StartHTTPRPC()
     if (!InitRPCAuthentication())
         return false;
 
-    RegisterHTTPHandler("/", true, HTTPReq_JSONRPC);
+    RegisterHTTPHandler("/", true, HTTPReq_JSONRPC, HTTPReq_JSONRPC_Queue);
+    if (gArgs.GetBoolArg("-rpcmetrics", DEFAULT_RPC_METRICS)) {
+        RegisterHTTPHandler("/metrics", true, HTTPReq_Metrics,
+            [](HTTPRequest*, const std::string&) { return HTTP_QUEUE_PUBLIC; });
+    }
     if (g_wallet_init_interface.HasWalletSupport()) {
         RegisterHTTPHandler("/wallet/", false, HTTPReq_JSONRPC);
     }
@@ -260,6 +418,9 @@ void StopHTTPRPC()
 {
     LogPrint(BCLog::RPC, "Stopping HTTP RPC server\n");
     UnregisterHTTPHandler("/", true);
+    if (gArgs.GetBoolArg("-rpcmetrics", DEFAULT_RPC_METRICS)) {
+        UnregisterHTTPHandler("/metrics", true);
+    }
     if (g_wallet_init_interface.HasWalletSupport()) {
         UnregisterHTTPHandler("/wallet/", false);
     }
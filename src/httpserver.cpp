@@ -31,6 +31,9 @@
 
 #include <support/events.h>
 
+#include <boost/algorithm/string.hpp>
+#include <zlib.h>
+
 #ifdef EVENT__HAVE_NETINET_IN_H
 #include <netinet/in.h>
 #ifdef _XOPEN_SOURCE_EXTENDED
@@ -71,9 +74,14 @@ private:
     /** Mutex protects entire object */
     Mutex cs;
     std::condition_variable cond;
-    std::deque<std::unique_ptr<WorkItem>> queue;
+    /** Items with time they were queued at */
+    std::deque<std::pair<std::unique_ptr<WorkItem>, int64_t>> queue;
     bool running;
     size_t maxDepth;
+    uint64_t processed;
+    uint64_t rejected;
+    int64_t totalWaitMicros;
+    int64_t maxWaitMicros;
 
     // int maxsize = 0;
     // int period = 100;
@@ -81,7 +89,11 @@ private:
 
 public:
     explicit WorkQueue(size_t _maxDepth) : running(true),
-                                 maxDepth(_maxDepth)
+                                 maxDepth(_maxDepth),
+                                 processed(0),
+                                 rejected(0),
+                                 totalWaitMicros(0),
+                                 maxWaitMicros(0)
     {
     }
     /** Precondition: worker threads have all stopped (they have been joined).
@@ -106,10 +118,11 @@ public:
         //--------------------------
         
         if (queue.size() >= maxDepth) {
+            rejected++;
             return false;
         }
 
-        queue.emplace_back(std::unique_ptr<WorkItem>(item));
+        queue.emplace_back(std::unique_ptr<WorkItem>(item), GetTimeMicros());
         cond.notify_one();
 
         return true;
@@ -125,12 +138,28 @@ public:
                     cond.wait(lock);
                 if (!running)
                     break;
-                i = std::move(queue.front());
+                i = std::move(queue.front().first);
+                int64_t wait = GetTimeMicros() - queue.front().second;
                 queue.pop_front();
+
+                processed++;
+                totalWaitMicros += wait;
+                maxWaitMicros = std::max(maxWaitMicros, wait);
             }
             (*i)();
         }
     }
+    /** Fill counters of the queue */
+    void GetStats(HTTPWorkQueueStats& stats)
+    {
+        LOCK(cs);
+        stats.maxDepth = maxDepth;
+        stats.depth = queue.size();
+        stats.processed = processed;
+        stats.rejected = rejected;
+        stats.totalWaitMicros = totalWaitMicros;
+        stats.maxWaitMicros = maxWaitMicros;
+    }
     /** Interrupt and exit loops */
     void Interrupt()
     {
@@ -143,13 +172,30 @@ public:
 struct HTTPPathHandler
 {
     HTTPPathHandler() {}
-    HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler):
-        prefix(_prefix), exactMatch(_exactMatch), handler(_handler)
+    HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler, HTTPQueueSelector _selector):
+        prefix(_prefix), exactMatch(_exactMatch), handler(_handler), selector(_selector)
     {
     }
     std::string prefix;
     bool exactMatch;
     HTTPRequestHandler handler;
+    HTTPQueueSelector selector;
+};
+
+/** Settings of one work queue */
+struct HTTPWorkQueueParams
+{
+    const char* name;
+    const char* argThreads;
+    int defaultThreads;
+    const char* argDepth;
+    int defaultDepth;
+};
+
+static const HTTPWorkQueueParams workQueueParams[HTTP_QUEUE_COUNT] = {
+    {"node", "-rpcthreads", DEFAULT_HTTP_THREADS, "-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE},
+    {"public", "-rpcpublicthreads", DEFAULT_HTTP_PUBLIC_THREADS, "-rpcpublicworkqueue", DEFAULT_HTTP_PUBLIC_WORKQUEUE},
+    {"mining", "-rpcminingthreads", DEFAULT_HTTP_MINING_THREADS, "-rpcminingworkqueue", DEFAULT_HTTP_MINING_WORKQUEUE},
 };
 
 /** HTTP module state */
@@ -160,8 +206,12 @@ static struct event_base* eventBase = nullptr;
 struct evhttp* eventHTTP = nullptr;
 //! List of subnets to allow RPC connections from
 static std::vector<CSubNet> rpc_allow_subnets;
-//! Work queue for handling longer requests off the event loop thread
-static WorkQueue<HTTPClosure>* workQueue = nullptr;
+//! Replies of at least this size are compressed if client accepts it, 0 to disable
+static size_t nCompressMinSize = DEFAULT_HTTP_COMPRESS_MIN_SIZE;
+//! Work queues for handling longer requests off the event loop thread
+static WorkQueue<HTTPClosure>* workQueues[HTTP_QUEUE_COUNT] = {};
+//! Count of worker threads of every queue
+static int workQueueThreads[HTTP_QUEUE_COUNT] = {};
 //! Handlers for (sub)paths
 std::vector<HTTPPathHandler> pathHandlers;
 //! Bound listening sockets
@@ -276,12 +326,15 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
 
     // Dispatch to worker thread
     if (i != iend) {
+        HTTPWorkQueueClass queueClass = (i->selector ? i->selector(hreq.get(), path) : HTTP_QUEUE_NODE);
+        WorkQueue<HTTPClosure>* workQueue = workQueues[queueClass];
         std::unique_ptr<HTTPWorkItem> item(new HTTPWorkItem(std::move(hreq), path, i->handler));
         assert(workQueue);
         if (workQueue->Enqueue(item.get()))
             item.release(); /* if true, queue took ownership */
         else {
-            LogPrintf("WARNING: request rejected because http work queue depth exceeded, it can be increased with the -rpcworkqueue= setting\n");
+            LogPrintf("WARNING: request rejected because http %s work queue depth exceeded, it can be increased with the %s= setting\n",
+                workQueueParams[queueClass].name, workQueueParams[queueClass].argDepth);
             item->req->WriteReply(HTTP_INTERNAL, "Work queue depth exceeded");
         }
     } else {
@@ -396,6 +449,7 @@ bool InitHTTPServer()
     }
 
     evhttp_set_timeout(http, gArgs.GetArg("-rpcservertimeout", DEFAULT_HTTP_SERVER_TIMEOUT));
+    nCompressMinSize = std::max((long)gArgs.GetArg("-rpccompressminsize", DEFAULT_HTTP_COMPRESS_MIN_SIZE), 0L);
     evhttp_set_max_headers_size(http, MAX_HEADERS_SIZE);
     evhttp_set_max_body_size(http, MAX_SIZE);
     evhttp_set_gencb(http, http_request_cb, nullptr);
@@ -406,10 +460,13 @@ bool InitHTTPServer()
     }
 
     LogPrint(BCLog::HTTP, "Initialized HTTP server\n");
-    int workQueueDepth = std::max((long)gArgs.GetArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1L);
-    LogPrintf("HTTP: creating work queue of depth %d\n", workQueueDepth);
+    for (int i = 0; i < HTTP_QUEUE_COUNT; i++) {
+        const HTTPWorkQueueParams& params = workQueueParams[i];
+        int workQueueDepth = std::max((long)gArgs.GetArg(params.argDepth, params.defaultDepth), 1L);
+        LogPrintf("HTTP: creating %s work queue of depth %d\n", params.name, workQueueDepth);
 
-    workQueue = new WorkQueue<HTTPClosure>(workQueueDepth);
+        workQueues[i] = new WorkQueue<HTTPClosure>(workQueueDepth);
+    }
     // transfer ownership to eventBase/HTTP via .release()
     eventBase = base_ctr.release();
     eventHTTP = http_ctr.release();
@@ -437,14 +494,19 @@ static std::vector<std::thread> g_thread_http_workers;
 void StartHTTPServer()
 {
     LogPrint(BCLog::HTTP, "Starting HTTP server\n");
-    int rpcThreads = std::max((long)gArgs.GetArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
-    LogPrintf("HTTP: starting %d worker threads\n", rpcThreads);
     std::packaged_task<bool(event_base*)> task(ThreadHTTP);
     threadResult = task.get_future();
     threadHTTP = std::thread(std::move(task), eventBase);
 
-    for (int i = 0; i < rpcThreads; i++) {
-        g_thread_http_workers.emplace_back(HTTPWorkQueueRun, workQueue);
+    for (int i = 0; i < HTTP_QUEUE_COUNT; i++) {
+        const HTTPWorkQueueParams& params = workQueueParams[i];
+        int rpcThreads = std::max((long)gArgs.GetArg(params.argThreads, params.defaultThreads), 1L);
+        LogPrintf("HTTP: starting %d %s worker threads\n", rpcThreads, params.name);
+
+        workQueueThreads[i] = rpcThreads;
+        for (int j = 0; j < rpcThreads; j++) {
+            g_thread_http_workers.emplace_back(HTTPWorkQueueRun, workQueues[i]);
+        }
     }
 }
 
@@ -459,21 +521,25 @@ void InterruptHTTPServer()
         // Reject requests on current connections
         evhttp_set_gencb(eventHTTP, http_reject_request_cb, nullptr);
     }
-    if (workQueue)
-        workQueue->Interrupt();
+    for (auto workQueue : workQueues) {
+        if (workQueue)
+            workQueue->Interrupt();
+    }
 }
 
 void StopHTTPServer()
 {
     LogPrint(BCLog::HTTP, "Stopping HTTP server\n");
-    if (workQueue) {
+    if (workQueues[HTTP_QUEUE_NODE]) {
         LogPrint(BCLog::HTTP, "Waiting for HTTP worker threads to exit\n");
         for (auto& thread: g_thread_http_workers) {
             thread.join();
         }
         g_thread_http_workers.clear();
-        delete workQueue;
-        workQueue = nullptr;
+        for (auto& workQueue : workQueues) {
+            delete workQueue;
+            workQueue = nullptr;
+        }
     }
     if (eventBase) {
         LogPrint(BCLog::HTTP, "Waiting for HTTP event thread to exit\n");
@@ -502,6 +568,21 @@ void StopHTTPServer()
     LogPrint(BCLog::HTTP, "Stopped HTTP server\n");
 }
 
+std::vector<HTTPWorkQueueStats> GetHTTPWorkQueueStats()
+{
+    std::vector<HTTPWorkQueueStats> result;
+    for (int i = 0; i < HTTP_QUEUE_COUNT; i++) {
+        if (!workQueues[i]) continue;
+
+        HTTPWorkQueueStats stats;
+        stats.name = workQueueParams[i].name;
+        stats.threads = workQueueThreads[i];
+        workQueues[i]->GetStats(stats);
+        result.push_back(stats);
+    }
+    return result;
+}
+
 struct event_base* EventBase()
 {
     return eventBase;
@@ -578,6 +659,18 @@ std::string HTTPRequest::ReadBody()
     return rv;
 }
 
+std::pair<const char*, size_t> HTTPRequest::PeekBody() const
+{
+    struct evbuffer* buf = evhttp_request_get_input_buffer(req);
+    if (!buf)
+        return std::make_pair(nullptr, 0);
+    size_t size = evbuffer_get_length(buf);
+    const char* data = (const char*)evbuffer_pullup(buf, size);
+    if (!data)
+        return std::make_pair(nullptr, 0);
+    return std::make_pair(data, size);
+}
+
 void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
 {
     struct evkeyvalq* headers = evhttp_request_get_output_headers(req);
@@ -593,10 +686,21 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
 void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
 {
     assert(!replySent && req);
+    const std::string* body = &strReply;
+    std::string compressed;
+    if (nCompressMinSize > 0 && strReply.size() >= nCompressMinSize) {
+        HTTPContentEncoding encoding = ParseAcceptEncoding(GetHeader("Accept-Encoding").second);
+        if (encoding != HTTPContentEncoding::NONE && CompressHTTPBody(strReply, encoding, compressed) && compressed.size() < strReply.size()) {
+            WriteHeader("Content-Encoding", encoding == HTTPContentEncoding::GZIP ? "gzip" : "deflate");
+            body = &compressed;
+        }
+        WriteHeader("Vary", "Accept-Encoding");
+    }
+
     // Send event to main http thread to send reply message
     struct evbuffer* evb = evhttp_request_get_output_buffer(req);
     assert(evb);
-    evbuffer_add(evb, strReply.data(), strReply.size());
+    evbuffer_add(evb, body->data(), body->size());
     auto req_copy = req;
     HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
         evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
@@ -657,10 +761,10 @@ HTTPRequest::RequestMethod HTTPRequest::GetRequestMethod() const
     }
 }
 
-void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler)
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler, const HTTPQueueSelector &selector)
 {
     LogPrint(BCLog::HTTP, "Registering HTTP handler for %s (exactmatch %d)\n", prefix, exactMatch);
-    pathHandlers.push_back(HTTPPathHandler(prefix, exactMatch, handler));
+    pathHandlers.push_back(HTTPPathHandler(prefix, exactMatch, handler, selector));
 }
 
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch)
@@ -688,3 +792,54 @@ std::string urlDecode(const std::string &urlEncoded) {
     }
     return res;
 }
+
+HTTPContentEncoding ParseAcceptEncoding(const std::string& header)
+{
+    // q-values in thousandths, -1 if coding is not listed
+    int qGzip = -1, qDeflate = -1, qAny = -1;
+    std::vector<std::string> items;
+    boost::split(items, header, boost::is_any_of(","));
+    for (const std::string& item : items) {
+        std::string coding = boost::to_lower_copy(boost::trim_copy(item.substr(0, item.find(';'))));
+
+        int q = 1000;
+        size_t pos = item.find("q=");
+        if (pos != std::string::npos) {
+            double value = atof(item.c_str() + pos + 2);
+            q = (int)(std::min(std::max(value, 0.0), 1.0) * 1000);
+        }
+
+        if (coding == "gzip" || coding == "x-gzip") qGzip = q;
+        else if (coding == "deflate") qDeflate = q;
+        else if (coding == "*") qAny = q;
+    }
+
+    if (qGzip < 0) qGzip = std::max(qAny, 0);
+    if (qDeflate < 0) qDeflate = std::max(qAny, 0);
+    if (qGzip > 0 && qGzip >= qDeflate) return HTTPContentEncoding::GZIP;
+    if (qDeflate > 0) return HTTPContentEncoding::DEFLATE;
+    return HTTPContentEncoding::NONE;
+}
+
+bool CompressHTTPBody(const std::string& body, HTTPContentEncoding encoding, std::string& out)
+{
+    if (encoding == HTTPContentEncoding::NONE) return false;
+
+    // 16 added to window bits selects gzip wrapper instead of zlib one
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    int windowBits = (encoding == HTTPContentEncoding::GZIP ? MAX_WBITS + 16 : MAX_WBITS);
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+
+    out.resize(deflateBound(&stream, body.size()) + 32);
+    stream.next_in = (Bytef*)body.data();
+    stream.avail_in = body.size();
+    stream.next_out = (Bytef*)&out[0];
+    stream.avail_out = out.size();
+
+    int ret = deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return ret == Z_STREAM_END;
+}
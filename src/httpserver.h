@@ -8,10 +8,43 @@
 #include <string>
 #include <stdint.h>
 #include <functional>
+#include <vector>
 
 static const int DEFAULT_HTTP_THREADS=4;
 static const int DEFAULT_HTTP_WORKQUEUE=16;
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
+static const int DEFAULT_HTTP_PUBLIC_THREADS=4;
+static const int DEFAULT_HTTP_PUBLIC_WORKQUEUE=64;
+static const int DEFAULT_HTTP_MINING_THREADS=1;
+static const int DEFAULT_HTTP_MINING_WORKQUEUE=16;
+static const int DEFAULT_HTTP_COMPRESS_MIN_SIZE=1024;
+
+/** Work queues with own thread pools, so a burst of one class of requests
+ * cannot starve the others */
+enum HTTPWorkQueueClass {
+    HTTP_QUEUE_NODE = 0, //!< wallet, admin and everything else, -rpcthreads/-rpcworkqueue
+    HTTP_QUEUE_PUBLIC,   //!< read-only public queries
+    HTTP_QUEUE_MINING,   //!< mining and block templates
+    HTTP_QUEUE_COUNT
+};
+
+struct HTTPWorkQueueStats {
+    std::string name;
+    int threads;
+    size_t maxDepth;
+    size_t depth;
+    uint64_t processed;
+    uint64_t rejected;
+    int64_t totalWaitMicros;
+    int64_t maxWaitMicros;
+};
+
+/** Content codings replies can be compressed with */
+enum class HTTPContentEncoding {
+    NONE,
+    GZIP,
+    DEFLATE
+};
 
 struct evhttp_request;
 struct event_base;
@@ -38,14 +71,19 @@ bool UpdateHTTPServerLogging(bool enable);
 
 /** Handler for requests to a certain HTTP path */
 typedef std::function<bool(HTTPRequest* req, const std::string &)> HTTPRequestHandler;
+/** Chooses work queue for request, called on the event loop thread so must be cheap */
+typedef std::function<HTTPWorkQueueClass(HTTPRequest* req, const std::string &)> HTTPQueueSelector;
 /** Register handler for prefix.
  * If multiple handlers match a prefix, the first-registered one will
- * be invoked.
+ * be invoked. Without selector requests go to the node queue.
  */
-void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler);
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler, const HTTPQueueSelector &selector = nullptr);
 /** Unregister handler for prefix */
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
 
+/** Snapshot of work queue counters */
+std::vector<HTTPWorkQueueStats> GetHTTPWorkQueueStats();
+
 /** Return evhttp event base. This can be used by submodules to
  * queue timers or custom events.
  */
@@ -98,6 +136,12 @@ public:
      */
     std::string ReadBody();
 
+    /**
+     * Request body without consuming the buffer.
+     * The data stays valid until the body is read.
+     */
+    std::pair<const char*, size_t> PeekBody() const;
+
     /**
      * Write output header.
      *
@@ -109,6 +153,8 @@ public:
      * Write HTTP reply.
      * nStatus is the HTTP status code to send.
      * strReply is the body of the reply. Keep it empty to send a standard message.
+     * Large bodies are compressed here, on the calling worker thread,
+     * if the client accepts gzip or deflate.
      *
      * @note Can be called only once. As this will give the request back to the
      * main thread, do not call any other HTTPRequest methods after calling this.
@@ -150,4 +196,11 @@ private:
 
 std::string urlDecode(const std::string &urlEncoded);
 
+/** Choose reply coding from Accept-Encoding header value.
+ * Codings with the highest q-value win, gzip is preferred on ties.
+ */
+HTTPContentEncoding ParseAcceptEncoding(const std::string& header);
+/** Compress body with zlib, returns false on error */
+bool CompressHTTPBody(const std::string& body, HTTPContentEncoding encoding, std::string& out);
+
 #endif // POCKETCOIN_HTTPSERVER_H
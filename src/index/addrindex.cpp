@@ -125,7 +125,7 @@ bool AddrIndex::indexUTXO(const CTransactionRef& tx, CBlockIndex* pindex)
     return true;
 }
 
-bool AddrIndex::indexAddress(const CTransactionRef& tx, CBlockIndex* pindex)
+bool AddrIndex::indexAddress(const CTransactionRef& tx, const CBlockIndex* pindex)
 {
     std::string txid = tx->GetHash().GetHex();
 
@@ -153,46 +153,112 @@ bool AddrIndex::indexAddress(const CTransactionRef& tx, CBlockIndex* pindex)
     return true;
 }
 
-bool AddrIndex::indexTags(const CTransactionRef& tx, CBlockIndex* pindex)
+bool AddrIndex::indexTags(const CTransactionRef& tx, const CBlockIndex* pindex)
 {
-    // Check this transaction contains `Post`
-    std::string ri_table;
-    if (!GetPocketnetTXType(tx, ri_table) || ri_table != "Posts") return true;
+    if (!g_tagindex) return true;
 
-    // First get post with tags
+    // Transaction can be new post or edit of exists post
+    std::string txid = tx->GetHash().GetHex();
     reindexer::Item postItm;
-    if (!g_pocketdb->SelectOne(reindexer::Query("Posts").Where("txid", CondEq, tx->GetHash().GetHex()), postItm).ok()) return false;
+    if (!g_pocketdb->SelectOne(reindexer::Query("Posts").Where("txid", CondEq, txid).Where("txidEdit", CondEq, ""), postItm).ok()) {
+        if (!g_pocketdb->SelectOne(reindexer::Query("Posts").Where("txidEdit", CondEq, txid), postItm).ok()) {
+            // Already replaced by next edit in this block
+            return true;
+        }
+    }
+
+    return refreshTags(postItm["txid"].As<string>());
+}
 
-    // Parse tags and check exists
-    reindexer::VariantArray vaTags = postItm["tags"];
+bool AddrIndex::refreshTags(std::string posttxid)
+{
+    reindexer::Item postItm;
+    if (!g_pocketdb->SelectOne(reindexer::Query("Posts").Where("txid", CondEq, posttxid), postItm).ok()) {
+        g_tagindex->RemovePost(posttxid);
+        return true;
+    }
+
+    reindexer::VariantArray vaTags = PocketSchema::Posts::tags.Array(postItm);
     std::vector<std::string> vTags;
-    for (int i = 0; i < vaTags.size(); i++) {
-        std::string _tag = vaTags[i].As<string>();
-        if (_tag.size() > 0) {
-            reindexer::QueryResults _res;
-            g_pocketdb->Select(reindexer::Query("Tags").Where("tag", CondEq, _tag), _res);
-            if (_res.Count() > 0) {
-                for (auto& it : _res) {
-                    reindexer::Item _tagItm = it.GetItem();
-                    _tagItm["rating"] = _tagItm["rating"].As<int>() + 1;
-                    g_pocketdb->Update("Tags", _tagItm);
-                }
-            } else {
-                vTags.push_back(_tag);
-            }
-        }
+    for (size_t i = 0; i < vaTags.size(); i++) {
+        vTags.push_back(vaTags[i].As<string>());
     }
 
-    // Save new
-    if (vTags.size() > 0) {
-        for (auto& it : vTags) {
-            reindexer::Item _tagItm = g_pocketdb->DB()->NewItem("Tags");
-            _tagItm["tag"] = it;
-            _tagItm["rating"] = 1;
-            g_pocketdb->Upsert("Tags", _tagItm);
+    g_tagindex->AddPost(posttxid, PocketSchema::Posts::block.Int(postItm), PocketSchema::Posts::lang.String(postItm), vTags);
+    return true;
+}
+
+bool AddrIndex::RebuildTags(int height)
+{
+    if (!g_tagindex) return true;
+    g_tagindex->Clear();
+
+    reindexer::QueryResults _posts_res;
+    if (!g_pocketdb->DB()->Select(reindexer::Query("Posts"), _posts_res).ok()) return false;
+    for (auto& it : _posts_res) {
+        reindexer::Item postItm = it.GetItem();
+        reindexer::VariantArray vaTags = PocketSchema::Posts::tags.Array(postItm);
+        std::vector<std::string> vTags;
+        for (size_t i = 0; i < vaTags.size(); i++) {
+            vTags.push_back(vaTags[i].As<string>());
         }
+
+        g_tagindex->AddPost(PocketSchema::Posts::txid.String(postItm), PocketSchema::Posts::block.Int(postItm), PocketSchema::Posts::lang.String(postItm), vTags);
     }
 
+    g_tagindex->SetTip(height);
+    LogPrintf("Tag index: %d tags loaded from %d posts\n", g_tagindex->Size(), _posts_res.Count());
+    return true;
+}
+
+bool AddrIndex::indexComment(const CTransactionRef& tx, const CBlockIndex* pindex)
+{
+    if (!g_commenttree) return true;
+
+    // Edits and deletes keep place of comment in tree
+    reindexer::Item cmntItm;
+    if (!g_pocketdb->SelectOne(reindexer::Query("Comment").Where("txid", CondEq, tx->GetHash().GetHex()), cmntItm).ok()) return true;
+    std::string otxid = PocketSchema::Comment::otxid.String(cmntItm);
+    if (otxid != PocketSchema::Comment::txid.String(cmntItm)) return true;
+
+    g_commenttree->AddComment(otxid, PocketSchema::Comment::postid.String(cmntItm), PocketSchema::Comment::parentid.String(cmntItm),
+        PocketSchema::Comment::time.Int64(cmntItm), PocketSchema::Comment::block.Int(cmntItm));
+    return true;
+}
+
+bool AddrIndex::refreshComment(std::string otxid)
+{
+    if (!g_commenttree) return true;
+
+    reindexer::Item cmntItm;
+    if (!g_pocketdb->SelectOne(reindexer::Query("Comment").Where("txid", CondEq, otxid).Where("otxid", CondEq, otxid), cmntItm).ok()) {
+        g_commenttree->RemoveComment(otxid);
+        return true;
+    }
+
+    g_commenttree->AddComment(otxid, PocketSchema::Comment::postid.String(cmntItm), PocketSchema::Comment::parentid.String(cmntItm),
+        PocketSchema::Comment::time.Int64(cmntItm), PocketSchema::Comment::block.Int(cmntItm));
+    return true;
+}
+
+bool AddrIndex::RebuildCommentTree()
+{
+    if (!g_commenttree) return true;
+    g_commenttree->Clear();
+
+    // Every version of comment is stored, the first one has txid == otxid
+    reindexer::QueryResults _comments_res;
+    if (!g_pocketdb->DB()->Select(reindexer::Query("Comment"), _comments_res).ok()) return false;
+    for (auto& it : _comments_res) {
+        reindexer::Item cmntItm = it.GetItem();
+        std::string otxid = PocketSchema::Comment::otxid.String(cmntItm);
+        if (otxid != PocketSchema::Comment::txid.String(cmntItm)) continue;
+
+        g_commenttree->AddComment(otxid, PocketSchema::Comment::postid.String(cmntItm), PocketSchema::Comment::parentid.String(cmntItm),
+            PocketSchema::Comment::time.Int64(cmntItm), PocketSchema::Comment::block.Int(cmntItm));
+    }
+
+    LogPrintf("Comment tree: %d comments loaded\n", g_commenttree->Size());
     return true;
 }
 
@@ -235,14 +301,14 @@ bool AddrIndex::indexRating(const CTransactionRef& tx,
     // Find this Score in DB for get upvote value
     Item scoreItm;
     if (!g_pocketdb->SelectOne(reindexer::Query("Scores").Where("txid", CondEq, txid), scoreItm).ok()) return false;
-    std::string score_address = scoreItm["address"].As<string>();
-    std::string posttxid = scoreItm["posttxid"].As<string>();
-    int scoreVal = scoreItm["value"].As<int>();
+    std::string score_address = PocketSchema::Scores::address.String(scoreItm);
+    std::string posttxid = PocketSchema::Scores::posttxid.String(scoreItm);
+    int scoreVal = PocketSchema::Scores::value.Int(scoreItm);
 
     // Find post for get author address
     Item postItm;
     if (!g_pocketdb->SelectOne(reindexer::Query("Posts").Where("txid", CondEq, posttxid), postItm).ok()) return false;
-    std::string post_address = postItm["address"].As<string>();
+    std::string post_address = PocketSchema::Posts::address.String(postItm);
 
 
     // Save rating for post in any case
@@ -261,7 +327,7 @@ bool AddrIndex::indexRating(const CTransactionRef& tx,
     bool modify_by_user_reputation = g_antibot->AllowModifyReputationOverPost(_check_score_address, post_address, pindex->nHeight - 1, tx, false);
 
     // Scores to old posts not modify reputation
-    bool modify_block_old_post = (tx->nTime - postItm["time"].As<int64_t>()) < GetActualLimit(Limit::scores_depth_modify_reputation, pindex->nHeight - 1);
+    bool modify_block_old_post = (tx->nTime - PocketSchema::Posts::time.Int64(postItm)) < GetActualLimit(Limit::scores_depth_modify_reputation, pindex->nHeight - 1);
 
     // USER & POST reputation
     if (modify_by_user_reputation && modify_block_old_post) {
@@ -290,14 +356,14 @@ bool AddrIndex::indexCommentRating(const CTransactionRef& tx,
     // Find this Score in DB for get upvote value
     Item scoreCommentItm;
     if (!g_pocketdb->SelectOne(reindexer::Query("CommentScores").Where("txid", CondEq, txid), scoreCommentItm).ok()) return false;
-    std::string score_address = scoreCommentItm["address"].As<string>();
-    std::string commentid = scoreCommentItm["commentid"].As<string>();
-    int scoreVal = scoreCommentItm["value"].As<int>();
+    std::string score_address = PocketSchema::CommentScores::address.String(scoreCommentItm);
+    std::string commentid = PocketSchema::CommentScores::commentid.String(scoreCommentItm);
+    int scoreVal = PocketSchema::CommentScores::value.Int(scoreCommentItm);
 
     // Find comment for get author address
     Item commentItm;
     if (!g_pocketdb->SelectOne(reindexer::Query("Comment").Where("otxid", CondEq, commentid).Where("last", CondEq, true), commentItm).ok()) return false;
-    std::string comment_address = commentItm["address"].As<string>();
+    std::string comment_address = PocketSchema::Comment::address.String(commentItm);
 
 
     // Save rating for comment in any case
@@ -418,8 +484,120 @@ bool AddrIndex::computeCommentRatings(CBlockIndex* pindex, std::map<std::string,
     return true;
 }
 //-----------------------------------------------------
+// LOTTERY
+//-----------------------------------------------------
+bool AddrIndex::indexLottery(const CBlock& block, CBlockIndex* pindex)
+{
+    std::map<std::string, int> postCandidates;
+    std::map<std::string, int> commentCandidates;
+    if (!ComputeLotteryCandidates(block, pindex, postCandidates, commentCandidates)) return false;
+
+    // One item per block, also for blocks without candidates
+    std::vector<std::string> postAddresses, commentAddresses;
+    std::vector<int> postValues, commentValues;
+    for (const auto& it : postCandidates) {
+        postAddresses.push_back(it.first);
+        postValues.push_back(it.second);
+    }
+    for (const auto& it : commentCandidates) {
+        commentAddresses.push_back(it.first);
+        commentValues.push_back(it.second);
+    }
+
+    reindexer::Item _itm = g_pocketdb->DB()->NewItem("Lottery");
+    _itm["block"] = pindex->nHeight;
+    _itm["hash"] = pindex->GetBlockHash().GetHex();
+    _itm["post_address"] = postAddresses;
+    _itm["post_value"] = postValues;
+    _itm["comment_address"] = commentAddresses;
+    _itm["comment_value"] = commentValues;
+    return g_pocketdb->UpsertWithCommit("Lottery", _itm).ok();
+}
+//-----------------------------------------------------
 // PUBLIC
 //-----------------------------------------------------
+bool AddrIndex::ComputeLotteryCandidates(const CBlock& block, const CBlockIndex* pindex,
+    std::map<std::string, int>& postCandidates, std::map<std::string, int>& commentCandidates)
+{
+    for (const auto& tx : block.vtx) {
+        std::vector<std::string> vasm;
+        if (!FindPocketNetAsmString(tx, vasm)) continue;
+        if ((vasm[1] == OR_SCORE || vasm[1] == OR_COMMENT_SCORE) && vasm.size() >= 4) {
+            std::vector<unsigned char> _data_hex = ParseHex(vasm[3]);
+            std::string _data_str(_data_hex.begin(), _data_hex.end());
+            std::vector<std::string> _data;
+            boost::split(_data, _data_str, boost::is_any_of("\t "));
+            if (_data.size() >= 2) {
+                std::string _address = _data[0];
+                int _value = std::stoi(_data[1]);
+
+                // For lottery use scores as 4=1 and 5=2 - Scores to posts
+                if (vasm[1] == OR_SCORE && (_value == 4 || _value == 5)) {
+                    // Get address of score initiator
+                    reindexer::Item _score_itm;
+                    if (!g_pocketdb->SelectOne( reindexer::Query("Scores").Where("txid", CondEq, tx->GetHash().GetHex()), _score_itm ).ok()) {
+                        LogPrintf("--- ComputeLotteryCandidates error get score: %s\n", tx->GetHash().GetHex());
+                        continue;
+                    }
+
+                    reindexer::Item _post_itm;
+                    if (!g_pocketdb->SelectOne( reindexer::Query("Posts").Where("txid", CondEq, _score_itm["posttxid"].As<string>()), _post_itm ).ok()) {
+                        LogPrintf("--- ComputeLotteryCandidates error get post: %s\n", _score_itm["posttxid"].As<string>());
+                        continue;
+                    }
+
+                    if (g_antibot->AllowModifyReputationOverPost(_score_itm["address"].As<string>(), _post_itm["address"].As<string>(), pindex->nHeight, tx, true)) {
+                        postCandidates[_address] += (_value - 3);
+                    }
+                }
+
+                // For lottery use scores as 1 and -1 - Scores to comments
+                if (vasm[1] == OR_COMMENT_SCORE && (_value == 1)) {
+                    // Get address of score initiator
+                    reindexer::Item _score_itm;
+                    if (!g_pocketdb->SelectOne( reindexer::Query("CommentScores").Where("txid", CondEq, tx->GetHash().GetHex()), _score_itm ).ok()) {
+                        LogPrintf("--- ComputeLotteryCandidates error get comment score: %s\n", tx->GetHash().GetHex());
+                        continue;
+                    }
+
+                    reindexer::Item _comment_itm;
+                    if (!g_pocketdb->SelectOne( reindexer::Query("Comment").Where("otxid", CondEq, _score_itm["commentid"].As<string>()), _comment_itm ).ok()) {
+                        LogPrintf("--- ComputeLotteryCandidates error get comment: %s\n", _score_itm["posttxid"].As<string>());
+                        continue;
+                    }
+
+                    if (g_antibot->AllowModifyReputationOverComment(_score_itm["address"].As<string>(), _comment_itm["address"].As<string>(), pindex->nHeight, tx, true)) {
+                        commentCandidates[_address] += _value;
+                    }
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+bool AddrIndex::GetLotteryCandidates(const CBlockIndex* pindex,
+    std::map<std::string, int>& postCandidates, std::map<std::string, int>& commentCandidates)
+{
+    reindexer::Item _itm;
+    if (!g_pocketdb->SelectOne(reindexer::Query("Lottery").Where("block", CondEq, pindex->nHeight), _itm).ok()) return false;
+    if (_itm["hash"].As<string>() != pindex->GetBlockHash().GetHex()) return false;
+
+    reindexer::VariantArray postAddresses = _itm["post_address"];
+    reindexer::VariantArray postValues = _itm["post_value"];
+    reindexer::VariantArray commentAddresses = _itm["comment_address"];
+    reindexer::VariantArray commentValues = _itm["comment_value"];
+    if (postAddresses.size() != postValues.size() || commentAddresses.size() != commentValues.size()) return false;
+
+    for (size_t i = 0; i < postAddresses.size(); i++)
+        postCandidates[postAddresses[i].As<string>()] = postValues[i].As<int>();
+    for (size_t i = 0; i < commentAddresses.size(); i++)
+        commentCandidates[commentAddresses[i].As<string>()] = commentValues[i].As<int>();
+
+    return true;
+}
+
 bool AddrIndex::IndexBlock(const CBlock& block, CBlockIndex* pindex)
 {
     // User reputations map for this block
@@ -494,6 +672,36 @@ bool AddrIndex::IndexBlock(const CBlock& block, CBlockIndex* pindex)
         return false;
     }
 
+    // Lottery of the next block is drawn from scores of this block
+    if (!indexLottery(block, pindex)) {
+        LogPrintf("(AddrIndex::IndexBlock) indexLottery - block (%s)\n", block.GetHash().GetHex());
+        return false;
+    }
+
+    return true;
+}
+
+bool AddrIndex::IndexBlockDerived(const CBlock& block, const CBlockIndex* pindex)
+{
+    for (const auto& tx : block.vtx) {
+        std::string ri_table;
+        if (!GetPocketnetTXType(tx, ri_table)) continue;
+
+        // Indexing tags
+        if (ri_table == "Posts" && !indexTags(tx, pindex)) {
+            LogPrintf("(AddrIndex::IndexBlockDerived) indexTags - tx (%s)\n", tx->GetHash().GetHex());
+            return false;
+        }
+
+        // Indexing comment tree
+        if (ri_table == "Comment" && !indexComment(tx, pindex)) {
+            LogPrintf("(AddrIndex::IndexBlockDerived) indexComment - tx (%s)\n", tx->GetHash().GetHex());
+            return false;
+        }
+    }
+
+    if (g_tagindex) g_tagindex->SetTip(pindex->nHeight);
+
     return true;
 }
 
@@ -546,9 +754,9 @@ bool AddrIndex::WriteRTransaction(std::string table, reindexer::Item& item, int
 
         reindexer::Item user_cur;
         if (g_pocketdb->SelectOne(reindexer::Query("UsersView").Where("address", CondEq, _address), user_cur).ok()) {
-            item["id"] = user_cur["id"].As<int>();
-            item["regdate"] = user_cur["regdate"].As<int64_t>();
-            item["referrer"] = user_cur["referrer"].As<string>();
+            item["id"] = PocketSchema::UsersView::id.Int(user_cur);
+            item["regdate"] = PocketSchema::UsersView::regdate.Int64(user_cur);
+            item["referrer"] = PocketSchema::UsersView::referrer.String(user_cur);
         } else {
             item["id"] = (int)g_pocketdb->SelectTotalCount("UsersView");
             item["regdate"] = item["time"].As<int64_t>();
@@ -664,28 +872,6 @@ bool AddrIndex::RollbackDB(int blockHeight, bool back_to_mempool)
             reindexer::Item _delete_post_itm = it.GetItem();
             std::string _post_txid = _delete_post_itm["txid"].As<string>();
 
-            // TODO (brangr): Temporaly remove tags
-            {
-                // reindexer::VariantArray vaTags = _post_itm["tags"];
-                // std::vector<std::string> vTags;
-                // for (int i = 0; i < vaTags.size(); i++) {
-                //     std::string _tag = vaTags[i].As<string>();
-                //     if (_tag.size() > 0) {
-                //         vTags.push_back(_tag);
-                //     }
-                // }
-
-                // if (vTags.size() > 0) {
-                //     reindexer::QueryResults _res;
-                //     g_pocketdb->Select(reindexer::Query("Tags").Where("tag", CondSet, vTags), _res);
-                //     for (auto& it : _res) {
-                //         reindexer::Item _tagItm = it.GetItem();
-                //         _tagItm["rating"] = _tagItm["rating"].As<int>() - 1;
-                //         g_pocketdb->Update("Tags", _tagItm);
-                //     }
-                // }
-            }
-
             if (back_to_mempool && !insert_to_mempool(_delete_post_itm, "Posts")) return false;
             if (!g_pocketdb->RestorePostItem(_post_txid, blockHeight).ok()) return false;
         }
@@ -725,6 +911,11 @@ bool AddrIndex::RollbackDB(int blockHeight, bool back_to_mempool)
         }
     }
 
+    // Rollback lottery candidates
+    {
+        if (!g_pocketdb->DeleteWithCommit(reindexer::Query("Lottery").Where("block", CondGt, blockHeight)).ok()) return false;
+    }
+
     // Rollback Addresses
     {
         if (!g_pocketdb->DeleteWithCommit(reindexer::Query("Addresses").Where("block", CondGt, blockHeight)).ok()) return false;
@@ -885,6 +1076,26 @@ bool AddrIndex::RollbackDB(int blockHeight, bool back_to_mempool)
     return true;
 }
 
+bool AddrIndex::RollbackDerived(int blockHeight)
+{
+    // Tags of removed posts and restored versions of edited posts
+    if (g_tagindex) {
+        for (const auto& _post_txid : g_tagindex->GetPostsAbove(blockHeight)) {
+            if (!refreshTags(_post_txid)) return false;
+        }
+        g_tagindex->SetTip(blockHeight);
+    }
+
+    // Comments written in removed blocks
+    if (g_commenttree) {
+        for (const auto& _otxid : g_commenttree->GetCommentsAbove(blockHeight)) {
+            if (!refreshComment(_otxid)) return false;
+        }
+    }
+
+    return true;
+}
+
 bool AddrIndex::GetAddressRegistrationDate(std::vector<std::string> addresses,
     std::vector<AddressRegistrationItem>& registrations)
 {
@@ -945,9 +1156,9 @@ bool AddrIndex::GetUnspentTransactions(std::vector<std::string> addresses,
             reindexer::Item itm(it.GetItem());
             transactions.emplace_back(
                 AddressUnspentTransactionItem(
-                    itm["address"].As<string>(),
-                    itm["txid"].As<string>(),
-                    itm["txout"].As<int>()));
+                    PocketSchema::UTXO::address.String(itm),
+                    PocketSchema::UTXO::txid.String(itm),
+                    PocketSchema::UTXO::txout.Int(itm)));
         }
     }
     //-------------------------
@@ -960,7 +1171,7 @@ int64_t AddrIndex::GetUserRegistrationDate(std::string _address)
     reindexer::Error err = g_pocketdb->SelectOne(reindexer::Query("UsersView").Where("address", CondEq, _address), userItm);
 
     if (err.ok()) {
-        return userItm["regdate"].As<int64_t>();
+        return PocketSchema::UsersView::regdate.Int64(userItm);
     } else {
         return -1;
     }
@@ -968,6 +1179,8 @@ int64_t AddrIndex::GetUserRegistrationDate(std::string _address)
 
 bool AddrIndex::GetRecomendedSubscriptions(std::string _address, int count, std::vector<string>& recommendedSubscriptions)
 {
+    if (g_recommendations && g_recommendations->GetSubscriptions(_address, count, recommendedSubscriptions)) return true;
+
     int sampleSize = 1000; // size of representative sample
 
     std::vector<std::string> subscriptions;
@@ -1076,6 +1289,8 @@ bool AddrIndex::GetRecomendedSubscriptions(std::string _address, int count, std:
 
 bool AddrIndex::GetRecommendedPostsBySubscriptions(std::string _address, int count, std::set<string>& recommendedPosts)
 {
+    if (g_recommendations && g_recommendations->GetPostsBySubscriptions(_address, count, recommendedPosts)) return true;
+
     std::vector<std::string> subscriptions;
     GetRecomendedSubscriptions(_address, count, subscriptions);
 
@@ -1094,6 +1309,8 @@ bool AddrIndex::GetRecommendedPostsBySubscriptions(std::string _address, int cou
 
 bool AddrIndex::GetRecommendedPostsByScores(std::string _address, int count, std::set<string>& recommendedPosts)
 {
+    if (g_recommendations && g_recommendations->GetPostsByScores(_address, count, recommendedPosts)) return true;
+
     int sampleSize = 1000; // size of representative sample
 
     std::vector<std::string> userLikedPosts;
@@ -1394,20 +1611,20 @@ bool AddrIndex::ComputeRHash(CBlockIndex* pindexPrev, std::string& hash)
                 std::string _postsData = "";
                 reindexer::Item postItm(postIt.GetItem());
 
-                _postsData += postItm["txid"].As<string>();
-                _postsData += postItm["block"].As<string>();
-                _postsData += postItm["time"].As<string>();
-                _postsData += postItm["address"].As<string>();
-                _postsData += postItm["lang"].As<string>();
-                _postsData += postItm["caption"].As<string>();
-                _postsData += postItm["message"].As<string>();
-                _postsData += postItm["settings"].As<string>();
-                _postsData += postItm["url"].As<string>();
-
-                reindexer::VariantArray postTags = postItm["tags"];
+                _postsData += PocketSchema::Posts::txid.String(postItm);
+                _postsData += PocketSchema::Posts::block.String(postItm);
+                _postsData += PocketSchema::Posts::time.String(postItm);
+                _postsData += PocketSchema::Posts::address.String(postItm);
+                _postsData += PocketSchema::Posts::lang.String(postItm);
+                _postsData += PocketSchema::Posts::caption.String(postItm);
+                _postsData += PocketSchema::Posts::message.String(postItm);
+                _postsData += PocketSchema::Posts::settings.String(postItm);
+                _postsData += PocketSchema::Posts::url.String(postItm);
+
+                reindexer::VariantArray postTags = PocketSchema::Posts::tags.Array(postItm);
                 for (unsigned int i = 0; i < postTags.size(); i++) { _postsData += postTags[i].As<string>(); }
 
-                reindexer::VariantArray postImages = postItm["images"];
+                reindexer::VariantArray postImages = PocketSchema::Posts::images.Array(postItm);
                 for (unsigned int i = 0; i < postImages.size(); i++) { _postsData += postImages[i].As<string>(); }
 
                 postsData += ComputeHash(_postsData);
@@ -1425,12 +1642,12 @@ bool AddrIndex::ComputeRHash(CBlockIndex* pindexPrev, std::string& hash)
                 std::string _scoresData = "";
                 reindexer::Item scoreItm(scoreIt.GetItem());
 
-                _scoresData += scoreItm["txid"].As<string>();
-                _scoresData += scoreItm["block"].As<string>();
-                _scoresData += scoreItm["time"].As<string>();
-                _scoresData += scoreItm["posttxid"].As<string>();
-                _scoresData += scoreItm["address"].As<string>();
-                _scoresData += scoreItm["value"].As<string>();
+                _scoresData += PocketSchema::Scores::txid.String(scoreItm);
+                _scoresData += PocketSchema::Scores::block.String(scoreItm);
+                _scoresData += PocketSchema::Scores::time.String(scoreItm);
+                _scoresData += PocketSchema::Scores::posttxid.String(scoreItm);
+                _scoresData += PocketSchema::Scores::address.String(scoreItm);
+                _scoresData += PocketSchema::Scores::value.String(scoreItm);
 
                 scoresData += ComputeHash(_scoresData);
             }
@@ -7,6 +7,9 @@
 #include "pocketdb/pocketdb.h"
 #include "pocketdb/pocketnet.h"
 #include "antibot/antibot.h"
+#include "index/recommendations.h"
+#include "index/tagindex.h"
+#include "index/commenttree.h"
 #include "primitives/block.h"
 #include "script/standard.h"
 #include "key_io.h"
@@ -95,13 +98,28 @@ private:
 		Indexing block transactions for collect tags.
 		OP_RETURN can contains `OR_POST` value - its Post
 	*/
-	bool indexTags(const CTransactionRef& tx, CBlockIndex* pindex);
+	bool indexTags(const CTransactionRef& tx, const CBlockIndex* pindex);
+	/*
+		Reload tags of post from current version in DB.
+		Removes post from tag index if it not exists.
+	*/
+	bool refreshTags(std::string posttxid);
+	/*
+		Add new comment to comment tree.
+		OP_RETURN can contains `OR_COMMENT` value - its Comment
+	*/
+	bool indexComment(const CTransactionRef& tx, const CBlockIndex* pindex);
+	/*
+		Reload comment from first version in DB.
+		Removes comment from tree if it not exists.
+	*/
+	bool refreshComment(std::string otxid);
 	/*
 		Save first occurrence of address.
 		Essentially the first mention in out of transactions.
 		ONLY FIRST!
 	*/
-	bool indexAddress(const CTransactionRef& tx, CBlockIndex* pindex);
+	bool indexAddress(const CTransactionRef& tx, const CBlockIndex* pindex);
 	/*
 		Aggregate table UserRatings for all users
 	*/
@@ -118,6 +136,11 @@ private:
         Indexing posts data
     */
     bool indexPost(const CTransactionRef& tx, CBlockIndex* pindex);
+    /*
+        Save lottery candidates of block.
+        Must run after ratings of block are computed
+    */
+    bool indexLottery(const CBlock& block, CBlockIndex* pindex);
 
 public:
     explicit AddrIndex();
@@ -142,8 +165,15 @@ public:
     bool IsPocketnetTransaction(const CTransaction& tx);
 	/*
 		Indexing block transactions.
+		Only data read by consensus rules, runs while connecting block.
 	*/
     bool IndexBlock(const CBlock& block, CBlockIndex* pindex);
+	/*
+		Indexing block data no consensus rule reads:
+		tags and comment tree.
+		Runs by PocketIndex after block is connected.
+	*/
+    bool IndexBlockDerived(const CBlock& block, const CBlockIndex* pindex);
 	/*
 		Fix tables data.
 		New current best block is `bestBlock`
@@ -151,6 +181,20 @@ public:
 		Also need recalculating ratings
 	*/
 	bool RollbackDB(int blockHeight, bool back_to_mempool=false);
+	/*
+		Remove derived data above `blockHeight`.
+		Counterpart of IndexBlockDerived.
+	*/
+	bool RollbackDerived(int blockHeight);
+	/*
+		Fill tag dictionary from all current Posts.
+		Recency window ends at `height`, the current chain tip.
+	*/
+	bool RebuildTags(int height);
+	/*
+		Fill comment tree from all current Comments.
+	*/
+	bool RebuildCommentTree();
 	/*
 		Get all unspent transactions for array of addresses.
 		Function fill array `std::map<std::string, int>& transactions`.
@@ -181,6 +225,19 @@ public:
 	bool GetRecomendedSubscriptions(std::string _address, int count, std::vector<string>& recommendedSubscriptions);
     bool GetRecommendedPostsBySubscriptions(std::string _address, int count, std::set<string>& recommendedPosts);
     bool GetRecommendedPostsByScores(std::string _address, int count, std::set<string>& recommendedPosts);
+	/*
+		Lottery candidates of block: author of scored content with summed
+		weight of positive scores allowed to modify reputation.
+		Computed from block transactions and RIDB state after the block.
+	*/
+	bool ComputeLotteryCandidates(const CBlock& block, const CBlockIndex* pindex,
+		std::map<std::string, int>& postCandidates, std::map<std::string, int>& commentCandidates);
+	/*
+		Lottery candidates saved while indexing block.
+		Returns false if block was indexed without them.
+	*/
+	bool GetLotteryCandidates(const CBlockIndex* pindex,
+		std::map<std::string, int>& postCandidates, std::map<std::string, int>& commentCandidates);
 	/*
 		Get RI data for block transactions for send to another node.
 	*/
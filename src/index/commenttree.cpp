@@ -0,0 +1,112 @@
+// Copyright (c) 2019 PocketNet developers
+// In-memory tree of post comments
+//-----------------------------------------------------
+#include "index/commenttree.h"
+
+#include <algorithm>
+//-----------------------------------------------------
+std::unique_ptr<CommentTree> g_commenttree;
+//-----------------------------------------------------
+void CommentTree::remove(const std::string& id)
+{
+    AssertLockHeld(cs);
+
+    auto it = comments.find(id);
+    if (it == comments.end()) return;
+    const Comment& cmnt = it->second;
+
+    if (cmnt.parentid.empty()) {
+        auto& list = roots[cmnt.postid];
+        list.erase({cmnt.time, id});
+        if (list.empty()) roots.erase(cmnt.postid);
+    } else {
+        auto& list = replies[cmnt.parentid];
+        list.erase({cmnt.time, id});
+        if (list.empty()) replies.erase(cmnt.parentid);
+    }
+
+    auto& block = blocks[cmnt.block];
+    block.erase(id);
+    if (block.empty()) blocks.erase(cmnt.block);
+
+    comments.erase(it);
+}
+
+void CommentTree::AddComment(const std::string& id, const std::string& postid, const std::string& parentid, int64_t time, int block)
+{
+    LOCK(cs);
+    remove(id);
+
+    comments[id] = Comment{postid, parentid, time, block};
+    if (parentid.empty())
+        roots[postid].emplace(time, id);
+    else
+        replies[parentid].emplace(time, id);
+    blocks[block].insert(id);
+}
+
+void CommentTree::RemoveComment(const std::string& id)
+{
+    LOCK(cs);
+    remove(id);
+}
+
+std::vector<std::string> CommentTree::GetCommentsAbove(int height) const
+{
+    LOCK(cs);
+    std::vector<std::string> result;
+    for (auto it = blocks.upper_bound(height); it != blocks.end(); ++it)
+        result.insert(result.end(), it->second.begin(), it->second.end());
+    return result;
+}
+
+void CommentTree::Clear()
+{
+    LOCK(cs);
+    comments.clear();
+    roots.clear();
+    replies.clear();
+    blocks.clear();
+}
+
+int CommentTree::GetThreads(const std::string& postid, int skip, int count, int replyCount, std::vector<CommentThread>& result) const
+{
+    LOCK(cs);
+    auto post = roots.find(postid);
+    if (post == roots.end()) return 0;
+
+    const ordered_t& list = post->second;
+    int total = (int)list.size();
+    if (skip >= total || count <= 0) return total;
+
+    // Newest roots first
+    auto root = list.rbegin();
+    std::advance(root, std::max(skip, 0));
+    for (; root != list.rend() && count > 0; ++root, --count) {
+        CommentThread thread{root->second, 0, {}};
+
+        auto children = replies.find(root->second);
+        if (children != replies.end()) {
+            thread.children = (int)children->second.size();
+            for (auto reply = children->second.begin(); reply != children->second.end() && (int)thread.replies.size() < replyCount; ++reply)
+                thread.replies.push_back(reply->second);
+        }
+
+        result.push_back(std::move(thread));
+    }
+
+    return total;
+}
+
+int CommentTree::GetChildrenCount(const std::string& id) const
+{
+    LOCK(cs);
+    auto children = replies.find(id);
+    return children == replies.end() ? 0 : (int)children->second.size();
+}
+
+size_t CommentTree::Size() const
+{
+    LOCK(cs);
+    return comments.size();
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2019 PocketNet developers
+// In-memory tree of post comments
+//-----------------------------------------------------
+#ifndef COMMENTTREE_H
+#define COMMENTTREE_H
+//-----------------------------------------------------
+#include <sync.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+//-----------------------------------------------------
+/*
+    Root comment of post with first replies
+*/
+struct CommentThread
+{
+    std::string id;
+    int children;
+    std::vector<std::string> replies;
+};
+//-----------------------------------------------------
+/*
+    Comments of every post as tree: post -> roots, comment -> replies.
+    Comment is identified by its original txid (`otxid`), order is given
+    by time of the original version: roots newest first, replies in order
+    of writing. Edit and delete do not move comment, so only first versions
+    are indexed; rollback re-reads comments of removed blocks from PocketDB.
+*/
+class CommentTree
+{
+private:
+    typedef std::set<std::pair<int64_t, std::string>> ordered_t;
+
+    struct Comment
+    {
+        std::string postid;
+        std::string parentid;
+        int64_t time;
+        int block;
+    };
+
+    mutable CCriticalSection cs;
+    // otxid -> comment
+    std::map<std::string, Comment> comments;
+    // postid -> roots ordered by time
+    std::map<std::string, ordered_t> roots;
+    // otxid of parent -> replies ordered by time
+    std::map<std::string, ordered_t> replies;
+    // block -> otxids of comments
+    std::map<int, std::set<std::string>> blocks;
+
+    void remove(const std::string& id);
+
+public:
+    /* Add comment or move it if exists */
+    void AddComment(const std::string& id, const std::string& postid, const std::string& parentid, int64_t time, int block);
+    void RemoveComment(const std::string& id);
+    /* Otxids of comments first written above height, used on rollback */
+    std::vector<std::string> GetCommentsAbove(int height) const;
+    void Clear();
+
+    /*
+        Roots of post starting from `skip`, each with up to `replyCount` first replies.
+        Returns total count of roots.
+    */
+    int GetThreads(const std::string& postid, int skip, int count, int replyCount, std::vector<CommentThread>& result) const;
+    /* Count of direct replies to comment */
+    int GetChildrenCount(const std::string& id) const;
+
+    size_t Size() const;
+};
+//-----------------------------------------------------
+extern std::unique_ptr<CommentTree> g_commenttree;
+//-----------------------------------------------------
+#endif // COMMENTTREE_H
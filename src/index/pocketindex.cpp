@@ -0,0 +1,63 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/pocketindex.h>
+#include <index/addrindex.h>
+#include <util.h>
+#include <validation.h>
+
+/// The database holds the best block locator only
+constexpr size_t DB_CACHE_SIZE = 1 << 20;
+
+std::unique_ptr<PocketIndex> g_pocketindex;
+
+PocketIndex::PocketIndex(bool f_memory, bool f_wipe)
+    : m_db(MakeUnique<BaseIndex::DB>(GetDataDir() / "indexes" / "pocketindex", DB_CACHE_SIZE, f_memory, f_wipe))
+{}
+
+PocketIndex::~PocketIndex() {}
+
+bool PocketIndex::Init()
+{
+    CBlockLocator locator;
+    if (!m_db->ReadBestBlock(locator)) {
+        // Derived data used to be written while connecting blocks,
+        // so without a locator it is in sync with the chain state
+        LOCK(cs_main);
+        if (!m_db->WriteBestBlock(chainActive.GetLocator())) {
+            return error("%s: Failed to write locator to disk", __func__);
+        }
+    } else {
+        int height;
+        {
+            LOCK(cs_main);
+            const CBlockIndex* pindex = FindForkInGlobalIndex(chainActive, locator);
+            height = pindex ? pindex->nHeight : -1;
+        }
+
+        // Drop data of blocks written after the last saved locator, they
+        // may have been disconnected while the node was not running
+        if (!g_addrindex->RollbackDerived(height)) {
+            return error("%s: Failed to rollback derived data to height %d", __func__, height);
+        }
+    }
+
+    return BaseIndex::Init();
+}
+
+bool PocketIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    return g_addrindex->IndexBlockDerived(block, pindex);
+}
+
+bool PocketIndex::Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip)
+{
+    if (!g_addrindex->RollbackDerived(new_tip->nHeight)) {
+        return error("%s: Failed to rollback derived data to height %d", __func__, new_tip->nHeight);
+    }
+
+    return BaseIndex::Rewind(current_tip, new_tip);
+}
+
+BaseIndex::DB& PocketIndex::GetDB() const { return *m_db; }
@@ -0,0 +1,44 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef POCKETCOIN_INDEX_POCKETINDEX_H
+#define POCKETCOIN_INDEX_POCKETINDEX_H
+
+#include <chain.h>
+#include <index/base.h>
+
+/**
+ * PocketIndex maintains PocketDB data that no consensus rule reads: tag
+ * dictionary and comment tree. It follows the
+ * active chain from validation notifications, so connecting a block does not
+ * wait for it. Its own database keeps only the locator of the block the
+ * derived data is in sync with.
+ */
+class PocketIndex final : public BaseIndex
+{
+private:
+    const std::unique_ptr<BaseIndex::DB> m_db;
+
+protected:
+    /// Override base class init to adopt data written before this index existed.
+    bool Init() override;
+
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    bool Rewind(const CBlockIndex* current_tip, const CBlockIndex* new_tip) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+    const char* GetName() const override { return "pocketindex"; }
+
+public:
+    explicit PocketIndex(bool f_memory = false, bool f_wipe = false);
+
+    virtual ~PocketIndex() override;
+};
+
+/// The global index of derived PocketDB data. May be null.
+extern std::unique_ptr<PocketIndex> g_pocketindex;
+
+#endif // POCKETCOIN_INDEX_POCKETINDEX_H
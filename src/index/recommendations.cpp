@@ -0,0 +1,265 @@
+// Copyright (c) 2019 PocketNet developers
+// Background recommendations for subscriptions and posts
+//-----------------------------------------------------
+#include "index/recommendations.h"
+#include "pocketdb/pocketdb.h"
+
+#include <chain.h>
+#include <util.h>
+#include <utiltime.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <cmath>
+//-----------------------------------------------------
+std::unique_ptr<Recommendations> g_recommendations;
+//-----------------------------------------------------
+static bool CompareBySimilarity(const std::pair<std::string, double>& a, const std::pair<std::string, double>& b)
+{
+    if (a.second != b.second) return a.second > b.second;
+    return a.first < b.first;
+}
+
+// Append item to list of user if it is new and the list is not full
+static void AddUserItem(std::vector<std::string>& items, const std::string& item, size_t limit)
+{
+    if (items.size() >= limit) return;
+    if (std::find(items.begin(), items.end(), item) != items.end()) return;
+    items.push_back(item);
+}
+//-----------------------------------------------------
+Recommendations::Recommendations(int intervalIn) : interval(std::max(intervalIn, 1)) {}
+
+Recommendations::~Recommendations()
+{
+    Interrupt();
+    Stop();
+}
+
+void Recommendations::BuildSimilarity(const std::map<std::string, std::vector<std::string>>& userItems, size_t maxNeighbours, similarity_t& result)
+{
+    // Work on numeric ids, strings are only needed for the result
+    std::unordered_map<std::string, int> ids;
+    std::vector<std::string> names;
+    std::vector<int> frequency;
+    std::vector<std::unordered_map<int, int>> cooccurrence;
+
+    for (const auto& user : userItems) {
+        std::vector<int> items;
+        for (const auto& item : user.second) {
+            auto it = ids.find(item);
+            if (it == ids.end()) {
+                it = ids.emplace(item, (int)names.size()).first;
+                names.push_back(item);
+                frequency.push_back(0);
+                cooccurrence.emplace_back();
+            }
+            items.push_back(it->second);
+        }
+
+        for (size_t i = 0; i < items.size(); i++) {
+            frequency[items[i]] += 1;
+            for (size_t j = i + 1; j < items.size(); j++) {
+                cooccurrence[items[i]][items[j]] += 1;
+                cooccurrence[items[j]][items[i]] += 1;
+            }
+        }
+    }
+
+    result.clear();
+    for (size_t i = 0; i < names.size(); i++) {
+        if (cooccurrence[i].empty()) continue;
+
+        std::vector<std::pair<std::string, double>> neighbours;
+        for (const auto& n : cooccurrence[i]) {
+            double similarity = n.second / std::sqrt((double)frequency[i] * frequency[n.first]);
+            neighbours.emplace_back(names[n.first], similarity);
+        }
+
+        size_t limit = std::min(neighbours.size(), maxNeighbours);
+        std::partial_sort(neighbours.begin(), neighbours.begin() + limit, neighbours.end(), CompareBySimilarity);
+        neighbours.resize(limit);
+        result.emplace(names[i], std::move(neighbours));
+    }
+}
+
+void Recommendations::Recommend(const std::vector<std::string>& own, const similarity_t& similarity, int count, std::vector<std::string>& result)
+{
+    std::set<std::string> exclude(own.begin(), own.end());
+    std::map<std::string, double> scores;
+    for (const auto& item : own) {
+        auto it = similarity.find(item);
+        if (it == similarity.end()) continue;
+
+        for (const auto& n : it->second) {
+            if (exclude.count(n.first)) continue;
+            scores[n.first] += n.second;
+        }
+    }
+
+    std::vector<std::pair<std::string, double>> ranked(scores.begin(), scores.end());
+    size_t limit = std::min(ranked.size(), (size_t)std::max(count, 0));
+    std::partial_sort(ranked.begin(), ranked.begin() + limit, ranked.end(), CompareBySimilarity);
+
+    for (size_t i = 0; i < limit; i++)
+        result.push_back(ranked[i].first);
+}
+
+bool Recommendations::Build(int height)
+{
+    int64_t nStart = GetTimeMillis();
+    auto result = std::make_shared<RecommendationsSnapshot>();
+    result->height = height;
+
+    // Public subscriptions, the most recent first
+    std::map<std::string, std::vector<std::string>> userAuthors;
+    {
+        reindexer::QueryResults res;
+        if (!g_pocketdb->DB()->Select(reindexer::Query("SubscribesView").Where("private", CondEq, false).Sort("block", true), res).ok()) return false;
+        for (auto& it : res) {
+            if (interrupt) return false;
+            reindexer::Item itm(it.GetItem());
+            std::string address = itm["address"].As<string>();
+            std::string address_to = itm["address_to"].As<string>();
+
+            auto& all = result->subscriptions[address];
+            if (std::find(all.begin(), all.end(), address_to) == all.end()) all.push_back(address_to);
+            AddUserItem(userAuthors[address], address_to, MAX_USER_ITEMS);
+        }
+    }
+
+    // Positive scores, the most recent first
+    std::map<std::string, std::vector<std::string>> userPosts;
+    {
+        reindexer::QueryResults res;
+        if (!g_pocketdb->DB()->Select(reindexer::Query("Scores").Where("value", CondSet, {4, 5}).Sort("time", true), res).ok()) return false;
+        for (auto& it : res) {
+            if (interrupt) return false;
+            reindexer::Item itm(it.GetItem());
+            AddUserItem(userPosts[itm["address"].As<string>()], itm["posttxid"].As<string>(), MAX_USER_ITEMS);
+        }
+    }
+
+    // Last post of every author someone subscribed to
+    {
+        std::set<std::string> authors;
+        for (const auto& user : result->subscriptions)
+            authors.insert(user.second.begin(), user.second.end());
+
+        reindexer::QueryResults res;
+        if (!g_pocketdb->DB()->Select(reindexer::Query("Posts").Sort("time", true), res).ok()) return false;
+        for (auto& it : res) {
+            if (interrupt) return false;
+            reindexer::Item itm(it.GetItem());
+            std::string address = itm["address"].As<string>();
+            if (authors.count(address)) result->lastPosts.emplace(address, itm["txid"].As<string>());
+        }
+    }
+
+    BuildSimilarity(userAuthors, MAX_NEIGHBOURS, result->authors);
+    if (interrupt) return false;
+    BuildSimilarity(userPosts, MAX_NEIGHBOURS, result->posts);
+    result->likes.insert(userPosts.begin(), userPosts.end());
+
+    {
+        LOCK(cs);
+        snapshot = result;
+    }
+
+    LogPrintf("Recommendations: snapshot at height %d built in %dms (%d authors, %d posts)\n",
+        height, GetTimeMillis() - nStart, result->authors.size(), result->posts.size());
+    return true;
+}
+
+void Recommendations::ThreadBuild()
+{
+    while (!interrupt) {
+        int height = requestedHeight.load();
+        if (height > builtHeight.load()) {
+            if (Build(height)) {
+                builtHeight = height;
+            } else if (!interrupt) {
+                LogPrintf("Recommendations: failed to build snapshot at height %d\n", height);
+                // Do not retry before next interval
+                builtHeight = height;
+            }
+        }
+
+        interrupt.sleep_for(std::chrono::seconds(1));
+    }
+}
+
+void Recommendations::BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex, const std::vector<CTransactionRef>& txnConflicted)
+{
+    if (IsInitialBlockDownload()) return;
+    if (pindex->nHeight - builtHeight.load() >= interval) requestedHeight = pindex->nHeight;
+}
+
+std::shared_ptr<const RecommendationsSnapshot> Recommendations::GetSnapshot() const
+{
+    LOCK(cs);
+    return snapshot;
+}
+
+bool Recommendations::GetSubscriptions(const std::string& address, int count, std::vector<std::string>& result) const
+{
+    auto snap = GetSnapshot();
+    if (!snap) return false;
+
+    auto own = snap->subscriptions.find(address);
+    if (own != snap->subscriptions.end()) Recommend(own->second, snap->authors, count, result);
+    return true;
+}
+
+bool Recommendations::GetPostsByScores(const std::string& address, int count, std::set<std::string>& result) const
+{
+    auto snap = GetSnapshot();
+    if (!snap) return false;
+
+    auto own = snap->likes.find(address);
+    if (own == snap->likes.end()) return true;
+
+    std::vector<std::string> posts;
+    Recommend(own->second, snap->posts, count, posts);
+    result.insert(posts.begin(), posts.end());
+    return true;
+}
+
+bool Recommendations::GetPostsBySubscriptions(const std::string& address, int count, std::set<std::string>& result) const
+{
+    auto snap = GetSnapshot();
+    if (!snap) return false;
+
+    auto own = snap->subscriptions.find(address);
+    if (own == snap->subscriptions.end()) return true;
+
+    std::vector<std::string> authors;
+    Recommend(own->second, snap->authors, count, authors);
+    for (const auto& author : authors) {
+        auto post = snap->lastPosts.find(author);
+        if (post != snap->lastPosts.end()) result.insert(post->second);
+    }
+    return true;
+}
+
+void Recommendations::Start(int height)
+{
+    requestedHeight = height;
+    RegisterValidationInterface(this);
+    threadBuild = std::thread(&TraceThread<std::function<void()>>, "recommendations",
+        std::bind(&Recommendations::ThreadBuild, this));
+}
+
+void Recommendations::Interrupt()
+{
+    interrupt();
+}
+
+void Recommendations::Stop()
+{
+    UnregisterValidationInterface(this);
+
+    if (threadBuild.joinable()) {
+        threadBuild.join();
+    }
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2019 PocketNet developers
+// Background recommendations for subscriptions and posts
+//-----------------------------------------------------
+#ifndef RECOMMENDATIONS_H
+#define RECOMMENDATIONS_H
+//-----------------------------------------------------
+#include <sync.h>
+#include <threadinterrupt.h>
+#include <validationinterface.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+//-----------------------------------------------------
+static const int DEFAULT_RECOMMENDATIONS_INTERVAL = 60;
+//-----------------------------------------------------
+/*
+    Item-item similarity matrix: for every item list of most similar items
+    with cosine similarity of their co-occurrence, sorted descending.
+*/
+typedef std::unordered_map<std::string, std::vector<std::pair<std::string, double>>> similarity_t;
+
+/*
+    Immutable result of one rebuild. Readers take shared pointer and never
+    see partially built data.
+*/
+struct RecommendationsSnapshot
+{
+    int height = 0;
+    // address -> public subscriptions
+    std::unordered_map<std::string, std::vector<std::string>> subscriptions;
+    // address -> last liked posts
+    std::unordered_map<std::string, std::vector<std::string>> likes;
+    // author -> last post txid
+    std::unordered_map<std::string, std::string> lastPosts;
+    // co-subscription matrix over authors
+    similarity_t authors;
+    // co-score matrix over posts
+    similarity_t posts;
+};
+//-----------------------------------------------------
+/*
+    Offline collaborative filtering over SubscribesView and Scores.
+    Every `interval` blocks the worker thread rebuilds similarity matrices
+    from PocketDB and publishes new snapshot. Requests are answered from
+    the last published snapshot without touching the database.
+*/
+class Recommendations final : public CValidationInterface
+{
+private:
+    // Limit of items taken from one user, pairs grow quadratically
+    static const size_t MAX_USER_ITEMS = 50;
+    // Count of neighbours kept for every item
+    static const size_t MAX_NEIGHBOURS = 50;
+
+    mutable CCriticalSection cs;
+    std::shared_ptr<const RecommendationsSnapshot> snapshot;
+
+    int interval;
+    std::atomic<int> requestedHeight{-1};
+    std::atomic<int> builtHeight{-1};
+    std::thread threadBuild;
+    CThreadInterrupt interrupt;
+
+    void ThreadBuild();
+    bool Build(int height);
+    std::shared_ptr<const RecommendationsSnapshot> GetSnapshot() const;
+
+protected:
+    void BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex, const std::vector<CTransactionRef>& txnConflicted) override;
+
+public:
+    explicit Recommendations(int intervalIn = DEFAULT_RECOMMENDATIONS_INTERVAL);
+    ~Recommendations();
+
+    /* Fill matrix from lists of items of every user */
+    static void BuildSimilarity(const std::map<std::string, std::vector<std::string>>& userItems, size_t maxNeighbours, similarity_t& result);
+    /* Items most similar to `own` excluding `own` itself */
+    static void Recommend(const std::vector<std::string>& own, const similarity_t& similarity, int count, std::vector<std::string>& result);
+
+    /* Return false if there is no snapshot yet */
+    bool GetSubscriptions(const std::string& address, int count, std::vector<std::string>& result) const;
+    bool GetPostsByScores(const std::string& address, int count, std::set<std::string>& result) const;
+    bool GetPostsBySubscriptions(const std::string& address, int count, std::set<std::string>& result) const;
+
+    void Start(int height);
+    void Interrupt();
+    void Stop();
+};
+//-----------------------------------------------------
+extern std::unique_ptr<Recommendations> g_recommendations;
+//-----------------------------------------------------
+#endif // RECOMMENDATIONS_H
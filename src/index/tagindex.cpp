@@ -0,0 +1,230 @@
+// Copyright (c) 2019 PocketNet developers
+// In-memory dictionary of post tags
+//-----------------------------------------------------
+#include "index/tagindex.h"
+#include "utilstrencodings.h"
+
+#include <algorithm>
+//-----------------------------------------------------
+std::unique_ptr<TagIndex> g_tagindex;
+//-----------------------------------------------------
+static bool CompareByCount(const std::pair<std::string, int>& a, const std::pair<std::string, int>& b)
+{
+    if (a.second != b.second) return a.second > b.second;
+    return a.first < b.first;
+}
+
+static void TakeTop(std::vector<std::pair<std::string, int>>& items, int count)
+{
+    size_t n = std::min(items.size(), (size_t)std::max(count, 0));
+    std::partial_sort(items.begin(), items.begin() + n, items.end(), CompareByCount);
+    items.resize(n);
+}
+//-----------------------------------------------------
+TagIndex::TagIndex(int windowIn) : window(std::max(windowIn, 1)), tip(0) {}
+
+std::string TagIndex::Normalize(const std::string& tag)
+{
+    size_t begin = tag.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = tag.find_last_not_of(" \t\r\n");
+
+    std::string result = tag.substr(begin, end - begin + 1);
+    Downcase(result);
+    return result;
+}
+
+void TagIndex::change(const std::string& lang, const std::string& tag, int dTotal, int dRecent)
+{
+    AssertLockHeld(cs);
+
+    // Every post counted in common bucket and in bucket of its language
+    std::vector<std::string> names{""};
+    if (!lang.empty()) names.push_back(lang);
+
+    for (const auto& name : names) {
+        Bucket& bucket = buckets[name];
+        auto& counters = bucket.tags[tag];
+
+        if (counters.first > 0) bucket.byTotal.erase({counters.first, tag});
+        if (counters.second > 0) bucket.byRecent.erase({counters.second, tag});
+
+        counters.first += dTotal;
+        counters.second += dRecent;
+
+        if (counters.first > 0) bucket.byTotal.emplace(counters.first, tag);
+        if (counters.second > 0) bucket.byRecent.emplace(counters.second, tag);
+
+        if (counters.first <= 0 && counters.second <= 0) bucket.tags.erase(tag);
+        if (bucket.tags.empty()) buckets.erase(name);
+    }
+}
+
+void TagIndex::apply(const PostTags& post, int sign)
+{
+    AssertLockHeld(cs);
+    bool recent = post.block >= windowStart();
+    for (const auto& tag : post.tags)
+        change(post.lang, tag, sign, recent ? sign : 0);
+}
+
+void TagIndex::shiftWindow(int newTip)
+{
+    AssertLockHeld(cs);
+
+    int oldStart = windowStart();
+    int newStart = newTip - window + 1;
+    int sign = (newStart > oldStart ? -1 : 1);
+
+    // Blocks between old and new start of window leave it or come back
+    auto first = blocks.lower_bound(std::min(oldStart, newStart));
+    auto last = blocks.lower_bound(std::max(oldStart, newStart));
+    for (auto it = first; it != last; ++it) {
+        for (const auto& txid : it->second) {
+            const PostTags& post = posts[txid];
+            for (const auto& tag : post.tags)
+                change(post.lang, tag, 0, sign);
+        }
+    }
+
+    tip = newTip;
+}
+
+void TagIndex::AddPost(const std::string& txid, int block, const std::string& lang, const std::vector<std::string>& tags)
+{
+    PostTags post;
+    post.block = block;
+    post.lang = lang;
+    for (const auto& tag : tags) {
+        std::string _tag = Normalize(tag);
+        if (_tag.empty() || std::find(post.tags.begin(), post.tags.end(), _tag) != post.tags.end()) continue;
+        post.tags.push_back(_tag);
+    }
+
+    LOCK(cs);
+    auto it = posts.find(txid);
+    if (it != posts.end()) {
+        apply(it->second, -1);
+        blocks[it->second.block].erase(txid);
+        if (blocks[it->second.block].empty()) blocks.erase(it->second.block);
+    }
+
+    apply(post, 1);
+    blocks[block].insert(txid);
+    posts[txid] = std::move(post);
+}
+
+void TagIndex::RemovePost(const std::string& txid)
+{
+    LOCK(cs);
+    auto it = posts.find(txid);
+    if (it == posts.end()) return;
+
+    apply(it->second, -1);
+    blocks[it->second.block].erase(txid);
+    if (blocks[it->second.block].empty()) blocks.erase(it->second.block);
+    posts.erase(it);
+}
+
+void TagIndex::SetTip(int height)
+{
+    LOCK(cs);
+    if (height != tip) shiftWindow(height);
+}
+
+std::vector<std::string> TagIndex::GetPostsAbove(int height) const
+{
+    LOCK(cs);
+    std::vector<std::string> result;
+    for (auto it = blocks.upper_bound(height); it != blocks.end(); ++it)
+        result.insert(result.end(), it->second.begin(), it->second.end());
+    return result;
+}
+
+void TagIndex::Clear()
+{
+    LOCK(cs);
+    buckets.clear();
+    posts.clear();
+    blocks.clear();
+    tip = 0;
+}
+
+void TagIndex::findByPrefix(const Bucket& bucket, const std::string& prefix, int count, std::vector<std::pair<std::string, int>>& result) const
+{
+    for (auto it = bucket.tags.lower_bound(prefix); it != bucket.tags.end(); ++it) {
+        if (it->first.compare(0, prefix.size(), prefix) != 0) break;
+        if (it->second.first > 0) result.emplace_back(it->first, it->second.first);
+    }
+
+    TakeTop(result, count);
+}
+
+void TagIndex::top(const Ranking& ordered, int count, const Filter& filter, std::vector<std::pair<std::string, int>>& result) const
+{
+    for (auto it = ordered.begin(); it != ordered.end() && (int)result.size() < count; ++it) {
+        if (filter && !filter(it->second)) continue;
+        result.emplace_back(it->second, it->first);
+    }
+}
+
+void TagIndex::Search(const std::string& prefix, const std::string& lang, int count, std::vector<std::pair<std::string, int>>& result) const
+{
+    LOCK(cs);
+    auto bucket = buckets.find(lang);
+    if (bucket == buckets.end()) return;
+
+    std::string _prefix = Normalize(prefix);
+    if (_prefix.empty())
+        top(bucket->second.byTotal, count, nullptr, result);
+    else
+        findByPrefix(bucket->second, _prefix, count, result);
+}
+
+void TagIndex::GetTop(const std::string& lang, int count, bool recent, std::vector<std::pair<std::string, int>>& result, const Filter& filter) const
+{
+    LOCK(cs);
+    auto bucket = buckets.find(lang);
+    if (bucket == buckets.end()) return;
+
+    top(recent ? bucket->second.byRecent : bucket->second.byTotal, count, filter, result);
+}
+
+void TagIndex::GetTopFrom(const std::string& lang, int count, int from, std::vector<std::pair<std::string, int>>& result, const Filter& filter) const
+{
+    if (from <= 0) return GetTop(lang, count, false, result, filter);
+
+    LOCK(cs);
+    if (from == windowStart()) {
+        auto bucket = buckets.find(lang);
+        if (bucket != buckets.end()) top(bucket->second.byRecent, count, filter, result);
+        return;
+    }
+
+    std::map<std::string, int> counts;
+    for (auto it = blocks.lower_bound(from); it != blocks.end(); ++it) {
+        for (const auto& txid : it->second) {
+            const PostTags& post = posts.at(txid);
+            if (!lang.empty() && post.lang != lang) continue;
+            for (const auto& tag : post.tags) {
+                if (!filter || filter(tag)) counts[tag] += 1;
+            }
+        }
+    }
+
+    result.assign(counts.begin(), counts.end());
+    TakeTop(result, count);
+}
+
+int TagIndex::GetTip() const
+{
+    LOCK(cs);
+    return tip;
+}
+
+size_t TagIndex::Size() const
+{
+    LOCK(cs);
+    auto bucket = buckets.find("");
+    return bucket == buckets.end() ? 0 : bucket->second.tags.size();
+}
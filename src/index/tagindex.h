@@ -0,0 +1,109 @@
+// Copyright (c) 2019 PocketNet developers
+// In-memory dictionary of post tags
+//-----------------------------------------------------
+#ifndef TAGINDEX_H
+#define TAGINDEX_H
+//-----------------------------------------------------
+#include <sync.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+//-----------------------------------------------------
+static const int DEFAULT_TAG_WINDOW = 10080;
+//-----------------------------------------------------
+/*
+    Dictionary of tags used by posts with popularity counters.
+    Tags are kept in a sorted map, so prefix autocompletion is a range scan
+    starting at lower_bound(prefix). Every language has its own bucket and
+    the bucket with empty name accumulates all languages.
+    Each bucket counts posts for all time and for the last `window` blocks;
+    both orderings are maintained incrementally so top-N is a walk over a set.
+    Post is identified by its original txid: edits replace the tags of the
+    previous version, rollback re-reads the restored version from PocketDB.
+*/
+class TagIndex
+{
+public:
+    /* Tags rejected by filter are skipped in top-N */
+    typedef std::function<bool(const std::string&)> Filter;
+
+private:
+    // <count, tag> ordered by count descending, ties by tag
+    struct ByCount
+    {
+        bool operator()(const std::pair<int, std::string>& a, const std::pair<int, std::string>& b) const
+        {
+            if (a.first != b.first) return a.first > b.first;
+            return a.second < b.second;
+        }
+    };
+    typedef std::set<std::pair<int, std::string>, ByCount> Ranking;
+
+    struct Bucket
+    {
+        // tag -> <total, recent>
+        std::map<std::string, std::pair<int, int>> tags;
+        // <count, tag> for top-N
+        Ranking byTotal;
+        Ranking byRecent;
+    };
+
+    struct PostTags
+    {
+        int block;
+        std::string lang;
+        std::vector<std::string> tags;
+    };
+
+    mutable CCriticalSection cs;
+    std::map<std::string, Bucket> buckets;
+    // txid -> current version of post
+    std::map<std::string, PostTags> posts;
+    // block -> txids of posts
+    std::map<int, std::set<std::string>> blocks;
+    int window;
+    int tip;
+
+    // First block inside recency window
+    int windowStart() const { return tip - window + 1; }
+    void change(const std::string& lang, const std::string& tag, int dTotal, int dRecent);
+    void apply(const PostTags& post, int sign);
+    void shiftWindow(int newTip);
+
+    void findByPrefix(const Bucket& bucket, const std::string& prefix, int count, std::vector<std::pair<std::string, int>>& result) const;
+    void top(const Ranking& ordered, int count, const Filter& filter, std::vector<std::pair<std::string, int>>& result) const;
+
+public:
+    explicit TagIndex(int windowIn = DEFAULT_TAG_WINDOW);
+
+    /* Normalize tag to dictionary form: trimmed and lowercase */
+    static std::string Normalize(const std::string& tag);
+
+    /* Add new post or replace tags of exists post */
+    void AddPost(const std::string& txid, int block, const std::string& lang, const std::vector<std::string>& tags);
+    void RemovePost(const std::string& txid);
+    /* Move chain tip - tags of old blocks leave recency window */
+    void SetTip(int height);
+    /* Txids of posts indexed above height, used on rollback */
+    std::vector<std::string> GetPostsAbove(int height) const;
+    void Clear();
+
+    /* Tags starting with prefix ordered by all time popularity. Empty lang - all languages */
+    void Search(const std::string& prefix, const std::string& lang, int count, std::vector<std::pair<std::string, int>>& result) const;
+    /* Most popular tags for all time or inside recency window */
+    void GetTop(const std::string& lang, int count, bool recent, std::vector<std::pair<std::string, int>>& result, const Filter& filter = nullptr) const;
+    /* Most popular tags in posts from block `from` to tip */
+    void GetTopFrom(const std::string& lang, int count, int from, std::vector<std::pair<std::string, int>>& result, const Filter& filter = nullptr) const;
+
+    int GetWindow() const { return window; }
+    int GetTip() const;
+    size_t Size() const;
+};
+//-----------------------------------------------------
+extern std::unique_ptr<TagIndex> g_tagindex;
+//-----------------------------------------------------
+#endif // TAGINDEX_H
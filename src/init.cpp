@@ -19,6 +19,7 @@
 #include <fs.h>
 #include <httprpc.h>
 #include <httpserver.h>
+#include <index/pocketindex.h>
 #include <index/txindex.h>
 #include <key.h>
 #include <miner.h>
@@ -29,8 +30,10 @@
 #include <policy/fees.h>
 #include <policy/policy.h>
 #include <rpc/blockchain.h>
+#include <rpc/cache.h>
 #include <rpc/register.h>
 #include <rpc/server.h>
+#include <rpc/stats.h>
 #include <scheduler.h>
 #include <script/sigcache.h>
 #include <script/standard.h>
@@ -163,6 +166,12 @@ void Interrupt()
     if (g_txindex) {
         g_txindex->Interrupt();
     }
+    if (g_pocketindex) {
+        g_pocketindex->Interrupt();
+    }
+    if (g_recommendations) {
+        g_recommendations->Interrupt();
+    }
 }
 
 void Shutdown()
@@ -190,8 +199,12 @@ void Shutdown()
     // Because these depend on each-other, we make sure that neither can be
     // using the other before destroying them.
     if (peerLogic) UnregisterValidationInterface(peerLogic.get());
+    if (g_search_cache) UnregisterValidationInterface(g_search_cache.get());
+    if (g_tip_cache) UnregisterValidationInterface(g_tip_cache.get());
     if (g_connman) g_connman->Stop();
     if (g_txindex) g_txindex->Stop();
+    if (g_pocketindex) g_pocketindex->Stop();
+    if (g_recommendations) g_recommendations->Stop();
 
     StopTorControl();
 
@@ -205,6 +218,10 @@ void Shutdown()
     peerLogic.reset();
     g_connman.reset();
     g_txindex.reset();
+    g_pocketindex.reset();
+    g_search_cache.reset();
+    g_tip_cache.reset();
+    g_recommendations.reset();
 
     if (g_is_mempool_loaded && gArgs.GetArg("-persistmempool", DEFAULT_PERSIST_MEMPOOL)) {
         DumpMempool();
@@ -368,6 +385,12 @@ void SetupServerArgs()
 #else
     hidden_args.emplace_back("-pid");
 #endif
+    gArgs.AddArg("-pocketdbcache=<n>", strprintf("Set size of block cache shared by mostly-read PocketDB namespaces in megabytes (default: %d)", DEFAULT_POCKETDB_CACHE), false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-recommendationsinterval=<n>", strprintf("Rebuild recommendations every <n> blocks, 0 to compute them on request (default: %d)", DEFAULT_RECOMMENDATIONS_INTERVAL), false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-tagwindow=<n>", strprintf("Count tags of posts from last <n> blocks as recent (default: %d)", DEFAULT_TAG_WINDOW), false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-pocketdbidsetcache=<n>", strprintf("Set size limit of merged idsets cache of every index of Posts, Comment and CommentScores PocketDB namespaces in megabytes (default: %d)", DEFAULT_POCKETDB_IDSET_CACHE), false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-pocketdbjoincache=<n>", strprintf("Set size limit of join cache of each of Posts, Comment and CommentScores PocketDB namespaces in megabytes (default: %d)", DEFAULT_POCKETDB_JOIN_CACHE), false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-pocketdbsync", strprintf("Sync every PocketDB storage write to disk (default: %u)", DEFAULT_POCKETDB_SYNC), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-prune=<n>", strprintf("Reduce storage requirements by enabling pruning (deleting) of old blocks. This allows the pruneblockchain RPC to be called to delete specific blocks, and enables automatic pruning of old blocks if a target size in MiB is provided. This mode is incompatible with -txindex and -rescan. "
                                          "Warning: Reverting this setting requires re-downloading the entire blockchain. "
                                          "(default: 0 = disable pruning blocks, 1 = allow manual pruning via RPC, >=%u = automatically prune block files to stay under the specified target size in MiB)",
@@ -411,6 +434,7 @@ void SetupServerArgs()
     gArgs.AddArg("-timeout=<n>", strprintf("Specify connection timeout in milliseconds (minimum: 1, default: %d)", DEFAULT_CONNECT_TIMEOUT), false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-torcontrol=<ip>:<port>", strprintf("Tor control port to use if onion listening enabled (default: %s)", DEFAULT_TOR_CONTROL), false, OptionsCategory::CONNECTION);
     gArgs.AddArg("-torpassword=<pass>", "Tor control port password (default: empty)", false, OptionsCategory::CONNECTION);
+    gArgs.AddArg("-txprecheckthreads=<n>", strprintf("Set the number of threads decoding PocketNet data of relayed transactions before validation (0 to %d, 0 = in message handler thread, default: %d)", MAX_TX_PRECHECK_THREADS, DEFAULT_TX_PRECHECK_THREADS), false, OptionsCategory::CONNECTION);
 #ifdef USE_UPNP
 #if USE_UPNP
     gArgs.AddArg("-upnp", "Use UPnP to map the listening port (default: 1 when listening and no -proxy)", false, OptionsCategory::CONNECTION);
@@ -508,9 +532,19 @@ void SetupServerArgs()
     gArgs.AddArg("-rpcport=<port>", strprintf("Listen for JSON-RPC connections on <port> (default: %u, testnet: %u, regtest: %u)", defaultBaseParams->RPCPort(), testnetBaseParams->RPCPort(), regtestBaseParams->RPCPort()), false, OptionsCategory::RPC);
     gArgs.AddArg("-rpcserialversion", strprintf("Sets the serialization of raw transaction or block hex returned in non-verbose mode, non-segwit(0) or segwit(1) (default: %d)", DEFAULT_RPC_SERIALIZE_VERSION), false, OptionsCategory::RPC);
     gArgs.AddArg("-rpcservertimeout=<n>", strprintf("Timeout during HTTP requests (default: %d)", DEFAULT_HTTP_SERVER_TIMEOUT), true, OptionsCategory::RPC);
+    gArgs.AddArg("-rpccompressminsize=<n>", strprintf("Compress HTTP replies of at least <n> bytes with gzip or deflate if the client accepts it, 0 to disable (default: %d)", DEFAULT_HTTP_COMPRESS_MIN_SIZE), false, OptionsCategory::RPC);
+    gArgs.AddArg("-rpctipcache=<n>", strprintf("Set size of cache for RPC results that only change with the chain tip in megabytes, 0 to disable (default: %d)", DEFAULT_TIP_CACHE_SIZE), false, OptionsCategory::RPC);
+    gArgs.AddArg("-rpcsearchcache=<n>", strprintf("Set size of search RPC results cache in megabytes, 0 to disable (default: %d)", DEFAULT_SEARCH_CACHE_SIZE), false, OptionsCategory::RPC);
+    gArgs.AddArg("-rpcbatchthreads=<n>", strprintf("Set the number of threads executing read-only calls of JSON-RPC batches in parallel, 0 to execute them sequentially (default: %d)", DEFAULT_RPC_BATCH_THREADS), false, OptionsCategory::RPC);
+    gArgs.AddArg("-rpcslowcalltime=<ms>", strprintf("Log RPC calls slower than <ms> milliseconds with their database queries, 0 to disable (default: %d)", DEFAULT_RPC_SLOW_CALL_TIME), false, OptionsCategory::RPC);
+    gArgs.AddArg("-rpcmetrics", strprintf("Serve RPC call counters in Prometheus format at /metrics to authorized RPC users (default: %u)", DEFAULT_RPC_METRICS), false, OptionsCategory::RPC);
     gArgs.AddArg("-rpcthreads=<n>", strprintf("Set the number of threads to service RPC calls (default: %d)", DEFAULT_HTTP_THREADS), false, OptionsCategory::RPC);
     gArgs.AddArg("-rpcuser=<user>", "Username for JSON-RPC connections", false, OptionsCategory::RPC);
     gArgs.AddArg("-rpcworkqueue=<n>", strprintf("Set the depth of the work queue to service RPC calls (default: %d)", DEFAULT_HTTP_WORKQUEUE), true, OptionsCategory::RPC);
+    gArgs.AddArg("-rpcpublicthreads=<n>", strprintf("Set the number of threads to service read-only public RPC calls and REST (default: %d)", DEFAULT_HTTP_PUBLIC_THREADS), false, OptionsCategory::RPC);
+    gArgs.AddArg("-rpcpublicworkqueue=<n>", strprintf("Set the depth of the work queue to service read-only public RPC calls and REST (default: %d)", DEFAULT_HTTP_PUBLIC_WORKQUEUE), false, OptionsCategory::RPC);
+    gArgs.AddArg("-rpcminingthreads=<n>", strprintf("Set the number of threads to service mining RPC calls (default: %d)", DEFAULT_HTTP_MINING_THREADS), false, OptionsCategory::RPC);
+    gArgs.AddArg("-rpcminingworkqueue=<n>", strprintf("Set the depth of the work queue to service mining RPC calls (default: %d)", DEFAULT_HTTP_MINING_WORKQUEUE), false, OptionsCategory::RPC);
     gArgs.AddArg("-server", "Accept command line and JSON-RPC commands", false, OptionsCategory::RPC);
 
 	gArgs.AddArg("-wsuse", "Accept WebSocket connections", false, OptionsCategory::RPC);
@@ -648,6 +682,7 @@ static void ThreadImport(std::vector<fs::path> vImportFiles)
                 g_pocketdb->DropTable("UserRatings");
                 g_pocketdb->DropTable("PostRatings");
                 g_pocketdb->DropTable("CommentRatings");
+                g_pocketdb->DropTable("Lottery");
                 LogPrintf("Rating tables cleared\n");
             }
 
@@ -966,13 +1001,16 @@ bool AppInitParameterInteraction()
     }
 
     // Make sure enough file descriptors are available
-    int nBind = std::max(nUserBind, size_t(1));
     nUserMaxConnections = gArgs.GetArg("-maxconnections", DEFAULT_MAX_PEER_CONNECTIONS);
     nMaxConnections = std::max(nUserMaxConnections, 0);
 
     // Trim requested connection counts, to fit into system limitations
     // <int> in std::min<int>(...) to work around FreeBSD compilation issue described in #2695
+#ifndef USE_EPOLL
+    // select() handles sockets below FD_SETSIZE only
+    int nBind = std::max(nUserBind, size_t(1));
     nMaxConnections = std::max(std::min<int>(nMaxConnections, FD_SETSIZE - nBind - MIN_CORE_FILEDESCRIPTORS - MAX_ADDNODE_CONNECTIONS), 0);
+#endif
     nFD = RaiseFileDescriptorLimit(nMaxConnections + MIN_CORE_FILEDESCRIPTORS + MAX_ADDNODE_CONNECTIONS);
     if (nFD < MIN_CORE_FILEDESCRIPTORS)
         return InitError(_("Not enough file descriptors available."));
@@ -1036,6 +1074,13 @@ bool AppInitParameterInteraction()
     int64_t nMempoolSizeMin = gArgs.GetArg("-limitdescendantsize", DEFAULT_DESCENDANT_SIZE_LIMIT) * 1000 * 40;
     if (nMempoolSizeMax < 0 || nMempoolSizeMax < nMempoolSizeMin)
         return InitError(strprintf(_("-maxmempool must be at least %d MB"), std::ceil(nMempoolSizeMin / 1000000.0)));
+    if (gArgs.GetArg("-pocketdbcache", DEFAULT_POCKETDB_CACHE) < 0)
+        return InitError(_("-pocketdbcache must not be negative"));
+    if (gArgs.GetArg("-pocketdbidsetcache", DEFAULT_POCKETDB_IDSET_CACHE) < 0)
+        return InitError(_("-pocketdbidsetcache must not be negative"));
+    if (gArgs.GetArg("-pocketdbjoincache", DEFAULT_POCKETDB_JOIN_CACHE) < 0)
+        return InitError(_("-pocketdbjoincache must not be negative"));
+
     // incremental relay fee sets the minimum feerate increase necessary for BIP 125 replacement in the mempool
     // and the amount the mempool min fee increases above the feerate of txs evicted due to mempool limiting.
     if (gArgs.IsArgSet("-incrementalrelayfee")) {
@@ -1371,8 +1416,29 @@ bool AppInitMain()
     }
 	// ********************************************************* Step 4.2: Start AddrIndex
 	g_addrindex = std::unique_ptr<AddrIndex>(new AddrIndex());
+    g_tagindex = std::unique_ptr<TagIndex>(new TagIndex(gArgs.GetArg("-tagwindow", DEFAULT_TAG_WINDOW)));
+    g_commenttree = MakeUnique<CommentTree>();
+    if (!g_addrindex->RebuildCommentTree()) {
+        return InitError(_("Unable to load comments from reindexer database."));
+    }
+    int nRecommendationsInterval = gArgs.GetArg("-recommendationsinterval", DEFAULT_RECOMMENDATIONS_INTERVAL);
+    if (nRecommendationsInterval > 0) {
+        g_recommendations = MakeUnique<Recommendations>(nRecommendationsInterval);
+        g_recommendations->Start(0);
+    }
 	// ********************************************************* Step 4.3: Start AntiBot
 	g_antibot = std::unique_ptr<AntiBot>(new AntiBot());
+	// ********************************************************* Step 4.4: Start RPC results cache
+    int64_t nSearchCacheSize = gArgs.GetArg("-rpcsearchcache", DEFAULT_SEARCH_CACHE_SIZE);
+    if (nSearchCacheSize > 0) {
+        g_search_cache = MakeUnique<CRPCResultCache>(nSearchCacheSize << 20);
+        RegisterValidationInterface(g_search_cache.get());
+    }
+    int64_t nTipCacheSize = gArgs.GetArg("-rpctipcache", DEFAULT_TIP_CACHE_SIZE);
+    if (nTipCacheSize > 0) {
+        g_tip_cache = MakeUnique<CRPCResultCache>(nTipCacheSize << 20);
+        RegisterValidationInterface(g_tip_cache.get());
+    }
     // ********************************************************* Step 5: verify wallet database integrity
     if (!g_wallet_init_interface.Verify()) return false;
 
@@ -1386,7 +1452,7 @@ bool AppInitMain()
     g_connman = std::unique_ptr<CConnman>(new CConnman(GetRand(std::numeric_limits<uint64_t>::max()), GetRand(std::numeric_limits<uint64_t>::max())));
     CConnman& connman = *g_connman;
 
-    peerLogic.reset(new PeerLogicValidation(&connman, scheduler, gArgs.GetBoolArg("-enablebip61", DEFAULT_ENABLE_BIP61)));
+    peerLogic.reset(new PeerLogicValidation(&connman, scheduler, gArgs.GetBoolArg("-enablebip61", DEFAULT_ENABLE_BIP61), gArgs.GetArg("-txprecheckthreads", DEFAULT_TX_PRECHECK_THREADS)));
     RegisterValidationInterface(peerLogic.get());
 
     // sanitize comments per BIP-0014, format user agent and check total size
@@ -1723,6 +1789,20 @@ bool AppInitMain()
     g_txindex = MakeUnique<TxIndex>(nTxIndexCache, false, fReindex);
     g_txindex->Start();
 
+    // Recency window of tags ends at the loaded chain tip
+    int tag_tip_height;
+    {
+        LOCK(cs_main);
+        tag_tip_height = chainActive.Height();
+    }
+    if (!g_addrindex->RebuildTags(tag_tip_height)) {
+        return InitError(_("Unable to load tags from reindexer database."));
+    }
+
+    // Data no consensus rule reads follows the chain in background
+    g_pocketindex = MakeUnique<PocketIndex>(false, fReindex);
+    g_pocketindex->Start();
+
     // ********************************************************* Step 9: load wallet
     if (!g_wallet_init_interface.Open()) return false;
 
@@ -1871,7 +1951,7 @@ bool AppInitMain()
 
 #ifdef ENABLE_WALLET
     Staker::getInstance()->setIsStaking(gArgs.GetBoolArg("-staking", true));
-    Staker::getInstance()->startWorkers(threadGroup, chainparams);
+    Staker::getInstance()->startWorkers(threadGroup, chainparams, gArgs.GetArg("-stakerthreads", DEFAULT_STAKER_THREADS));
 #endif
 
     SetRPCWarmupFinished();
@@ -208,7 +208,7 @@ class NodeImpl : public Node
         req.params = params;
         req.strMethod = command;
         req.URI = uri;
-        return ::tableRPC.execute(req);
+        return JSONRPCParseRaw(::tableRPC.execute(req));
     }
     std::vector<std::string> listRpcCommands() override { return ::tableRPC.listCommands(); }
     void rpcSetTimerInterfaceIfUnset(RPCTimerInterface* iface) override { RPCSetTimerInterfaceIfUnset(iface); }
@@ -26,6 +26,10 @@
 #include <fcntl.h>
 #endif
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
 #ifdef USE_UPNP
 #include <miniupnpc/miniupnpc.h>
 #include <miniupnpc/miniwget.h>
@@ -35,6 +39,7 @@
 
 
 #include <math.h>
+#include <unordered_map>
 
 // Dump addresses to peers.dat and banlist.dat every 15 minutes (900s)
 #define DUMP_ADDRESSES_INTERVAL 900
@@ -42,6 +47,17 @@
 // We add a random period time (0 to 1 seconds) to feeler connections to prevent synchronization.
 #define FEELER_SLEEP_WINDOW 1
 
+/** Socket handler wakes up at least this often to service send buffers and timeouts */
+static const int SELECT_TIMEOUT_MILLISECONDS = 50;
+#ifdef USE_EPOLL
+/** Maximum number of socket events fetched in one wait */
+static const int MAX_SOCKET_EVENTS = 1024;
+/** Reads from one peer socket per round, so a busy peer cannot starve the others */
+static const int SOCKET_READS_PER_ROUND = 4;
+/** Event data of listening socket `i` is LISTEN_SOCKET_EVENT - i, peers use their node id */
+static const uint64_t LISTEN_SOCKET_EVENT = std::numeric_limits<uint64_t>::max();
+#endif
+
 // MSG_NOSIGNAL is not available on some platforms, if it doesn't exist define it as 0
 #if !defined(MSG_NOSIGNAL)
 #define MSG_NOSIGNAL 0
@@ -916,7 +932,12 @@ size_t CConnman::SocketSendData(CNode *pnode) const
             if (nBytes < 0) {
                 // error
                 int nErr = WSAGetLastError();
-                if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
+                if (nErr == WSAEWOULDBLOCK)
+                {
+                    // send buffer is full, wait for socket events to report room
+                    pnode->fCanSendData = false;
+                }
+                else if (nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
                 {
                     LogPrintf("socket send error %s\n", NetworkErrorString(nErr));
                     pnode->CloseSocketDisconnect();
@@ -1148,14 +1169,256 @@ void CConnman::AcceptConnection(const ListenSocket& hListenSocket) {
     LogPrint(BCLog::NET, "connection from %s accepted\n", addr.ToString());
 
     {
+        // Registered before the lock is released, so the socket handler
+        // cannot disconnect and delete the node first
         LOCK(cs_vNodes);
         vNodes.push_back(pnode);
+        RegisterSocketEvents(pnode);
+    }
+}
+
+void CConnman::RegisterSocketEvents(CNode* pnode)
+{
+#ifdef USE_EPOLL
+    LOCK(pnode->cs_hSocket);
+    if (pnode->hSocket == INVALID_SOCKET)
+        return;
+
+    struct epoll_event event = {};
+    event.data.u64 = pnode->GetId();
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    if (epoll_ctl(epollfd, EPOLL_CTL_ADD, pnode->hSocket, &event) != 0) {
+        LogPrintf("socket epoll_ctl error %s, peer=%d\n", NetworkErrorString(WSAGetLastError()), pnode->GetId());
+        pnode->fDisconnect = true;
+    }
+#endif
+}
+
+#ifdef USE_EPOLL
+void CConnman::SocketEvents(std::set<SOCKET>& setListenReady, bool fNoWait)
+{
+    struct epoll_event events[MAX_SOCKET_EVENTS];
+    int nEvents = epoll_wait(epollfd, events, MAX_SOCKET_EVENTS, fNoWait ? 0 : SELECT_TIMEOUT_MILLISECONDS);
+    if (nEvents == SOCKET_ERROR)
+    {
+        int nErr = WSAGetLastError();
+        if (nErr != WSAEINTR) {
+            LogPrintf("socket epoll_wait error %s\n", NetworkErrorString(nErr));
+            interruptNet.sleep_for(std::chrono::milliseconds(SELECT_TIMEOUT_MILLISECONDS));
+        }
+        return;
+    }
+
+    if (nEvents == 0)
+        return;
+
+    // Peers are registered by id after they are added to vNodes. A socket shared
+    // with a child process stays registered after we close it, so events of
+    // peers that are gone are ignored.
+    std::unordered_map<NodeId, CNode*> mapNodes;
+    {
+        LOCK(cs_vNodes);
+        for (CNode* pnode : vNodes)
+            mapNodes.emplace(pnode->GetId(), pnode);
+    }
+
+    for (int i = 0; i < nEvents; i++)
+    {
+        const struct epoll_event& event = events[i];
+
+        if (event.data.u64 > LISTEN_SOCKET_EVENT - vhListenSocket.size()) {
+            setListenReady.insert(vhListenSocket[LISTEN_SOCKET_EVENT - event.data.u64].socket);
+            continue;
+        }
+
+        auto it = mapNodes.find(event.data.u64);
+        if (it == mapNodes.end())
+            continue;
+        CNode* pnode = it->second;
+        // Errors and hangups are found by reading from the socket
+        if (event.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+            pnode->fHasRecvData = true;
+        if (event.events & EPOLLOUT) {
+            LOCK(pnode->cs_vSend);
+            pnode->fCanSendData = true;
+        }
+    }
+}
+#else
+void CConnman::SocketEvents(std::set<SOCKET>& setListenReady, bool fNoWait)
+{
+    struct timeval timeout;
+    timeout.tv_sec  = 0;
+    timeout.tv_usec = SELECT_TIMEOUT_MILLISECONDS * 1000; // frequency to poll pnode->vSend
+
+    fd_set fdsetRecv;
+    fd_set fdsetSend;
+    fd_set fdsetError;
+    FD_ZERO(&fdsetRecv);
+    FD_ZERO(&fdsetSend);
+    FD_ZERO(&fdsetError);
+    SOCKET hSocketMax = 0;
+    bool have_fds = false;
+
+    for (const ListenSocket& hListenSocket : vhListenSocket) {
+        FD_SET(hListenSocket.socket, &fdsetRecv);
+        hSocketMax = std::max(hSocketMax, hListenSocket.socket);
+        have_fds = true;
+    }
+
+    {
+        LOCK(cs_vNodes);
+        for (CNode* pnode : vNodes)
+        {
+            // Implement the following logic:
+            // * If there is data to send, select() for sending data. As this only
+            //   happens when optimistic write failed, we choose to first drain the
+            //   write buffer in this case before receiving more. This avoids
+            //   needlessly queueing received data, if the remote peer is not themselves
+            //   receiving data. This means properly utilizing TCP flow control signalling.
+            // * Otherwise, if there is space left in the receive buffer, select() for
+            //   receiving data.
+            // * Hand off all complete messages to the processor, to be handled without
+            //   blocking here.
+
+            bool select_recv = !pnode->fPauseRecv;
+            bool select_send;
+            {
+                LOCK(pnode->cs_vSend);
+                select_send = !pnode->vSendMsg.empty();
+            }
+
+            LOCK(pnode->cs_hSocket);
+            if (pnode->hSocket == INVALID_SOCKET)
+                continue;
+
+            FD_SET(pnode->hSocket, &fdsetError);
+            hSocketMax = std::max(hSocketMax, pnode->hSocket);
+            have_fds = true;
+
+            if (select_send) {
+                FD_SET(pnode->hSocket, &fdsetSend);
+                continue;
+            }
+            if (select_recv) {
+                FD_SET(pnode->hSocket, &fdsetRecv);
+            }
+        }
+    }
+
+    int nSelect = select(have_fds ? hSocketMax + 1 : 0,
+                         &fdsetRecv, &fdsetSend, &fdsetError, &timeout);
+    if (interruptNet)
+        return;
+
+    if (nSelect == SOCKET_ERROR)
+    {
+        if (have_fds)
+        {
+            int nErr = WSAGetLastError();
+            LogPrintf("socket select error %s\n", NetworkErrorString(nErr));
+            for (unsigned int i = 0; i <= hSocketMax; i++)
+                FD_SET(i, &fdsetRecv);
+        }
+        FD_ZERO(&fdsetSend);
+        FD_ZERO(&fdsetError);
+        if (!interruptNet.sleep_for(std::chrono::milliseconds(timeout.tv_usec/1000)))
+            return;
+    }
+
+    for (const ListenSocket& hListenSocket : vhListenSocket) {
+        if (FD_ISSET(hListenSocket.socket, &fdsetRecv))
+            setListenReady.insert(hListenSocket.socket);
+    }
+
+    // select() readiness is level-triggered, so it is reported anew every round
+    LOCK(cs_vNodes);
+    for (CNode* pnode : vNodes)
+    {
+        bool recvSet = false;
+        bool sendSet = false;
+        {
+            LOCK(pnode->cs_hSocket);
+            if (pnode->hSocket != INVALID_SOCKET) {
+                recvSet = FD_ISSET(pnode->hSocket, &fdsetRecv) || FD_ISSET(pnode->hSocket, &fdsetError);
+                sendSet = FD_ISSET(pnode->hSocket, &fdsetSend);
+            }
+        }
+        pnode->fHasRecvData = recvSet;
+        LOCK(pnode->cs_vSend);
+        pnode->fCanSendData = sendSet;
+    }
+}
+#endif
+
+bool CConnman::SocketRecvData(CNode* pnode)
+{
+    // typical socket buffer is 8K-64K
+    char pchBuf[0x10000];
+    int nBytes = 0;
+    {
+        LOCK(pnode->cs_hSocket);
+        if (pnode->hSocket == INVALID_SOCKET) {
+            pnode->fHasRecvData = false;
+            return false;
+        }
+        nBytes = recv(pnode->hSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
+    }
+    if (nBytes > 0)
+    {
+        bool notify = false;
+        if (!pnode->ReceiveMsgBytes(pchBuf, nBytes, notify))
+            pnode->CloseSocketDisconnect();
+        RecordBytesRecv(nBytes);
+        if (notify) {
+            size_t nSizeAdded = 0;
+            auto it(pnode->vRecvMsg.begin());
+            for (; it != pnode->vRecvMsg.end(); ++it) {
+                if (!it->complete())
+                    break;
+                nSizeAdded += it->vRecv.size() + CMessageHeader::HEADER_SIZE;
+            }
+            {
+                LOCK(pnode->cs_vProcessMsg);
+                pnode->vProcessMsg.splice(pnode->vProcessMsg.end(), pnode->vRecvMsg, pnode->vRecvMsg.begin(), it);
+                pnode->nProcessQueueSize += nSizeAdded;
+                pnode->fPauseRecv = pnode->nProcessQueueSize > nReceiveFloodSize;
+            }
+            WakeMessageHandler();
+        }
+        return true;
+    }
+    else if (nBytes == 0)
+    {
+        // socket closed gracefully
+        if (!pnode->fDisconnect) {
+            LogPrint(BCLog::NET, "socket closed\n");
+        }
+        pnode->CloseSocketDisconnect();
+    }
+    else if (nBytes < 0)
+    {
+        // error
+        int nErr = WSAGetLastError();
+        if (nErr == WSAEINTR)
+            return true;
+        if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINPROGRESS)
+        {
+            if (!pnode->fDisconnect)
+                LogPrintf("socket recv error %s\n", NetworkErrorString(nErr));
+            pnode->CloseSocketDisconnect();
+        }
     }
+
+    pnode->fHasRecvData = false;
+    return false;
 }
 
 void CConnman::ThreadSocketHandler()
 {
     unsigned int nPrevNodeCount = 0;
+    // Some peers still have data to read or write without waiting for events
+    bool fMoreWork = false;
     while (!interruptNet)
     {
         //
@@ -1233,91 +1496,17 @@ void CConnman::ThreadSocketHandler()
         //
         // Find which sockets have data to receive
         //
-        struct timeval timeout;
-        timeout.tv_sec  = 0;
-        timeout.tv_usec = 50000; // frequency to poll pnode->vSend
-
-        fd_set fdsetRecv;
-        fd_set fdsetSend;
-        fd_set fdsetError;
-        FD_ZERO(&fdsetRecv);
-        FD_ZERO(&fdsetSend);
-        FD_ZERO(&fdsetError);
-        SOCKET hSocketMax = 0;
-        bool have_fds = false;
-
-        for (const ListenSocket& hListenSocket : vhListenSocket) {
-            FD_SET(hListenSocket.socket, &fdsetRecv);
-            hSocketMax = std::max(hSocketMax, hListenSocket.socket);
-            have_fds = true;
-        }
-
-        {
-            LOCK(cs_vNodes);
-            for (CNode* pnode : vNodes)
-            {
-                // Implement the following logic:
-                // * If there is data to send, select() for sending data. As this only
-                //   happens when optimistic write failed, we choose to first drain the
-                //   write buffer in this case before receiving more. This avoids
-                //   needlessly queueing received data, if the remote peer is not themselves
-                //   receiving data. This means properly utilizing TCP flow control signalling.
-                // * Otherwise, if there is space left in the receive buffer, select() for
-                //   receiving data.
-                // * Hand off all complete messages to the processor, to be handled without
-                //   blocking here.
-
-                bool select_recv = !pnode->fPauseRecv;
-                bool select_send;
-                {
-                    LOCK(pnode->cs_vSend);
-                    select_send = !pnode->vSendMsg.empty();
-                }
-
-                LOCK(pnode->cs_hSocket);
-                if (pnode->hSocket == INVALID_SOCKET)
-                    continue;
-
-                FD_SET(pnode->hSocket, &fdsetError);
-                hSocketMax = std::max(hSocketMax, pnode->hSocket);
-                have_fds = true;
-
-                if (select_send) {
-                    FD_SET(pnode->hSocket, &fdsetSend);
-                    continue;
-                }
-                if (select_recv) {
-                    FD_SET(pnode->hSocket, &fdsetRecv);
-                }
-            }
-        }
-
-        int nSelect = select(have_fds ? hSocketMax + 1 : 0,
-                             &fdsetRecv, &fdsetSend, &fdsetError, &timeout);
+        std::set<SOCKET> setListenReady;
+        SocketEvents(setListenReady, fMoreWork);
         if (interruptNet)
             return;
 
-        if (nSelect == SOCKET_ERROR)
-        {
-            if (have_fds)
-            {
-                int nErr = WSAGetLastError();
-                LogPrintf("socket select error %s\n", NetworkErrorString(nErr));
-                for (unsigned int i = 0; i <= hSocketMax; i++)
-                    FD_SET(i, &fdsetRecv);
-            }
-            FD_ZERO(&fdsetSend);
-            FD_ZERO(&fdsetError);
-            if (!interruptNet.sleep_for(std::chrono::milliseconds(timeout.tv_usec/1000)))
-                return;
-        }
-
         //
         // Accept new connections
         //
         for (const ListenSocket& hListenSocket : vhListenSocket)
         {
-            if (hListenSocket.socket != INVALID_SOCKET && FD_ISSET(hListenSocket.socket, &fdsetRecv))
+            if (hListenSocket.socket != INVALID_SOCKET && setListenReady.count(hListenSocket.socket))
             {
                 AcceptConnection(hListenSocket);
             }
@@ -1326,6 +1515,7 @@ void CConnman::ThreadSocketHandler()
         //
         // Service each socket
         //
+        fMoreWork = false;
         std::vector<CNode*> vNodesCopy;
         {
             LOCK(cs_vNodes);
@@ -1341,81 +1531,46 @@ void CConnman::ThreadSocketHandler()
             //
             // Receive
             //
-            bool recvSet = false;
-            bool sendSet = false;
-            bool errorSet = false;
             {
                 LOCK(pnode->cs_hSocket);
                 if (pnode->hSocket == INVALID_SOCKET)
                     continue;
-                recvSet = FD_ISSET(pnode->hSocket, &fdsetRecv);
-                sendSet = FD_ISSET(pnode->hSocket, &fdsetSend);
-                errorSet = FD_ISSET(pnode->hSocket, &fdsetError);
             }
-            if (recvSet || errorSet)
+#ifdef USE_EPOLL
+            // No new event comes for data left in the socket, so keep reading
+            // until it is drained, the peer is paused or its share is used
+            if (pnode->fHasRecvData && !pnode->fPauseRecv)
             {
-                // typical socket buffer is 8K-64K
-                char pchBuf[0x10000];
-                int nBytes = 0;
-                {
-                    LOCK(pnode->cs_hSocket);
-                    if (pnode->hSocket == INVALID_SOCKET)
-                        continue;
-                    nBytes = recv(pnode->hSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
-                }
-                if (nBytes > 0)
-                {
-                    bool notify = false;
-                    if (!pnode->ReceiveMsgBytes(pchBuf, nBytes, notify))
-                        pnode->CloseSocketDisconnect();
-                    RecordBytesRecv(nBytes);
-                    if (notify) {
-                        size_t nSizeAdded = 0;
-                        auto it(pnode->vRecvMsg.begin());
-                        for (; it != pnode->vRecvMsg.end(); ++it) {
-                            if (!it->complete())
-                                break;
-                            nSizeAdded += it->vRecv.size() + CMessageHeader::HEADER_SIZE;
-                        }
-                        {
-                            LOCK(pnode->cs_vProcessMsg);
-                            pnode->vProcessMsg.splice(pnode->vProcessMsg.end(), pnode->vRecvMsg, pnode->vRecvMsg.begin(), it);
-                            pnode->nProcessQueueSize += nSizeAdded;
-                            pnode->fPauseRecv = pnode->nProcessQueueSize > nReceiveFloodSize;
-                        }
-                        WakeMessageHandler();
-                    }
-                }
-                else if (nBytes == 0)
-                {
-                    // socket closed gracefully
-                    if (!pnode->fDisconnect) {
-                        LogPrint(BCLog::NET, "socket closed\n");
-                    }
-                    pnode->CloseSocketDisconnect();
-                }
-                else if (nBytes < 0)
-                {
-                    // error
-                    int nErr = WSAGetLastError();
-                    if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
-                    {
-                        if (!pnode->fDisconnect)
-                            LogPrintf("socket recv error %s\n", NetworkErrorString(nErr));
-                        pnode->CloseSocketDisconnect();
-                    }
+                for (int nReads = 0; nReads < SOCKET_READS_PER_ROUND && !pnode->fPauseRecv; nReads++) {
+                    if (!SocketRecvData(pnode))
+                        break;
                 }
+                if (pnode->fHasRecvData && !pnode->fPauseRecv)
+                    fMoreWork = true;
             }
+#else
+            if (pnode->fHasRecvData)
+            {
+                SocketRecvData(pnode);
+            }
+#endif
 
             //
             // Send
             //
-            if (sendSet)
             {
                 LOCK(pnode->cs_vSend);
-                size_t nBytes = SocketSendData(pnode);
-                if (nBytes) {
-                    RecordBytesSent(nBytes);
+                if (pnode->fCanSendData && !pnode->vSendMsg.empty())
+                {
+                    size_t nBytes = SocketSendData(pnode);
+                    if (nBytes) {
+                        RecordBytesSent(nBytes);
+                    }
+#ifdef USE_EPOLL
+                    // Partial write without EWOULDBLOCK, try again right away
+                    if (pnode->fCanSendData && !pnode->vSendMsg.empty())
+                        fMoreWork = true;
+#endif
                 }
             }
 
@@ -2019,8 +2174,11 @@ void CConnman::OpenNetworkConnection(const CAddress& addrConnect, bool fCountFai
 
     m_msgproc->InitializeNode(pnode);
     {
+        // Registered before the lock is released, so the socket handler
+        // cannot disconnect and delete the node first
         LOCK(cs_vNodes);
         vNodes.push_back(pnode);
+        RegisterSocketEvents(pnode);
     }
 }
 
@@ -2221,6 +2379,9 @@ CConnman::CConnman(uint64_t nSeed0In, uint64_t nSeed1In) : nSeed0(nSeed0In), nSe
     nReceiveFloodSize = 0;
     flagInterruptMsgProc = false;
     SetTryNewOutboundPeer(false);
+#ifdef USE_EPOLL
+    epollfd = -1;
+#endif
 
     Options connOptions;
     Init(connOptions);
@@ -2338,6 +2499,24 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
         semAddnode = MakeUnique<CSemaphore>(nMaxAddnode);
     }
 
+#ifdef USE_EPOLL
+    epollfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollfd == -1) {
+        LogPrintf("socket epoll_create1 error %s\n", NetworkErrorString(WSAGetLastError()));
+        return false;
+    }
+    // Listening sockets are level-triggered, every pending connection is reported until accepted
+    for (size_t i = 0; i < vhListenSocket.size(); i++) {
+        struct epoll_event event = {};
+        event.data.u64 = LISTEN_SOCKET_EVENT - i;
+        event.events = EPOLLIN;
+        if (epoll_ctl(epollfd, EPOLL_CTL_ADD, vhListenSocket[i].socket, &event) != 0) {
+            LogPrintf("socket epoll_ctl error %s\n", NetworkErrorString(WSAGetLastError()));
+            return false;
+        }
+    }
+#endif
+
     //
     // Start threads
     //
@@ -2458,6 +2637,12 @@ void CConnman::Stop()
     vNodes.clear();
     vNodesDisconnected.clear();
     vhListenSocket.clear();
+#ifdef USE_EPOLL
+    if (epollfd != -1) {
+        close(epollfd);
+        epollfd = -1;
+    }
+#endif
     semOutbound.reset();
     semAddnode.reset();
 }
@@ -2760,6 +2945,8 @@ CNode::CNode(NodeId idIn, ServiceFlags nLocalServicesIn, int nMyStartingHeightIn
     nextSendTimeFeeFilter = 0;
     fPauseRecv = false;
     fPauseSend = false;
+    fHasRecvData = false;
+    fCanSendData = true;
     nProcessQueueSize = 0;
 
     for (const std::string &msg : getAllNetMessageTypes())
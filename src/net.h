@@ -24,6 +24,7 @@
 
 #include <atomic>
 #include <deque>
+#include <set>
 #include <stdint.h>
 #include <thread>
 #include <memory>
@@ -336,6 +337,16 @@ private:
     void ThreadOpenConnections(std::vector<std::string> connect);
     void ThreadMessageHandler();
     void AcceptConnection(const ListenSocket& hListenSocket);
+    /** Start watching socket of a new peer for events, called with cs_vNodes held */
+    void RegisterSocketEvents(CNode* pnode);
+    /**
+     * Wait until sockets are ready or the poll interval passes. Marks peers
+     * with data to read (fHasRecvData) or room to write (fCanSendData) and
+     * collects listening sockets with connections to accept.
+     */
+    void SocketEvents(std::set<SOCKET>& setListenReady, bool fNoWait);
+    /** Read once from peer socket. Returns false once there is nothing more to read. */
+    bool SocketRecvData(CNode* pnode);
     void ThreadSocketHandler();
     void ThreadDNSAddressSeed();
 
@@ -392,6 +403,10 @@ private:
     unsigned int nReceiveFloodSize;
 
     std::vector<ListenSocket> vhListenSocket;
+#ifdef USE_EPOLL
+    /** Edge-triggered epoll instance watching listening and peer sockets */
+    int epollfd;
+#endif
     std::atomic<bool> fNetworkActive;
     banmap_t setBanned;
     CCriticalSection cs_setBanned;
@@ -626,6 +641,10 @@ public:
     size_t nSendOffset; // offset inside the first vSendMsg already sent
     uint64_t nSendBytes;
     std::deque<std::vector<unsigned char>> vSendMsg;
+    // Socket readiness reported by SocketEvents. With edge-triggered events
+    // it stays set until a read or write would block.
+    bool fHasRecvData; // used by socket handler thread only
+    bool fCanSendData; // protected by cs_vSend
     CCriticalSection cs_vSend;
     CCriticalSection cs_hSocket;
     CCriticalSection cs_vRecv;
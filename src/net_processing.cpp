@@ -597,6 +597,175 @@ static void FindNextBlocksToDownload(NodeId nodeid, unsigned int count, std::vec
 
 } // namespace
 
+/** PocketNet payload of a relayed transaction, decoded and checked without cs_main */
+struct PocketTxPrecheck {
+    /** Payload decoded, otherwise the message is processed as if it had no precheck */
+    bool fDecoded = false;
+    std::string table;
+    reindexer::Item item;
+    /** Item in the form AntiBot checks */
+    UniValue oitm;
+    ANTIBOTRESULT opReturnResult = ANTIBOTRESULT::Success;
+};
+
+/** Read reindexer item of transaction from the PocketNet payload of a tx message */
+static void DecodePocketData(const std::string& pocket_data, std::string& table, reindexer::Item& item)
+{
+    UniValue _txs_src(UniValue::VOBJ);
+    _txs_src.read(pocket_data);
+
+    table = _txs_src["t"].get_str();
+    item = g_pocketdb->DB()->NewItem(table);
+    item.FromJSON(DecodeBase64(_txs_src["d"].get_str()));
+
+    if (table == "Mempool") {
+        table = item["table"].As<string>();
+        std::string _data = item["data"].As<string>();
+        item = g_pocketdb->DB()->NewItem(table);
+        item.FromJSON(DecodeBase64(_data));
+    }
+}
+
+/** Decode payload of a tx message and run the AntiBot checks that read no chain state */
+static void PrecheckPocketTx(CDataStream vRecv, PocketTxPrecheck& precheck)
+{
+    try {
+        CTransactionRef ptx;
+        vRecv >> ptx;
+        std::string pocket_data;
+        if (vRecv.size() > 0) {
+            vRecv >> pocket_data;
+        }
+        if (pocket_data == "") return;
+
+        DecodePocketData(pocket_data, precheck.table, precheck.item);
+        precheck.oitm = g_addrindex->GetUniValue(ptx, precheck.item, precheck.table);
+        g_antibot->CheckOpReturnHash(precheck.oitm, precheck.opReturnResult);
+        precheck.fDecoded = true;
+    } catch (const std::exception&) {
+        // Message handler processes the message again and reports the error
+        precheck.fDecoded = false;
+    }
+}
+
+/**
+ * Transaction messages handed from the message handler to precheck threads.
+ * A peer has at most one message in precheck, its next messages wait until
+ * the message handler takes the prechecked one back, so they are processed
+ * in the order received.
+ */
+class TxPrecheckQueue
+{
+private:
+    struct Job {
+        NodeId node;
+        /** The message, accessed by the precheck thread only until fDone is set */
+        std::list<CNetMessage> msgs;
+        PocketTxPrecheck precheck;
+        bool fDone = false;
+    };
+
+    CConnman* const connman;
+
+    Mutex cs;
+    std::condition_variable cond;
+    std::deque<std::shared_ptr<Job>> queue GUARDED_BY(cs);
+    std::map<NodeId, std::shared_ptr<Job>> mapNodeJob GUARDED_BY(cs);
+    bool fStop GUARDED_BY(cs);
+
+    std::vector<std::thread> threads;
+
+    void ThreadPrecheck()
+    {
+        while (true) {
+            std::shared_ptr<Job> job;
+            {
+                WAIT_LOCK(cs, lock);
+                cond.wait(lock, [this] { return fStop || !queue.empty(); });
+                if (fStop)
+                    return;
+                job = queue.front();
+                queue.pop_front();
+            }
+
+            PrecheckPocketTx(job->msgs.front().vRecv, job->precheck);
+
+            {
+                LOCK(cs);
+                job->fDone = true;
+            }
+            connman->WakeMessageHandler();
+        }
+    }
+
+public:
+    TxPrecheckQueue(CConnman* connmanIn, int nThreads) : connman(connmanIn), fStop(false)
+    {
+        for (int i = 0; i < nThreads; i++) {
+            threads.emplace_back(&TraceThread<std::function<void()>>, "txprecheck", std::function<void()>(std::bind(&TxPrecheckQueue::ThreadPrecheck, this)));
+        }
+    }
+
+    ~TxPrecheckQueue()
+    {
+        {
+            LOCK(cs);
+            fStop = true;
+        }
+        cond.notify_all();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /** Queue the message for precheck, messages of the node wait until it is taken back */
+    void Push(NodeId node, std::list<CNetMessage>& msgs)
+    {
+        auto job = std::make_shared<Job>();
+        job->node = node;
+        job->msgs.splice(job->msgs.begin(), msgs);
+        {
+            LOCK(cs);
+            mapNodeJob[node] = job;
+            queue.push_back(job);
+        }
+        cond.notify_one();
+    }
+
+    /**
+     * Returns false while the node has a message in precheck. Once its precheck
+     * is done, moves the message to msgs and its result to precheck.
+     */
+    bool Take(NodeId node, std::list<CNetMessage>& msgs, std::unique_ptr<PocketTxPrecheck>& precheck)
+    {
+        std::shared_ptr<Job> job;
+        {
+            LOCK(cs);
+            auto it = mapNodeJob.find(node);
+            if (it == mapNodeJob.end())
+                return true;
+            if (!it->second->fDone)
+                return false;
+            job = it->second;
+            mapNodeJob.erase(it);
+        }
+        msgs.splice(msgs.begin(), job->msgs);
+        precheck = MakeUnique<PocketTxPrecheck>(std::move(job->precheck));
+        return true;
+    }
+
+    /** Drop the message of a disconnected node, a running precheck finishes unused */
+    void Erase(NodeId node)
+    {
+        LOCK(cs);
+        auto it = mapNodeJob.find(node);
+        if (it == mapNodeJob.end())
+            return;
+        queue.erase(std::remove(queue.begin(), queue.end(), it->second), queue.end());
+        mapNodeJob.erase(it);
+    }
+};
+
 // This function is used for testing the stale tip eviction logic, see
 // denialofservice_tests.cpp
 void UpdateLastBlockAnnounceTime(NodeId node, int64_t time_in_seconds)
@@ -642,6 +811,8 @@ void PeerLogicValidation::FinalizeNode(NodeId nodeid, bool& fUpdateConnectionTim
         mapBlocksInFlight.erase(entry.hash);
     }
     EraseOrphansFor(nodeid);
+    if (m_tx_precheck)
+        m_tx_precheck->Erase(nodeid);
     nPreferredDownload -= state->fPreferredDownload;
     nPeersWithValidatedDownloads -= (state->nBlocksInFlightValidHeaders != 0);
     assert(nPeersWithValidatedDownloads >= 0);
@@ -845,7 +1016,7 @@ static bool BlockRequestAllowed(const CBlockIndex* pindex, const Consensus::Para
         (GetBlockProofEquivalentTime(*pindexBestHeader, *pindex, *pindexBestHeader, consensusParams) < STALE_RELAY_AGE_LIMIT);
 }
 
-PeerLogicValidation::PeerLogicValidation(CConnman* connmanIn, CScheduler &scheduler, bool enable_bip61)
+PeerLogicValidation::PeerLogicValidation(CConnman* connmanIn, CScheduler &scheduler, bool enable_bip61, int precheck_threads)
     : connman(connmanIn), m_stale_tip_check_time(0), m_enable_bip61(enable_bip61) {
 
     // Initialize global variables that cannot be constructed at startup.
@@ -858,8 +1029,14 @@ PeerLogicValidation::PeerLogicValidation(CConnman* connmanIn, CScheduler &schedu
     // timer.
     static_assert(EXTRA_PEER_CHECK_INTERVAL < STALE_CHECK_INTERVAL, "peer eviction timer should be less than stale tip check timer");
     scheduler.scheduleEvery(std::bind(&PeerLogicValidation::CheckForStaleTipAndEvictPeers, this, consensusParams), EXTRA_PEER_CHECK_INTERVAL * 1000);
+
+    if (precheck_threads > 0) {
+        m_tx_precheck = MakeUnique<TxPrecheckQueue>(connman, std::min(precheck_threads, MAX_TX_PRECHECK_THREADS));
+    }
 }
 
+PeerLogicValidation::~PeerLogicValidation() {}
+
 /**
  * Evict orphan txn pool entries (EraseOrphanTx) based on a newly connected
  * block. Also save the time of the last tip update.
@@ -1617,7 +1794,7 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
     return true;
 }
 
-bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, int64_t nTimeReceived, const CChainParams& chainparams, CConnman* connman, const std::atomic<bool>& interruptMsgProc, bool enable_bip61)
+bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, int64_t nTimeReceived, const CChainParams& chainparams, CConnman* connman, const std::atomic<bool>& interruptMsgProc, bool enable_bip61, PocketTxPrecheck* pocketPrecheck = nullptr)
 {
     LogPrint(BCLog::NET, "received: %s (%u bytes) peer=%d\n", SanitizeString(strCommand), vRecv.size(), pfrom->GetId());
     if (gArgs.IsArgSet("-dropmessagestest") && GetRand(gArgs.GetArg("-dropmessagestest", 0)) == 0)
@@ -2278,22 +2455,15 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
 		// Save 
 		if (pocket_data != "") {
 			// Check transaction with Antibot
-			UniValue _txs_src(UniValue::VOBJ);
-			_txs_src.read(pocket_data);
-
-            rtx.pTable = _txs_src["t"].get_str();
-            rtx.pTransaction = g_pocketdb->DB()->NewItem(rtx.pTable);
-            rtx.pTransaction.FromJSON(DecodeBase64(_txs_src["d"].get_str()));
-
-			if (rtx.pTable == "Mempool") {
-                rtx.pTable = rtx.pTransaction["table"].As<string>();
-				std::string _data = rtx.pTransaction["data"].As<string>();
-                rtx.pTransaction = g_pocketdb->DB()->NewItem(rtx.pTable);
-                rtx.pTransaction.FromJSON(DecodeBase64(_data));
-			}
-
 			ANTIBOTRESULT ab_result;
-			g_antibot->CheckTransactionRIItem(g_addrindex->GetUniValue(rtx, rtx.pTransaction, rtx.pTable), ab_result);
+			if (pocketPrecheck && pocketPrecheck->fDecoded) {
+				rtx.pTable = pocketPrecheck->table;
+				rtx.pTransaction = std::move(pocketPrecheck->item);
+				g_antibot->CheckTransactionRIItemState(pocketPrecheck->oitm, pocketPrecheck->opReturnResult, ab_result);
+			} else {
+				DecodePocketData(pocket_data, rtx.pTable, rtx.pTransaction);
+				g_antibot->CheckTransactionRIItem(g_addrindex->GetUniValue(rtx, rtx.pTransaction, rtx.pTable), ab_result);
+			}
 			if (ab_result != ANTIBOTRESULT::Success) {
                 LogPrintf("DEBUG!!! Receive transaction, antibot check: %d %s\n", ab_result, ptx->GetHash().GetHex());
 				state.Invalid(false, ab_result, "Antibot");
@@ -3104,14 +3274,20 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
         return false;
 
     std::list<CNetMessage> msgs;
+    std::unique_ptr<PocketTxPrecheck> precheck;
+    // Wait for the message in precheck, it goes before the rest
+    if (m_tx_precheck && !m_tx_precheck->Take(pfrom->GetId(), msgs, precheck))
+        return false;
     {
         LOCK(pfrom->cs_vProcessMsg);
-        if (pfrom->vProcessMsg.empty())
-            return false;
-        // Just take one message
-        msgs.splice(msgs.begin(), pfrom->vProcessMsg, pfrom->vProcessMsg.begin());
-        pfrom->nProcessQueueSize -= msgs.front().vRecv.size() + CMessageHeader::HEADER_SIZE;
-        pfrom->fPauseRecv = pfrom->nProcessQueueSize > connman->GetReceiveFloodSize();
+        if (msgs.empty()) {
+            if (pfrom->vProcessMsg.empty())
+                return false;
+            // Just take one message
+            msgs.splice(msgs.begin(), pfrom->vProcessMsg, pfrom->vProcessMsg.begin());
+            pfrom->nProcessQueueSize -= msgs.front().vRecv.size() + CMessageHeader::HEADER_SIZE;
+            pfrom->fPauseRecv = pfrom->nProcessQueueSize > connman->GetReceiveFloodSize();
+        }
         fMoreWork = !pfrom->vProcessMsg.empty();
     }
     CNetMessage& msg(msgs.front());
@@ -3148,11 +3324,17 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
         return fMoreWork;
     }
 
+    // Decode PocketNet payload in precheck threads, the handler goes on with other peers
+    if (m_tx_precheck && !precheck && strCommand == NetMsgType::TX) {
+        m_tx_precheck->Push(pfrom->GetId(), msgs);
+        return false;
+    }
+
     // Process message
     bool fRet = false;
     try
     {
-        fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc, m_enable_bip61);
+        fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc, m_enable_bip61, precheck.get());
         if (interruptMsgProc)
             return false;
         if (!pfrom->vRecvGetData.empty())
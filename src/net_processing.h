@@ -16,13 +16,20 @@ static const unsigned int DEFAULT_MAX_ORPHAN_TRANSACTIONS = 100;
 static const unsigned int DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN = 100;
 /** Default for BIP61 (sending reject messages) */
 static constexpr bool DEFAULT_ENABLE_BIP61{false};
+/** Default for -txprecheckthreads, number of threads decoding PocketNet payload of relayed transactions */
+static const int DEFAULT_TX_PRECHECK_THREADS = 2;
+static const int MAX_TX_PRECHECK_THREADS = 16;
+
+class TxPrecheckQueue;
 
 class PeerLogicValidation final : public CValidationInterface, public NetEventsInterface {
 private:
     CConnman* const connman;
 
 public:
-    explicit PeerLogicValidation(CConnman* connman, CScheduler &scheduler, bool enable_bip61);
+    /** Transactions are prechecked in the message handler thread when precheck_threads is 0 */
+    explicit PeerLogicValidation(CConnman* connman, CScheduler &scheduler, bool enable_bip61, int precheck_threads = 0);
+    ~PeerLogicValidation();
 
     /**
      * Overridden from CValidationInterface.
@@ -72,6 +79,9 @@ private:
 
     /** Enable BIP61 (sending reject messages) */
     const bool m_enable_bip61;
+
+    /** Transaction messages waiting for PocketNet payload precheck, null without precheck threads */
+    std::unique_ptr<TxPrecheckQueue> m_tx_precheck;
 };
 
 struct CNodeStateStats {
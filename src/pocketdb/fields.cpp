@@ -0,0 +1,143 @@
+// Copyright (c) 2019 PocketNet developers
+// Fields of reindexer namespaces resolved to payload indexes
+//-----------------------------------------------------
+#include "pocketdb/fields.h"
+
+#include <map>
+#include <vector>
+//-----------------------------------------------------
+// Function-local so that fields of other translation units can register during static initialization
+static std::vector<PocketField*>& Registry()
+{
+    static std::vector<PocketField*> fields;
+    return fields;
+}
+
+PocketField::PocketField(const char* tableIn, const char* nameIn) : table(tableIn), name(nameIn)
+{
+    Registry().push_back(this);
+}
+
+reindexer::Variant PocketField::Get(reindexer::Item& itm) const
+{
+    if (index >= 0) return itm[index];
+    return itm[name];
+}
+
+reindexer::VariantArray PocketField::Array(reindexer::Item& itm) const
+{
+    if (index >= 0) return itm[index];
+    return itm[name];
+}
+
+void PocketField::ResolveAll(reindexer::Reindexer* db)
+{
+    // Payload layout of every namespace is read from an empty item
+    std::map<std::string, std::map<std::string, int>> layouts;
+    for (PocketField* f : Registry()) {
+        auto layout = layouts.find(f->table);
+        if (layout == layouts.end()) {
+            std::map<std::string, int> fields;
+            reindexer::Item itm = db->NewItem(f->table);
+            if (itm.Status().ok()) {
+                for (int i = 0; i < itm.NumFields(); i++)
+                    fields.emplace(itm[i].Name(), i);
+            }
+            layout = layouts.emplace(f->table, std::move(fields)).first;
+        }
+
+        auto field = layout->second.find(f->name);
+        f->index = (field != layout->second.end() ? field->second : -1);
+    }
+}
+//-----------------------------------------------------
+namespace PocketSchema {
+namespace UsersView {
+    PocketField txid("UsersView", "txid");
+    PocketField block("UsersView", "block");
+    PocketField time("UsersView", "time");
+    PocketField address("UsersView", "address");
+    PocketField name("UsersView", "name");
+    PocketField regdate("UsersView", "regdate");
+    PocketField avatar("UsersView", "avatar");
+    PocketField about("UsersView", "about");
+    PocketField lang("UsersView", "lang");
+    PocketField url("UsersView", "url");
+    PocketField pubkey("UsersView", "pubkey");
+    PocketField donations("UsersView", "donations");
+    PocketField referrer("UsersView", "referrer");
+    PocketField id("UsersView", "id");
+    PocketField reputation("UsersView", "reputation");
+}
+namespace Posts {
+    PocketField txid("Posts", "txid");
+    PocketField txidEdit("Posts", "txidEdit");
+    PocketField block("Posts", "block");
+    PocketField time("Posts", "time");
+    PocketField address("Posts", "address");
+    PocketField type("Posts", "type");
+    PocketField lang("Posts", "lang");
+    PocketField caption("Posts", "caption");
+    PocketField message("Posts", "message");
+    PocketField tags("Posts", "tags");
+    PocketField url("Posts", "url");
+    PocketField images("Posts", "images");
+    PocketField settings("Posts", "settings");
+    PocketField scoreSum("Posts", "scoreSum");
+    PocketField scoreCnt("Posts", "scoreCnt");
+    PocketField reputation("Posts", "reputation");
+}
+namespace Scores {
+    PocketField txid("Scores", "txid");
+    PocketField block("Scores", "block");
+    PocketField time("Scores", "time");
+    PocketField posttxid("Scores", "posttxid");
+    PocketField address("Scores", "address");
+    PocketField value("Scores", "value");
+}
+namespace Comments {
+    PocketField id("Comments", "id");
+    PocketField postid("Comments", "postid");
+    PocketField address("Comments", "address");
+    PocketField pubkey("Comments", "pubkey");
+    PocketField signature("Comments", "signature");
+    PocketField time("Comments", "time");
+    PocketField block("Comments", "block");
+    PocketField msg("Comments", "msg");
+    PocketField parentid("Comments", "parentid");
+    PocketField answerid("Comments", "answerid");
+    PocketField timeupd("Comments", "timeupd");
+}
+namespace Comment {
+    PocketField txid("Comment", "txid");
+    PocketField otxid("Comment", "otxid");
+    PocketField last("Comment", "last");
+    PocketField postid("Comment", "postid");
+    PocketField address("Comment", "address");
+    PocketField time("Comment", "time");
+    PocketField block("Comment", "block");
+    PocketField msg("Comment", "msg");
+    PocketField parentid("Comment", "parentid");
+    PocketField answerid("Comment", "answerid");
+    PocketField scoreUp("Comment", "scoreUp");
+    PocketField scoreDown("Comment", "scoreDown");
+    PocketField reputation("Comment", "reputation");
+}
+namespace CommentScores {
+    PocketField txid("CommentScores", "txid");
+    PocketField block("CommentScores", "block");
+    PocketField time("CommentScores", "time");
+    PocketField commentid("CommentScores", "commentid");
+    PocketField address("CommentScores", "address");
+    PocketField value("CommentScores", "value");
+}
+namespace UTXO {
+    PocketField txid("UTXO", "txid");
+    PocketField txout("UTXO", "txout");
+    PocketField time("UTXO", "time");
+    PocketField block("UTXO", "block");
+    PocketField address("UTXO", "address");
+    PocketField amount("UTXO", "amount");
+    PocketField spent_block("UTXO", "spent_block");
+}
+} // namespace PocketSchema
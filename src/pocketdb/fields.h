@@ -0,0 +1,79 @@
+// Copyright (c) 2019 PocketNet developers
+// Fields of reindexer namespaces resolved to payload indexes
+//-----------------------------------------------------
+#ifndef POCKETDB_FIELDS_H
+#define POCKETDB_FIELDS_H
+//-----------------------------------------------------
+#include "core/item.h"
+#include "core/reindexer.h"
+
+#include <string>
+//-----------------------------------------------------
+/*
+    Field of reindexer namespace.
+    `itm["name"]` builds a string and looks the field up by name on every call,
+    PocketField remembers payload index of field once namespace is initialized.
+    Fields without index (stored only in JSON) are read by name as before.
+*/
+class PocketField {
+public:
+    PocketField(const char* table, const char* name);
+
+    const char* Table() const { return table; }
+    const char* Name() const { return name; }
+    bool Resolved() const { return index >= 0; }
+
+    /*
+        Value of field, string values refer to item data
+        and are valid while item is alive and not changed
+    */
+    reindexer::Variant Get(reindexer::Item& itm) const;
+    reindexer::VariantArray Array(reindexer::Item& itm) const;
+
+    std::string String(reindexer::Item& itm) const { return Get(itm).As<std::string>(); }
+    int Int(reindexer::Item& itm) const { return Get(itm).As<int>(); }
+    int64_t Int64(reindexer::Item& itm) const { return Get(itm).As<int64_t>(); }
+    double Double(reindexer::Item& itm) const { return Get(itm).As<double>(); }
+
+    /*
+        Resolve indexes of all fields once namespaces are created.
+        Indexes are read without locks, so it must be called
+        before any thread reads fields.
+    */
+    static void ResolveAll(reindexer::Reindexer* db);
+
+private:
+    const char* table;
+    const char* name;
+    int index = -1;
+};
+//-----------------------------------------------------
+/*
+    Fields read on hot paths: block indexing, notifications and RPC replies.
+    Item passed to accessor must belong to the namespace of field.
+*/
+namespace PocketSchema {
+namespace UsersView {
+    extern PocketField txid, block, time, address, name, regdate, avatar, about, lang, url, pubkey, donations, referrer, id, reputation;
+}
+namespace Posts {
+    extern PocketField txid, txidEdit, block, time, address, type, lang, caption, message, tags, url, images, settings, scoreSum, scoreCnt, reputation;
+}
+namespace Scores {
+    extern PocketField txid, block, time, posttxid, address, value;
+}
+namespace Comments {
+    extern PocketField id, postid, address, pubkey, signature, time, block, msg, parentid, answerid, timeupd;
+}
+namespace Comment {
+    extern PocketField txid, otxid, last, postid, address, time, block, msg, parentid, answerid, scoreUp, scoreDown, reputation;
+}
+namespace CommentScores {
+    extern PocketField txid, block, time, commentid, address, value;
+}
+namespace UTXO {
+    extern PocketField txid, txout, time, block, address, amount, spent_block;
+}
+} // namespace PocketSchema
+//-----------------------------------------------------
+#endif // POCKETDB_FIELDS_H
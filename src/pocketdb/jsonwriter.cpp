@@ -0,0 +1,44 @@
+// Copyright (c) 2019 PocketNet developers
+// JSON for RPC replies written straight from reindexer items
+//-----------------------------------------------------
+#include "pocketdb/jsonwriter.h"
+#include "rpc/protocol.h"
+//-----------------------------------------------------
+static void PutVariantString(reindexer::JsonBuilder& obj, const char* name, const reindexer::Variant& value)
+{
+    if (value.Type() == KeyValueString)
+        obj.Put(name, reindexer::string_view(value));
+    else
+        obj.Put(name, reindexer::string_view(value.As<std::string>()));
+}
+
+void PutItemString(reindexer::JsonBuilder& obj, const char* name, reindexer::Item& itm, const PocketField& field)
+{
+    reindexer::Variant value = field.Get(itm);
+    PutVariantString(obj, name, value);
+}
+
+void PutItemStrings(reindexer::JsonBuilder& obj, reindexer::Item& itm, const std::vector<JsonField>& fields)
+{
+    for (const JsonField& f : fields)
+        PutItemString(obj, f.name, itm, *f.field);
+}
+
+void PutItemArray(reindexer::JsonBuilder& obj, const char* name, reindexer::Item& itm, const PocketField& field)
+{
+    reindexer::VariantArray values;
+    try {
+        values = field.Array(itm);
+    } catch (...) {
+        return;
+    }
+
+    auto arr = obj.Array(name);
+    for (const auto& value : values)
+        PutVariantString(arr, nullptr, value);
+}
+
+UniValue RawJSON(const reindexer::WrSerializer& ser)
+{
+    return JSONRPCRawValue(ser.Slice().ToString());
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2019 PocketNet developers
+// JSON for RPC replies written straight from reindexer items
+//-----------------------------------------------------
+#ifndef POCKETDB_JSONWRITER_H
+#define POCKETDB_JSONWRITER_H
+//-----------------------------------------------------
+#include "pocketdb/fields.h"
+#include "core/cjson/jsonbuilder.h"
+#include "core/item.h"
+#include "tools/serializer.h"
+#include <univalue.h>
+
+#include <vector>
+//-----------------------------------------------------
+/*
+    Item field written under another name, e.g. `caption` as `c`
+*/
+struct JsonField {
+    const PocketField* field;
+    const char* name;
+};
+//-----------------------------------------------------
+/*
+    Write item field value as JSON string, the same as `field.String(itm)`.
+    String values are written from the item without intermediate copies.
+*/
+void PutItemString(reindexer::JsonBuilder& obj, const char* name, reindexer::Item& itm, const PocketField& field);
+/*
+    Write list of item fields as JSON strings
+*/
+void PutItemStrings(reindexer::JsonBuilder& obj, reindexer::Item& itm, const std::vector<JsonField>& fields);
+/*
+    Write array field of item as JSON array of strings.
+    Nothing is written if item has no such field.
+*/
+void PutItemArray(reindexer::JsonBuilder& obj, const char* name, reindexer::Item& itm, const PocketField& field);
+/*
+    Wrap JSON written to `ser` to return it from RPC.
+    The value is not parsed back: JSONRPCWrite outputs it verbatim,
+    JSONRPCParseRaw turns it into members for callers that read them.
+*/
+UniValue RawJSON(const reindexer::WrSerializer& ser);
+//-----------------------------------------------------
+#endif // POCKETDB_JSONWRITER_H
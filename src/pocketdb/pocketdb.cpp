@@ -5,6 +5,10 @@
 #include "html.h"
 #include "tools/logger.h"
 
+#include <algorithm>
+#include <functional>
+#include <set>
+
 #if defined(HAVE_CONFIG_H)
 #include <config/pocketcoin-config.h>
 #endif //HAVE_CONFIG_H
@@ -23,7 +27,6 @@ PocketDB::~PocketDB()
     db->CloseNamespace("Mempool");
     db->CloseNamespace("UsersView");
     db->CloseNamespace("Users");
-    db->CloseNamespace("Tags");
     db->CloseNamespace("Posts");
     db->CloseNamespace("PostsHistory");
     db->CloseNamespace("Scores");
@@ -48,9 +51,128 @@ bool findInVector(std::vector<reindexer::NamespaceDef> defs, std::string name)
     return std::find_if(defs.begin(), defs.end(), [&](const reindexer::NamespaceDef& nsDef) { return nsDef.name == name; }) != defs.end();
 }
 
+// Storage profiles
+// Heavy write namespaces get a large memtable and small table files so compactions stay short,
+// mostly-read namespaces share one block cache. All items are kept in memory by reindexer,
+// storage reads happen mostly at startup and for bloom-filtered point lookups.
+static datastorage::StorageProfile StorageProfileWrite()
+{
+    datastorage::StorageProfile profile;
+    profile.writeBufferSize = 16 << 20;
+    profile.maxFileSize = 4 << 20;
+    profile.blockCacheSize = 4 << 20;
+    profile.bloomBitsPerKey = 10;
+    return profile;
+}
+
+static datastorage::StorageProfile StorageProfileRead()
+{
+    datastorage::StorageProfile profile;
+    profile.maxOpenFiles = 100;
+    profile.blockCacheSize = std::max<int64_t>(0, gArgs.GetArg("-pocketdbcache", DEFAULT_POCKETDB_CACHE)) << 20;
+    profile.sharedBlockCache = true;
+    profile.bloomBitsPerKey = 10;
+    return profile;
+}
+
+static const std::map<std::string, datastorage::StorageProfile(*)()> POCKETDB_STORAGE_PROFILES = {
+    { "UTXO", &StorageProfileWrite },
+    { "Scores", &StorageProfileWrite },
+    { "UserRatings", &StorageProfileWrite },
+    { "PostRatings", &StorageProfileWrite },
+    { "CommentRatings", &StorageProfileWrite },
+    { "CommentScores", &StorageProfileWrite },
+    { "Lottery", &StorageProfileWrite },
+    { "Posts", &StorageProfileRead },
+    { "UsersView", &StorageProfileRead },
+    { "Comment", &StorageProfileRead },
+    { "SubscribesView", &StorageProfileRead },
+};
+
+void PocketDB::ConfigureStorage(std::string table)
+{
+    bool sync = gArgs.GetBoolArg("-pocketdbsync", DEFAULT_POCKETDB_SYNC);
+    for (auto& it : POCKETDB_STORAGE_PROFILES) {
+        if (table != "ALL" && table != it.first) continue;
+
+        datastorage::StorageProfile profile = it.second();
+        profile.syncWrites = sync;
+        db->SetStorageProfile(it.first, profile);
+    }
+}
+
+// Cache profiles
+// Feed and comment RPCs join Posts, Comment and CommentScores. Caches of these namespaces are pinned:
+// values are stored at first lookup and the hit threshold does not grow when blocks invalidate them.
+// Join results of every joined item are cached too (CacheModeAggressive in InitDB).
+// -pocketdbidsetcache and -pocketdbjoincache are limits of each of these namespaces, defaults are above
+// reindexer ones. Other namespaces keep default reindexer cache limits.
+static const std::set<std::string> POCKETDB_PINNED_CACHES = { "Posts", "Comment", "CommentScores" };
+
+CacheProfile PocketDB::DefaultCacheProfile(std::string table)
+{
+    CacheProfile profile;
+    if (!POCKETDB_PINNED_CACHES.count(table)) return profile;
+
+    int64_t idsetCache = std::max<int64_t>(0, gArgs.GetArg("-pocketdbidsetcache", DEFAULT_POCKETDB_IDSET_CACHE));
+    int64_t joinCache = std::max<int64_t>(0, gArgs.GetArg("-pocketdbjoincache", DEFAULT_POCKETDB_JOIN_CACHE));
+    profile.idsetCacheSize = idsetCache << 20;
+    profile.joinCacheSize = joinCache << 20;
+    profile.hitCountToCache = 1;
+    profile.pinned = true;
+    return profile;
+}
+
+void PocketDB::ConfigureCaches(std::string table)
+{
+    for (auto& it : POCKETDB_PINNED_CACHES) {
+        if (table != "ALL" && table != it) continue;
+        db->SetCacheProfile(it, DefaultCacheProfile(it));
+    }
+}
+
+bool PocketDB::SetCacheProfile(std::string table, const CacheProfile& profile)
+{
+    Error err = db->SetCacheProfile(table, profile);
+    if (!err.ok()) LogPrintf("Error set Reindexer DB cache profile (%s) - %s\n", table, err.what());
+    return err.ok();
+}
+
+bool PocketDB::WarmCaches(std::string table)
+{
+    // Shapes of joins issued by comment RPCs, prepared result of joined query does not depend on main query.
+    // Joins filtered by address of requester are left to first request.
+    static const std::map<std::string, std::function<Query()>> hotJoins = {
+        { "Comment", []() { return Query("Comment").Where("last", CondEq, true).InnerJoin("otxid", "txid", CondEq, Query("Comment").Limit(1)).Limit(1); } },
+    };
+
+    bool ret = true;
+    for (auto& it : hotJoins) {
+        if (table != "ALL" && table != it.first) continue;
+
+        // Value is stored after number of lookups required by cache profile
+        int hits = DefaultCacheProfile(it.first).hitCountToCache;
+        for (int i = 0; i < hits; i++) {
+            QueryResults res;
+            Error err = db->Select(it.second(), res);
+            if (!err.ok()) {
+                LogPrintf("Error warm Reindexer DB caches (%s) - %s\n", it.first, err.what());
+                ret = false;
+                break;
+            }
+        }
+    }
+    return ret;
+}
+
 bool PocketDB::Init()
 {
     Error err;
+
+    // Existing namespaces are opened by Connect
+    ConfigureStorage();
+    ConfigureCaches();
+
     err = db->Connect("builtin://" + (GetDataDir() / "pocketdb").string());
     if (!err.ok()) {
         LogPrintf("Error loading Reindexer DB (%s) - %s\n", (GetDataDir() / "pocketdb").string(), err.what());
@@ -58,6 +180,9 @@ bool PocketDB::Init()
     }
 
     InitDB();
+    // Once before reader threads start, DropTable recreates tables with the same layout
+    PocketField::ResolveAll(db);
+    WarmCaches();
     LogPrintf("Loaded Reindexer DB (%s)\n", (GetDataDir() / "pocketdb").string());
 
     return true;
@@ -65,6 +190,9 @@ bool PocketDB::Init()
 
 bool PocketDB::InitDB(std::string table)
 {
+    ConfigureStorage(table);
+    ConfigureCaches(table);
+
 	// RI Mempool
     if (table == "Mempool" || table == "ALL") {
         db->OpenNamespace("Mempool", StorageOpts().Enabled().CreateIfMissing());
@@ -132,17 +260,9 @@ bool PocketDB::InitDB(std::string table)
         db->Commit("UserRatings");
     }
 
-    // Tags
-    if (table == "Tags" || table == "ALL") {
-        db->OpenNamespace("Tags", StorageOpts().Enabled().CreateIfMissing());
-        db->AddIndex("Tags", {"tag", "text", "string", IndexOpts().SetCollateMode(CollateUTF8).PK()});
-        db->AddIndex("Tags", {"rating", "tree", "int", IndexOpts()});
-        db->Commit("Tags");
-    }
-
     // Posts
     if (table == "Posts" || table == "ALL") {
-        db->OpenNamespace("Posts", StorageOpts().Enabled().CreateIfMissing());
+        db->OpenNamespace("Posts", StorageOpts().Enabled().CreateIfMissing(), CacheModeAggressive);
         db->AddIndex("Posts", {"txid", "hash", "string", IndexOpts().PK()});
         db->AddIndex("Posts", {"txidEdit", "hash", "string", IndexOpts()});
         db->AddIndex("Posts", {"block", "tree", "int", IndexOpts()});
@@ -334,7 +454,7 @@ bool PocketDB::InitDB(std::string table)
 
     // Comment
     if (table == "Comment" || table == "ALL") {
-        db->OpenNamespace("Comment", StorageOpts().Enabled().CreateIfMissing());
+        db->OpenNamespace("Comment", StorageOpts().Enabled().CreateIfMissing(), CacheModeAggressive);
         db->AddIndex("Comment", {"txid", "hash", "string", IndexOpts().PK()});
         db->AddIndex("Comment", {"otxid", "hash", "string", IndexOpts()});
         db->AddIndex("Comment", {"last", "", "bool", IndexOpts()});
@@ -365,7 +485,7 @@ bool PocketDB::InitDB(std::string table)
 
     // CommentScores
     if (table == "CommentScores" || table == "ALL") {
-        db->OpenNamespace("CommentScores", StorageOpts().Enabled().CreateIfMissing());
+        db->OpenNamespace("CommentScores", StorageOpts().Enabled().CreateIfMissing(), CacheModeAggressive);
         db->AddIndex("CommentScores", {"txid", "hash", "string", IndexOpts().PK()});
         db->AddIndex("CommentScores", {"block", "tree", "int", IndexOpts()});
         db->AddIndex("CommentScores", {"time", "tree", "int64", IndexOpts()});
@@ -376,6 +496,18 @@ bool PocketDB::InitDB(std::string table)
         db->Commit("CommentScores");
     }
 
+    // Lottery candidates of block
+    if (table == "Lottery" || table == "ALL") {
+        db->OpenNamespace("Lottery", StorageOpts().Enabled().CreateIfMissing());
+        db->AddIndex("Lottery", {"block", "tree", "int", IndexOpts().PK()});
+        db->AddIndex("Lottery", {"hash", "", "string", IndexOpts()});
+        db->AddIndex("Lottery", {"post_address", "", "string", IndexOpts().Array()});
+        db->AddIndex("Lottery", {"post_value", "", "int", IndexOpts().Array()});
+        db->AddIndex("Lottery", {"comment_address", "", "string", IndexOpts().Array()});
+        db->AddIndex("Lottery", {"comment_value", "", "int", IndexOpts().Array()});
+        db->Commit("Lottery");
+    }
+
     return true;
 }
 
@@ -460,6 +592,207 @@ bool PocketDB::GetStatistic(std::string table, UniValue& obj)
     return ret;
 }
 
+bool PocketDB::GetStorageStatistic(std::string table, UniValue& obj)
+{
+    bool ret = true;
+    std::vector<NamespaceDef> nss;
+    db->EnumNamespaces(nss, false);
+
+    for (NamespaceDef& ns : nss) {
+        if (ns.name[0] == '#') continue;
+        if (table != "" && table != ns.name) continue;
+        //--------------------------
+        datastorage::StorageStat stat;
+        Error err = db->GetStorageStat(ns.name, stat);
+        ret = ret && err.ok();
+        if (!err.ok()) continue;
+
+        UniValue nsStat(UniValue::VOBJ);
+        nsStat.pushKV("approximate_size", (uint64_t)stat.approximateSize);
+        nsStat.pushKV("stats", stat.stats);
+        obj.pushKV(ns.name, nsStat);
+    }
+
+    return ret;
+}
+
+bool PocketDB::CompactStorage(std::string table)
+{
+    Error err = db->CompactStorage(table);
+    if (!err.ok()) LogPrintf("Error compact Reindexer DB storage (%s) - %s\n", table, err.what());
+    return err.ok();
+}
+
+bool PocketDB::SetProfiling(bool enable, int64_t thresholdUs)
+{
+    Item item = db->NewItem("#config");
+    if (!item.Status().ok()) return false;
+
+    // Memory statistics are cheap and always enabled
+    Error err = item.FromJSON(strprintf(
+        "{\"type\":\"profiling\",\"profiling\":{\"queriesperfstats\":%s,\"queries_threshold_us\":%d,\"perfstats\":%s,\"memstats\":true}}",
+        enable ? "true" : "false", thresholdUs, enable ? "true" : "false"));
+    if (err.ok()) err = db->Upsert("#config", item);
+
+    if (!err.ok()) LogPrintf("Error set Reindexer DB profiling - %s\n", err.what());
+    return err.ok();
+}
+
+// Read JSON of all items of system namespace
+static bool SelectSystemItems(Reindexer* db, reindexer::Query query, std::vector<UniValue>& items)
+{
+    QueryResults res;
+    Error err = db->Select(query, res);
+    if (!err.ok()) return false;
+
+    for (auto& it : res) {
+        UniValue item;
+        if (item.read(it.GetItem().GetJSON().ToString())) items.push_back(item);
+    }
+    return true;
+}
+
+static int64_t GetInt(const UniValue& obj, const std::string& key)
+{
+    const UniValue& value = find_value(obj, key);
+    return value.isNum() ? value.get_int64() : 0;
+}
+
+static void PushCacheStat(UniValue& obj, const std::string& name, int64_t items, int64_t size, int64_t limit, int64_t hitCount, int64_t hits, int64_t misses)
+{
+    UniValue cache(UniValue::VOBJ);
+    cache.pushKV("items", items);
+    cache.pushKV("size", size);
+    cache.pushKV("limit", limit);
+    cache.pushKV("hit_count_limit", hitCount);
+    cache.pushKV("hits", hits);
+    cache.pushKV("misses", misses);
+    cache.pushKV("hit_rate", hits + misses > 0 ? (double)hits / (hits + misses) : 0.0);
+    obj.pushKV(name, cache);
+}
+
+static void PushCacheStat(UniValue& obj, const std::string& name, const UniValue& cache)
+{
+    PushCacheStat(obj, name, GetInt(cache, "items_count"), GetInt(cache, "total_size"), GetInt(cache, "size_limit"),
+        GetInt(cache, "hit_count_limit"), GetInt(cache, "hits"), GetInt(cache, "misses"));
+}
+
+static UniValue GetLatencyStat(const UniValue& perf)
+{
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("count", GetInt(perf, "total_queries_count"));
+    result.pushKV("avg_us", GetInt(perf, "total_avg_latency_us"));
+    result.pushKV("avg_lock_us", GetInt(perf, "total_avg_lock_time_us"));
+    result.pushKV("last_sec_qps", GetInt(perf, "last_sec_qps"));
+    result.pushKV("last_sec_avg_us", GetInt(perf, "last_sec_avg_latency_us"));
+    return result;
+}
+
+bool PocketDB::GetPerfStatistic(std::string table, int top, UniValue& obj)
+{
+    std::vector<UniValue> config;
+    if (!SelectSystemItems(db, reindexer::Query("#config").Where("type", CondEq, "profiling"), config)) return false;
+    bool enabled = false;
+    if (!config.empty()) {
+        const UniValue& profiling = find_value(config[0], "profiling");
+        enabled = find_value(profiling, "perfstats").isTrue();
+        obj.pushKV("enabled", enabled);
+        obj.pushKV("threshold_us", GetInt(profiling, "queries_threshold_us"));
+    }
+
+    // Namespaces
+    std::vector<UniValue> memStats, perfStats;
+    if (!SelectSystemItems(db, reindexer::Query("#memstats"), memStats)) return false;
+    if (enabled && !SelectSystemItems(db, reindexer::Query("#perfstats"), perfStats)) return false;
+
+    std::map<std::string, UniValue> namespaces;
+    for (const UniValue& mem : memStats) {
+        std::string name = find_value(mem, "name").get_str();
+        if (name[0] == '#') continue;
+        if (table != "" && table != name) continue;
+
+        UniValue ns(UniValue::VOBJ);
+        ns.pushKV("items", GetInt(mem, "items_count"));
+
+        const UniValue& total = find_value(mem, "total");
+        UniValue memory(UniValue::VOBJ);
+        memory.pushKV("data", GetInt(total, "data_size"));
+        memory.pushKV("indexes", GetInt(total, "indexes_size"));
+        memory.pushKV("caches", GetInt(total, "cache_size"));
+        ns.pushKV("memory", memory);
+
+        PushCacheStat(ns, "join_cache", find_value(mem, "join_cache"));
+        PushCacheStat(ns, "query_cache", find_value(mem, "query_cache"));
+
+        // Idset caches of all indexes together, limits are the same for every index
+        int64_t items = 0, size = 0, limit = 0, hitCount = 0, hits = 0, misses = 0;
+        const UniValue& indexes = find_value(mem, "indexes");
+        for (size_t i = 0; indexes.isArray() && i < indexes.size(); i++) {
+            const UniValue& cache = find_value(indexes[i], "idset_cache");
+            items += GetInt(cache, "items_count");
+            size += GetInt(cache, "total_size");
+            limit = std::max(limit, GetInt(cache, "size_limit"));
+            hitCount = std::max(hitCount, GetInt(cache, "hit_count_limit"));
+            hits += GetInt(cache, "hits");
+            misses += GetInt(cache, "misses");
+        }
+        PushCacheStat(ns, "idset_cache", items, size, limit, hitCount, hits, misses);
+
+        namespaces.emplace(name, ns);
+    }
+
+    for (const UniValue& perf : perfStats) {
+        auto ns = namespaces.find(find_value(perf, "name").get_str());
+        if (ns == namespaces.end()) continue;
+
+        ns->second.pushKV("selects", GetLatencyStat(find_value(perf, "selects")));
+        ns->second.pushKV("updates", GetLatencyStat(find_value(perf, "updates")));
+    }
+
+    UniValue nsObj(UniValue::VOBJ);
+    for (auto& ns : namespaces)
+        nsObj.pushKV(ns.first, ns.second);
+    obj.pushKV("namespaces", nsObj);
+
+    // Slowest normalized queries with plan of their slowest execution
+    std::vector<UniValue> queries;
+    if (enabled && !SelectSystemItems(db, reindexer::Query("#queriesperfstats"), queries)) return false;
+    std::sort(queries.begin(), queries.end(), [](const UniValue& a, const UniValue& b) {
+        return GetInt(a, "total_avg_latency_us") > GetInt(b, "total_avg_latency_us");
+    });
+
+    UniValue slow(UniValue::VARR);
+    for (const UniValue& query : queries) {
+        if ((int)slow.size() >= top) break;
+        std::string example = find_value(query, "example").isStr() ? find_value(query, "example").get_str() : "";
+        if (table != "" && (example + " ").find(" FROM " + table + " ") == std::string::npos) continue;
+
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("query", find_value(query, "query"));
+        entry.pushKV("stat", GetLatencyStat(query));
+        entry.pushKV("example", example);
+
+        if (!example.empty()) {
+            try {
+                reindexer::Query explainQuery;
+                explainQuery.FromSQL(example);
+                explainQuery.Explain(true);
+
+                QueryResults res;
+                UniValue explain;
+                if (db->Select(explainQuery, res).ok() && explain.read(res.GetExplainResults())) entry.pushKV("explain", explain);
+            } catch (const Error& err) {
+                entry.pushKV("explain", err.what());
+            }
+        }
+
+        slow.push_back(entry);
+    }
+    obj.pushKV("slow_queries", slow);
+
+    return true;
+}
+
 bool PocketDB::Exists(Query query)
 {
     Item _itm;
@@ -961,21 +1294,6 @@ bool PocketDB::UpdateCommentRating(std::string commentid, int height)
 }
 
 
-void PocketDB::SearchTags(std::string search, int count, std::map<std::string, int>& tags, int& totalCount)
-{
-    if (search.size() < 3) return;
-    int _count = (count > 1000 ? 1000 : count);
-
-    reindexer::QueryResults res;
-    if (g_pocketdb->Select(reindexer::Query("Tags", 0, _count).Where("tag", CondEq, (search.size() > 0 ? search : "*")), res).ok()) {
-        totalCount = res.TotalCount();
-        for (auto& it : res) {
-            Item _itm = it.GetItem();
-            tags.insert_or_assign(_itm["tag"].As<string>(), _itm["rating"].As<int>());
-        }
-    }
-}
-
 bool PocketDB::GetHashItem(Item& item, std::string table, bool with_referrer, std::string& out_hash)
 {
     std::string data = "";
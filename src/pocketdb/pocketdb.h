@@ -9,6 +9,7 @@
 #include "core/namespacedef.h"
 #include "core/type_consts.h"
 #include "tools/errors.h"
+#include "pocketdb/fields.h"
 #include "util.h"
 #include <univalue.h>
 #include <crypto/sha256.h>
@@ -19,9 +20,19 @@ using namespace reindexer;
 //-----------------------------------------------------
 #define AGGRESULT(vec, field) std::find_if(vec.begin(), vec.end(), [&](const reindexer::AggregationResult &agg) { return agg.name == field; })[0].value
 //-----------------------------------------------------
+static const int64_t DEFAULT_POCKETDB_CACHE = 32;
+static const bool DEFAULT_POCKETDB_SYNC = false;
+static const int64_t DEFAULT_POCKETDB_IDSET_CACHE = 256;
+static const int64_t DEFAULT_POCKETDB_JOIN_CACHE = 512;
+//-----------------------------------------------------
 class PocketDB {
 private:
     Reindexer* db = new Reindexer();
+
+    // Set LevelDB storage profiles for namespaces before they are opened
+    void ConfigureStorage(std::string table = "ALL");
+    // Set sizes of idset and join caches for namespaces
+    void ConfigureCaches(std::string table = "ALL");
 	
 public:
 	PocketDB();
@@ -37,6 +48,18 @@ public:
 
 	// Statistics for DB
 	bool GetStatistic(std::string table, UniValue& obj);
+	// LevelDB storage statistics for namespace or for all namespaces
+	bool GetStorageStatistic(std::string table, UniValue& obj);
+	bool CompactStorage(std::string table);
+	// Cache profile from node options
+	CacheProfile DefaultCacheProfile(std::string table);
+	bool SetCacheProfile(std::string table, const CacheProfile& profile);
+	// Run hot join queries of namespace so their prepared results are cached before first request
+	bool WarmCaches(std::string table = "ALL");
+	// Enable or disable Reindexer perf counters and statistics of slow queries
+	bool SetProfiling(bool enable, int64_t thresholdUs);
+	// Memory, latency, cache and slow query statistics of Reindexer
+	bool GetPerfStatistic(std::string table, int top, UniValue& obj);
 
 	bool Exists(Query query);
 	size_t SelectTotalCount(std::string table);
@@ -87,7 +110,6 @@ public:
 	int64_t GetUserBalance(std::string _address, int height);
 
     // Search tags in DB
-    void SearchTags(std::string search, int count, std::map<std::string, int>& tags, int& totalCount);
 
     // Add new Post with move old version to history table
     Error CommitPostItem(Item& itm);
@@ -12,6 +12,9 @@
 #include <primitives/block.h>
 #include <wallet/wallet.h>
 #include <utiltime.h>
+#include <crypto/common.h>
+#include <hash.h>
+#include <limitedmap.h>
 #include <consensus/validation.h>
 #include <index/addrindex.h>
 #include <antibot/antibot.h>
@@ -50,13 +53,24 @@ double GetPoWMHashPS() {
 }
 
 double GetPoSKernelPS() {
-	int nPoSInterval = 72;
+	int nPoSInterval = POS_KERNEL_PS_INTERVAL;
 	double dStakeKernelsTriedAvg = 0;
 	int nStakesHandled = 0, nStakesTime = 0;
 
 	CBlockIndex* pindex = chainActive.Tip();
 	CBlockIndex* pindexPrevStake = NULL;
 
+	if (pindex && pindex->HasStakeIndex()) {
+		// Window sums are differences of chain accumulators
+		const CBlockIndex* pindexNewest = pindex->pindexLastStake;
+		const CBlockIndex* pindexOldest = pindex->pindexStakeWindow;
+		if (pindexNewest && pindexOldest) {
+			dStakeKernelsTriedAvg = (pindexNewest->dChainStakeDifficulty - pindexOldest->dChainStakeDifficulty) * 4294967296.0;
+			nStakesTime = pindexNewest->nTime - pindexOldest->nTime;
+		}
+		pindex = nullptr;
+	}
+
 	while (pindex && nStakesHandled < nPoSInterval) {
 		if (pindex->IsProofOfStake()) {
 			if (pindexPrevStake) {
@@ -81,6 +95,40 @@ double GetPoSKernelPS() {
 	return result;
 }
 
+void BuildStakeIndex(CBlockIndex* pindex) {
+	const CBlockIndex* pprev = pindex->pprev;
+	if (pprev && !pprev->HasStakeIndex()) {
+		return;
+	}
+
+	pindex->pindexLastStake = pindex->IsProofOfStake() ? pindex : (pprev ? pprev->pindexLastStake : nullptr);
+	pindex->pindexLastWork = pindex->IsProofOfWork() ? pindex : (pprev ? pprev->pindexLastWork : nullptr);
+	pindex->pindexLastModifier = (pindex->GeneratedStakeModifier() || !pprev) ? pindex : pprev->pindexLastModifier;
+	pindex->pindexStakeWindow = pprev ? pprev->pindexStakeWindow : nullptr;
+	pindex->nChainStakeBlocks = pprev ? pprev->nChainStakeBlocks : 0;
+	pindex->dChainStakeDifficulty = pprev ? pprev->dChainStakeDifficulty : 0;
+
+	if (pindex->IsProofOfStake()) {
+		pindex->nChainStakeBlocks++;
+		pindex->dChainStakeDifficulty += GetPosDifficulty(pindex);
+
+		// Window holds at most POS_KERNEL_PS_INTERVAL pairs of blocks,
+		// once full its oldest block moves to the next proof-of-stake block
+		const CBlockIndex* pindexWindow = pindex->pindexStakeWindow;
+		if (!pindexWindow) {
+			pindexWindow = pindex;
+		}
+		else if (pindex->nChainStakeBlocks - pindexWindow->nChainStakeBlocks > (unsigned int)POS_KERNEL_PS_INTERVAL) {
+			int nHeight = pindexWindow->nHeight + 1;
+			while (!pindex->GetAncestor(nHeight)->IsProofOfStake()) {
+				nHeight++;
+			}
+			pindexWindow = pindex->GetAncestor(nHeight);
+		}
+		pindex->pindexStakeWindow = pindexWindow;
+	}
+}
+
 int64_t GetProofOfStakeReward(int nHeight, int64_t nFees, const Consensus::Params & consensusParams) {
 	int halvings = nHeight / consensusParams.nSubsidyHalvingInterval;
 	// Force block reward to zero when right shift is undefined.
@@ -112,8 +160,11 @@ bool CheckStake(const std::shared_ptr<CBlock> pblock, std::shared_ptr<CWallet> w
 
 	// verify hash target and signature of coinstake tx
 	CDataStream hashProofOfStakeSource(SER_GETHASH, 0);
-	if (!CheckProofOfStake(mapBlockIndex[pblock->hashPrevBlock], pblock->vtx[1], pblock->nBits, proofHash, hashProofOfStakeSource, hashTarget, NULL)) {
-		return error("CheckStake() : proof-of-stake checking failed (%s)", pblock->hashPrevBlock.GetHex());
+	{
+		LOCK(cs_main);
+		if (!CheckProofOfStake(mapBlockIndex[pblock->hashPrevBlock], pblock->vtx[1], *pcoinsTip, pblock->nBits, proofHash, hashProofOfStakeSource, hashTarget, NULL)) {
+			return error("CheckStake() : proof-of-stake checking failed (%s)", pblock->hashPrevBlock.GetHex());
+		}
 	}
 
 	//// debug print
@@ -141,7 +192,53 @@ bool CheckStake(const std::shared_ptr<CBlock> pblock, std::shared_ptr<CWallet> w
 	return true;
 }
 
-bool CheckProofOfStake(CBlockIndex* pindexPrev, CTransactionRef const & tx, unsigned int nBits, arith_uint256& hashProofOfStake, CDataStream& hashProofOfStakeSource, arith_uint256& targetProofOfStake, std::vector<CScriptCheck> *pvChecks, bool fCheckSignature) {
+/** Times of recently connected transactions by txid, oldest are evicted first. Guarded by cs_main */
+static limitedmap<uint256, unsigned int> mapStakeTxTime(STAKE_TX_TIME_CACHE_SIZE);
+
+void AddStakeTxTimes(const CBlock& block) {
+	AssertLockHeld(cs_main);
+	for (const auto& tx : block.vtx) {
+		if (!tx->vout.empty()) {
+			mapStakeTxTime.insert(std::make_pair(tx->GetHash(), tx->nTime));
+		}
+	}
+}
+
+/** Kernel inputs of unspent prevout from the coins view and the chain of pindexPrev */
+static bool GetStakeCandidate(CBlockIndex* pindexPrev, const CCoinsViewCache& view, const COutPoint& prevout, CStakeCandidate& candidate) {
+	AssertLockHeld(cs_main);
+
+	const Coin& coin = view.AccessCoin(prevout);
+	if (coin.IsSpent() || (int)coin.nHeight > pindexPrev->nHeight) {
+		return false;
+	}
+
+	CBlockIndex* pindexFrom = pindexPrev->GetAncestor(coin.nHeight);
+	if (!pindexFrom) {
+		return false;
+	}
+
+	unsigned int nTimeTxPrev;
+	auto it = mapStakeTxTime.find(prevout.hash);
+	if (it != mapStakeTxTime.end()) {
+		nTimeTxPrev = it->second;
+	}
+	else {
+		// Not connected since startup, read only the block holding it
+		CTransactionRef txPrev;
+		uint256 hashBlock;
+		if (!GetTransaction(prevout.hash, txPrev, Params().GetConsensus(), hashBlock, true, pindexFrom)) {
+			return false;
+		}
+		nTimeTxPrev = txPrev->nTime;
+		mapStakeTxTime.insert(std::make_pair(prevout.hash, nTimeTxPrev));
+	}
+
+	candidate = CStakeCandidate{prevout, coin.out.nValue, (unsigned int)pindexFrom->GetBlockTime(), nTimeTxPrev, pindexFrom->GetBlockHash()};
+	return true;
+}
+
+bool CheckProofOfStake(CBlockIndex* pindexPrev, CTransactionRef const & tx, const CCoinsViewCache& view, unsigned int nBits, arith_uint256& hashProofOfStake, CDataStream& hashProofOfStakeSource, arith_uint256& targetProofOfStake, std::vector<CScriptCheck> *pvChecks, bool fCheckSignature) {
 	if (!tx->IsCoinStake()) {
 		return error("CheckProofOfStake() : called on non-coinstake %s", tx->GetHash().ToString());
 	}
@@ -149,9 +246,8 @@ bool CheckProofOfStake(CBlockIndex* pindexPrev, CTransactionRef const & tx, unsi
 	// Kernel (input 0) must match the stake hash target per coin age (nBits)
 	const CTxIn& txin = tx->vin[0];
 
-	CTransactionRef txPrev;
-	uint256 hashBlock = uint256();
-	if (!GetTransaction(txin.prevout.hash, txPrev, Params().GetConsensus(), hashBlock, true)) {
+	CStakeCandidate candidate;
+	if (!GetStakeCandidate(pindexPrev, view, txin.prevout, candidate)) {
 		return error("CheckProofOfStake() : INFO: read txPrev failed %s", txin.prevout.hash.GetHex());  // previous transaction not in main chain, may occur during initial download
 	}
 
@@ -162,12 +258,10 @@ bool CheckProofOfStake(CBlockIndex* pindexPrev, CTransactionRef const & tx, unsi
 	if (fCheckSignature) {
 		const CTransaction & txn = *tx;
 		PrecomputedTransactionData txdata(txn);
-		const COutPoint &prevout = tx->vin[0].prevout;
-		const Coin* coins = &pcoinsTip->AccessCoin(prevout);
-		assert(coins);
+		const Coin& coin = view.AccessCoin(txin.prevout);
 
 		// Verify signature
-		CScriptCheck check(coins->out, *tx, 0, SCRIPT_VERIFY_NONE, false, &txdata);
+		CScriptCheck check(coin.out, *tx, 0, SCRIPT_VERIFY_NONE, false, &txdata);
 		if (pvChecks) {
 			pvChecks->push_back(CScriptCheck());
 			check.swap(pvChecks->back());
@@ -177,17 +271,7 @@ bool CheckProofOfStake(CBlockIndex* pindexPrev, CTransactionRef const & tx, unsi
 		}
 	}
 
-	if (mapBlockIndex.count(hashBlock) == 0) {
-		return error("CheckProofOfStake() : read block failed"); // unable to read block of previous transaction
-	}
-
-	CBlockIndex* pblockindex = mapBlockIndex[hashBlock];
-
-	if (txin.prevout.hash != txPrev->GetHash()) {
-		return error("CheckProofOfStake(): Coinstake input does not match previous output %s", txin.prevout.hash.GetHex());
-	}
-
-	if (!CheckStakeKernelHash(pindexPrev, nBits, *pblockindex, txPrev, txin.prevout, tx->nTime, hashProofOfStake, hashProofOfStakeSource, targetProofOfStake)) {
+	if (!CheckStakeKernelHash(pindexPrev, nBits, candidate, tx->nTime, hashProofOfStake, hashProofOfStakeSource, targetProofOfStake)) {
 		return error("CheckProofOfStake() : INFO: check kernel failed on coinstake %s, hashProof=%s", tx->GetHash().ToString(), hashProofOfStake.ToString()); // may occur during initial download or if behind on block chain sync
 	}
 
@@ -195,8 +279,6 @@ bool CheckProofOfStake(CBlockIndex* pindexPrev, CTransactionRef const & tx, unsi
 }
 
 bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, int64_t nTime, const COutPoint& prevout, int64_t* pBlockTime, CWallet* wallet, CDataStream& hashProofOfStakeSource) {
-	arith_uint256 hashProofOfStake, targetProofOfStake;
-
 	CTransactionRef txPrev;
 	uint256 hashBlock = uint256();
 	if (!GetTransaction(prevout.hash, txPrev, Params().GetConsensus(), hashBlock, true)) {
@@ -211,10 +293,6 @@ bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, int64_t nTime, con
 
 	CBlockIndex* pblockindex = mapBlockIndex[hashBlock];
 
-	if (pblockindex->GetBlockTime() + Params().GetConsensus().nStakeMinAge > nTime) {
-		return false;
-	}
-
 	if (pBlockTime) {
 		*pBlockTime = pblockindex->GetBlockTime();
 	}
@@ -223,15 +301,31 @@ bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, int64_t nTime, con
 		return("CheckProofOfStake(): Couldn't get Tx Index");
 	}
 
-	return CheckStakeKernelHash(pindexPrev, nBits, *pblockindex, txPrev,
-		prevout, nTime, hashProofOfStake, hashProofOfStakeSource, targetProofOfStake);
+	CStakeCandidate candidate{prevout, txPrev->vout[prevout.n].nValue, (unsigned int)pblockindex->GetBlockTime(), txPrev->nTime, hashBlock};
+	return CheckKernel(pindexPrev, nBits, nTime, candidate, hashProofOfStakeSource);
+}
+
+bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, int64_t nTime, const CStakeCandidate& candidate, CDataStream& hashProofOfStakeSource) {
+	arith_uint256 hashProofOfStake, targetProofOfStake;
+
+	if (candidate.nTimeBlockFrom + Params().GetConsensus().nStakeMinAge > nTime) {
+		return false;
+	}
+
+	return CheckStakeKernelHash(pindexPrev, nBits, candidate, nTime, hashProofOfStake, hashProofOfStakeSource, targetProofOfStake);
 }
 
 bool CheckStakeKernelHash(CBlockIndex * pindexPrev, unsigned int nBits, CBlockIndex & blockFrom, CTransactionRef const & txPrev, COutPoint const & prevout, unsigned int nTimeTx, arith_uint256& hashProofOfStake, CDataStream& hashProofOfStakeSource, arith_uint256& targetProofOfStake, bool fPrintProofOfStake) {
+	CStakeCandidate candidate{prevout, txPrev->vout[prevout.n].nValue, (unsigned int)blockFrom.GetBlockTime(), txPrev->nTime, blockFrom.GetBlockHash()};
+	return CheckStakeKernelHash(pindexPrev, nBits, candidate, nTimeTx, hashProofOfStake, hashProofOfStakeSource, targetProofOfStake, fPrintProofOfStake);
+}
+
+bool CheckStakeKernelHash(CBlockIndex * pindexPrev, unsigned int nBits, const CStakeCandidate& candidate, unsigned int nTimeTx, arith_uint256& hashProofOfStake, CDataStream& hashProofOfStakeSource, arith_uint256& targetProofOfStake, bool fPrintProofOfStake) {
 
-	unsigned int nTimeBlockFrom = blockFrom.GetBlockTime();
+	unsigned int nTimeBlockFrom = candidate.nTimeBlockFrom;
+	const COutPoint& prevout = candidate.prevout;
 
-	if (nTimeTx < txPrev->nTime) {
+	if (nTimeTx < candidate.nTimeTxPrev) {
 		LogPrintf(" === ERROR: CheckStakeKernelHash() : nTime violation");
 		return error("CheckStakeKernelHash() : nTime violation");
 	}
@@ -247,7 +341,7 @@ bool CheckStakeKernelHash(CBlockIndex * pindexPrev, unsigned int nBits, CBlockIn
 	bnTarget.SetCompact(nBits);
 
 	// Weighted target
-	int64_t nValueIn = txPrev->vout[prevout.n].nValue;
+	int64_t nValueIn = candidate.nValue;
 	arith_uint256 bnWeight = std::min(
 		nValueIn, Params().GetConsensus().nStakeMaximumThreshold
 	);
@@ -261,7 +355,7 @@ bool CheckStakeKernelHash(CBlockIndex * pindexPrev, unsigned int nBits, CBlockIn
 
 	// Calculate hash
 	CDataStream ss(SER_GETHASH, 0);
-	ss << nStakeModifier << nTimeBlockFrom << txPrev->nTime << prevout.hash << prevout.n << nTimeTx;
+	ss << nStakeModifier << nTimeBlockFrom << candidate.nTimeTxPrev << prevout.hash << prevout.n << nTimeTx;
 	hashProofOfStakeSource = ss;
 	hashProofOfStake = UintToArith256(Hash(ss.begin(), ss.end()));
 
@@ -273,7 +367,7 @@ bool CheckStakeKernelHash(CBlockIndex * pindexPrev, unsigned int nBits, CBlockIn
 		//    FormatISO8601DateTime(nTimeBlockFrom));
 		//LogPrintf("CheckStakeKernelHash() : check modifier=0x%016x nTimeBlockFrom=%u nTimeTxPrev=%u nPrevout=%u nTimeTx=%u hashProof=%s bnTarget=%s nBits=%08x nValueIn=%d bnWeight=%s\n",
 		//    nStakeModifier,
-		//    nTimeBlockFrom, txPrev->nTime, prevout.n, nTimeTx,
+		//    nTimeBlockFrom, candidate.nTimeTxPrev, prevout.n, nTimeTx,
 		//    hashProofOfStake.ToString(),bnTarget.ToString(), nBits, nValueIn,bnWeight.ToString());
 	}
 
@@ -290,13 +384,43 @@ bool CheckStakeKernelHash(CBlockIndex * pindexPrev, unsigned int nBits, CBlockIn
 			FormatISO8601DateTime(nTimeBlockFrom));
 		LogPrintf("CheckStakeKernelHash() : pass modifier=0x%016x nTimeBlockFrom=%u nTimeTxPrev=%u nPrevout=%u nTimeTx=%u hashProof=%s\n",
 			nStakeModifier,
-			nTimeBlockFrom, txPrev->nTime, prevout.n, nTimeTx,
+			nTimeBlockFrom, candidate.nTimeTxPrev, prevout.n, nTimeTx,
 			hashProofOfStake.ToString());
 	}
 
 	return true;
 }
 
+CStakeKernelHasher::CStakeKernelHasher(const CBlockIndex* pindexPrev, unsigned int nBits, const CStakeCandidate& candidateIn) : candidate(candidateIn)
+{
+	bnTarget.SetCompact(nBits);
+	bnTarget *= arith_uint256(std::min(candidate.nValue, Params().GetConsensus().nStakeMaximumThreshold));
+
+	CDataStream ss(SER_GETHASH, 0);
+	ss << pindexPrev->nStakeModifier << candidate.nTimeBlockFrom << candidate.nTimeTxPrev << candidate.prevout.hash << candidate.prevout.n << (unsigned int)0;
+	assert(ss.size() == KERNEL_SIZE);
+	memcpy(kernel, ss.data(), KERNEL_SIZE);
+}
+
+bool CStakeKernelHasher::Check(unsigned int nTimeTx)
+{
+	if (nTimeTx < candidate.nTimeTxPrev || candidate.nTimeBlockFrom + Params().GetConsensus().nStakeMinAge > nTimeTx) {
+		return false;
+	}
+
+	uint256 hash;
+	WriteLE32(kernel + KERNEL_SIZE - 4, nTimeTx);
+	CHash256().Write(kernel, KERNEL_SIZE).Finalize(hash.begin());
+	return UintToArith256(hash) <= bnTarget;
+}
+
+CDataStream CStakeKernelHasher::GetSource(unsigned int nTimeTx) const
+{
+	CDataStream ss((const char*)kernel, (const char*)kernel + KERNEL_SIZE - 4, SER_GETHASH, 0);
+	ss << nTimeTx;
+	return ss;
+}
+
 // Check whether the coinstake timestamp meets protocol
 bool CheckCoinStakeTimestamp(int nHeight, int64_t nTimeBlock, int64_t nTimeTx)
 {
@@ -342,7 +466,7 @@ bool ComputeNextStakeModifier(const CBlockIndex* pindexPrev, uint64_t& nStakeMod
 	}
 
 	// Sort candidate blocks by timestamp
-	std::vector<std::pair<int64_t, uint256> > vSortedByTimestamp;
+	std::vector<CStakeModifierCandidate> vSortedByTimestamp;
 	vSortedByTimestamp.reserve(64 * Params().GetConsensus().nModifierInterval / GetTargetSpacing(pindexPrev->nHeight));
 	int64_t nSelectionInterval = GetStakeModifierSelectionInterval();
 	int64_t nSelectionIntervalStart = (pindexPrev->GetBlockTime() / Params().GetConsensus().nModifierInterval)
@@ -352,29 +476,41 @@ bool ComputeNextStakeModifier(const CBlockIndex* pindexPrev, uint64_t& nStakeMod
 	const CBlockIndex* pindex = pindexPrev;
 	while (pindex && pindex->GetBlockTime() >= nSelectionIntervalStart)
 	{
-		vSortedByTimestamp.push_back(std::make_pair(pindex->GetBlockTime(), pindex->GetBlockHash()));
+		// compute the selection hash by hashing its proof-hash and the
+		// previous proof-of-stake modifier
+		CDataStream ss(SER_GETHASH, 0);
+		ss << ArithToUint256(pindex->hashProof) << nStakeModifier;
+		uint256 hashSelection = Hash(ss.begin(), ss.end());
+
+		// the selection hash is divided by 2**32 so that proof-of-stake block
+		// is always favored over proof-of-work block. this is to preserve
+		// the energy efficiency property
+		if (pindex->IsProofOfStake()) {
+			hashSelection = ArithToUint256(UintToArith256(hashSelection) >> 32);
+		}
+
+		vSortedByTimestamp.push_back(CStakeModifierCandidate{pindex->GetBlockTime(), pindex->GetBlockHash(), pindex, hashSelection, false});
 		pindex = pindex->pprev;
 	}
 	int nHeightFirstCandidate = pindex ? (pindex->nHeight + 1) : 0;
 	std::reverse(vSortedByTimestamp.begin(), vSortedByTimestamp.end());
-	std::sort(vSortedByTimestamp.begin(), vSortedByTimestamp.end());
+	std::sort(vSortedByTimestamp.begin(), vSortedByTimestamp.end(), [](const CStakeModifierCandidate& a, const CStakeModifierCandidate& b) {
+		return std::make_pair(a.nTime, a.hashBlock) < std::make_pair(b.nTime, b.hashBlock);
+	});
 
 	// Select 64 blocks from candidate blocks to generate stake modifier
 	uint64_t nStakeModifierNew = 0;
 	int64_t nSelectionIntervalStop = nSelectionIntervalStart;
-	std::map<uint256, const CBlockIndex*> mapSelectedBlocks;
 	for (int nRound = 0; nRound < std::min(64, (int)vSortedByTimestamp.size()); nRound++)
 	{
 		// add an interval section to the current selection round
 		nSelectionIntervalStop += GetStakeModifierSelectionIntervalSection(nRound);
 		// select a block from the candidates of current round
-		if (!SelectBlockFromCandidates(vSortedByTimestamp, mapSelectedBlocks, nSelectionIntervalStop, nStakeModifier, &pindex)) {
+		if (!SelectBlockFromCandidates(vSortedByTimestamp, nSelectionIntervalStop, &pindex)) {
 			return error("ComputeNextStakeModifier: unable to select block at round %d", nRound);
 		}
 		// write the entropy bit of the selected block
 		nStakeModifierNew |= (((uint64_t)pindex->GetStakeEntropyBit()) << nRound);
-		// add the selected block from candidates to selected list
-		mapSelectedBlocks.insert(std::make_pair(pindex->GetBlockHash(), pindex));
 		//        LogPrint("stakemodifier", "ComputeNextStakeModifier: selected round %d stop=%s height=%d bit=%d\n", nRound, DateTimeStrFormat("%Y-%m-%d %H:%M:%S", nSelectionIntervalStop), pindex->nHeight, pindex->GetStakeEntropyBit());
 	}
 
@@ -392,10 +528,11 @@ bool ComputeNextStakeModifier(const CBlockIndex* pindexPrev, uint64_t& nStakeMod
 			}
 			pindex = pindex->pprev;
 		}
-		for (auto & item : mapSelectedBlocks) {
+		for (auto & item : vSortedByTimestamp) {
+			if (!item.fSelected) continue;
 			// 'S' indicates selected proof-of-stake blocks
 			// 'W' indicates selected proof-of-work blocks
-			strSelectionMap.replace(item.second->nHeight - nHeightFirstCandidate, 1, item.second->IsProofOfStake() ? "S" : "W");
+			strSelectionMap.replace(item.pindex->nHeight - nHeightFirstCandidate, 1, item.pindex->IsProofOfStake() ? "S" : "W");
 		}
 	}
 
@@ -409,6 +546,8 @@ static bool GetLastStakeModifier(const CBlockIndex* pindex, uint64_t& nStakeModi
 {
 	if (!pindex)
 		return error("GetLastStakeModifier: null pindex");
+	if (pindex->HasStakeIndex())
+		pindex = pindex->pindexLastModifier;
 	while (pindex && pindex->pprev && !pindex->GeneratedStakeModifier())
 		pindex = pindex->pprev;
 	if (!pindex->GeneratedStakeModifier()) {
@@ -438,49 +577,38 @@ static int64_t GetStakeModifierSelectionInterval()
 }
 
 // select a block from the candidate blocks in vSortedByTimestamp, excluding
-// already selected blocks in vSelectedBlocks, and with timestamp up to
-// nSelectionIntervalStop.
-static bool SelectBlockFromCandidates(std::vector<std::pair<int64_t, uint256> >& vSortedByTimestamp, std::map<uint256, const CBlockIndex*>& mapSelectedBlocks,
-	int64_t nSelectionIntervalStop, uint64_t nStakeModifierPrev, const CBlockIndex** pindexSelected)
+// already selected blocks, and with timestamp up to nSelectionIntervalStop.
+static bool SelectBlockFromCandidates(std::vector<CStakeModifierCandidate>& vSortedByTimestamp,
+	int64_t nSelectionIntervalStop, const CBlockIndex** pindexSelected)
 {
 	bool fSelected = false;
 	uint256 hashBest = uint256();
+	CStakeModifierCandidate* pcandidateSelected = nullptr;
 	*pindexSelected = (const CBlockIndex*)0;
 	for (auto & item : vSortedByTimestamp) {
-		if (!mapBlockIndex.count(item.second))
-			return error("SelectBlockFromCandidates: failed to find block index for candidate block %s", item.second.ToString());
-		const CBlockIndex* pindex = mapBlockIndex[item.second];
-		if (fSelected && pindex->GetBlockTime() > nSelectionIntervalStop) {
+		if (fSelected && item.nTime > nSelectionIntervalStop) {
 			break;
 
 		}
 
-		if (mapSelectedBlocks.count(pindex->GetBlockHash()) > 0)
+		if (item.fSelected)
 			continue;
-		// compute the selection hash by hashing its proof-hash and the
-		// previous proof-of-stake modifier
-		CDataStream ss(SER_GETHASH, 0);
-		ss << ArithToUint256(pindex->hashProof) << nStakeModifierPrev;
-		uint256 hashSelection = Hash(ss.begin(), ss.end());
-
-
-		// the selection hash is divided by 2**32 so that proof-of-stake block
-		// is always favored over proof-of-work block. this is to preserve
-		// the energy efficiency property
-		if (pindex->IsProofOfStake()) {
-			hashSelection = ArithToUint256(UintToArith256(hashSelection) >> 32);
-		}
 
-		if (fSelected && hashSelection < hashBest) {
-			hashBest = hashSelection;
-			*pindexSelected = (const CBlockIndex*)pindex;
+		if (fSelected && item.hashSelection < hashBest) {
+			hashBest = item.hashSelection;
+			pcandidateSelected = &item;
 		}
 		else if (!fSelected) {
 			fSelected = true;
-			hashBest = hashSelection;
-			*pindexSelected = (const CBlockIndex*)pindex;
+			hashBest = item.hashSelection;
+			pcandidateSelected = &item;
 		}
 	}
+	if (fSelected) {
+		// add the selected block from candidates to selected list
+		pcandidateSelected->fSelected = true;
+		*pindexSelected = pcandidateSelected->pindex;
+	}
 	return fSelected;
 }
 
@@ -532,65 +660,12 @@ bool GetRatingRewards(CAmount nCredit, std::vector<CTxOut>& results, CAmount& to
     std::map<std::string, int> allPostRatings;
     std::map<std::string, int> allCommentRatings;
 
-    CBlock blockPrev;
-    ReadBlockFromDisk(blockPrev, pindexPrev, Params().GetConsensus());
-
-    // Get all users from prev block for current lottery
-    for (const auto& tx : blockPrev.vtx) {
-        std::vector<std::string> vasm;
-        if (!g_addrindex->FindPocketNetAsmString(tx, vasm)) continue;
-        if ((vasm[1] == OR_SCORE || vasm[1] == OR_COMMENT_SCORE) && vasm.size() >= 4) {
-            std::vector<unsigned char> _data_hex = ParseHex(vasm[3]);
-            std::string _data_str(_data_hex.begin(), _data_hex.end());
-            std::vector<std::string> _data;
-            boost::split(_data, _data_str, boost::is_any_of("\t "));
-            if (_data.size() >= 2) {
-                std::string _address = _data[0];
-                int _value = std::stoi(_data[1]);
-
-                // For lottery use scores as 4=1 and 5=2 - Scores to posts
-                if (vasm[1] == OR_SCORE && (_value == 4 || _value == 5)) {
-                    // Get address of score initiator
-                    reindexer::Item _score_itm;
-                    if (!g_pocketdb->SelectOne( reindexer::Query("Scores").Where("txid", CondEq, tx->GetHash().GetHex()), _score_itm ).ok()) {
-                        LogPrintf("--- GetRatingRewards error get score: %s\n", tx->GetHash().GetHex());
-                        continue;
-                    }
-
-                    reindexer::Item _post_itm;
-                    if (!g_pocketdb->SelectOne( reindexer::Query("Posts").Where("txid", CondEq, _score_itm["posttxid"].As<string>()), _post_itm ).ok()) {
-                        LogPrintf("--- GetRatingRewards error get post: %s\n", _score_itm["posttxid"].As<string>());
-                        continue;
-                    }
-                    
-                    if (g_antibot->AllowModifyReputationOverPost(_score_itm["address"].As<string>(), _post_itm["address"].As<string>(), pindexPrev->nHeight, tx, true)) {
-                        if (allPostRatings.find(_address) == allPostRatings.end()) allPostRatings.insert(std::make_pair(_address, 0));
-                        allPostRatings[_address] += (_value - 3);
-                    }
-                }
-
-                // For lottery use scores as 1 and -1 - Scores to comments
-                if (vasm[1] == OR_COMMENT_SCORE && (_value == 1)) {
-                    // Get address of score initiator
-                    reindexer::Item _score_itm;
-                    if (!g_pocketdb->SelectOne( reindexer::Query("CommentScores").Where("txid", CondEq, tx->GetHash().GetHex()), _score_itm ).ok()) {
-                        LogPrintf("--- GetRatingRewards error get comment score: %s\n", tx->GetHash().GetHex());
-                        continue;
-                    }
-
-                    reindexer::Item _comment_itm;
-                    if (!g_pocketdb->SelectOne( reindexer::Query("Comment").Where("otxid", CondEq, _score_itm["commentid"].As<string>()), _comment_itm ).ok()) {
-                        LogPrintf("--- GetRatingRewards error get comment: %s\n", _score_itm["posttxid"].As<string>());
-                        continue;
-                    }
-                    
-                    if (g_antibot->AllowModifyReputationOverComment(_score_itm["address"].As<string>(), _comment_itm["address"].As<string>(), pindexPrev->nHeight, tx, true)) {
-                        if (allCommentRatings.find(_address) == allCommentRatings.end()) allCommentRatings.insert(std::make_pair(_address, 0));
-                        allCommentRatings[_address] += _value;
-                    }
-                }
-            }
-        }
+    // Candidates are saved when previous block is indexed,
+    // blocks indexed before that are read from disk
+    if (!g_addrindex->GetLotteryCandidates(pindexPrev, allPostRatings, allCommentRatings)) {
+        CBlock blockPrev;
+        ReadBlockFromDisk(blockPrev, pindexPrev, Params().GetConsensus());
+        g_addrindex->ComputeLotteryCandidates(blockPrev, pindexPrev, allPostRatings, allCommentRatings);
     }
 
     // Sort founded users
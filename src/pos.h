@@ -12,14 +12,38 @@ static const int STAKE_TIMESTAMP_MASK = 15;
 
 static const int MODIFIER_INTERVAL_RATIO = 3;
 
+/** Number of recent transaction times kept for kernel checks of connected blocks */
+static const size_t STAKE_TX_TIME_CACHE_SIZE = 100000;
+
 class CWallet;
 
+/** Kernel inputs of staking coin. Resolved once per coin instead of for every searched timestamp */
+struct CStakeCandidate
+{
+    COutPoint prevout;
+    CAmount nValue;
+    unsigned int nTimeBlockFrom;
+    unsigned int nTimeTxPrev;
+    /** Block containing the coin, candidate is stale if the coin moved to another block */
+    uint256 hashBlock;
+};
+
 double GetPosDifficulty(const CBlockIndex* blockindex);
 
 double GetPoWMHashPS();
 
 double GetPoSKernelPS();
 
+/** Number of proof-of-stake block pairs averaged by GetPoSKernelPS */
+static const int POS_KERNEL_PS_INTERVAL = 72;
+
+/**
+ * Fill memory-only stake fields of block from its predecessor.
+ * Called once flags and stake modifier of block are set. Blocks whose
+ * predecessor has no stake index are skipped and read by walking the chain.
+ */
+void BuildStakeIndex(CBlockIndex* pindex);
+
 static bool GetLastStakeModifier(const CBlockIndex* pindex, uint64_t& nStakeModifier, int64_t& nModifierTime);
 
 arith_uint256 GetProofOfStakeLimit(int nHeight);
@@ -34,8 +58,18 @@ static int64_t GetStakeModifierSelectionIntervalSection(int nSection);
 
 static int64_t GetStakeModifierSelectionInterval();
 
-static bool SelectBlockFromCandidates(std::vector<std::pair<int64_t, uint256> >& vSortedByTimestamp, std::map<uint256, const CBlockIndex*>& mapSelectedBlocks,
-    int64_t nSelectionIntervalStop, uint64_t nStakeModifierPrev, const CBlockIndex** pindexSelected);
+/** Candidate block of stake modifier selection. Selection hash depends only on the previous modifier, so it is computed once */
+struct CStakeModifierCandidate
+{
+    int64_t nTime;
+    uint256 hashBlock;
+    const CBlockIndex* pindex;
+    uint256 hashSelection;
+    bool fSelected;
+};
+
+static bool SelectBlockFromCandidates(std::vector<CStakeModifierCandidate>& vSortedByTimestamp,
+    int64_t nSelectionIntervalStop, const CBlockIndex** pindexSelected);
 
 int64_t GetProofOfStakeReward(int nHeight, int64_t nFees, const Consensus::Params & consensusParams);
 
@@ -43,9 +77,45 @@ int64_t GetWeight(int64_t nIntervalBeginning, int64_t nIntervalEnd);
 
 bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, int64_t nTime, const COutPoint& prevout, int64_t* pBlockTime, CWallet* wallet, CDataStream& hashProofOfStakeSource);
 
+/** Same as above without disk and block index lookups */
+bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, int64_t nTime, const CStakeCandidate& candidate, CDataStream& hashProofOfStakeSource);
+
 bool CheckStakeKernelHash(CBlockIndex* pindexPrev, unsigned int nBits, CBlockIndex& blockFrom, CTransactionRef const & txPrev, COutPoint const & prevout, unsigned int nTimeTx, arith_uint256& hashProofOfStake, CDataStream& hashProofOfStakeSource, arith_uint256& targetProofOfStake, bool fPrintProofOfStake = true);
 
-bool CheckProofOfStake(CBlockIndex* pindexPrev, CTransactionRef const & tx, unsigned int nBits, arith_uint256& hashProofOfStake, CDataStream& hashProofOfStakeSource, arith_uint256& targetProofOfStake, std::vector<CScriptCheck> *pvChecks, bool fCheckSignature = false);
+bool CheckStakeKernelHash(CBlockIndex* pindexPrev, unsigned int nBits, const CStakeCandidate& candidate, unsigned int nTimeTx, arith_uint256& hashProofOfStake, CDataStream& hashProofOfStakeSource, arith_uint256& targetProofOfStake, bool fPrintProofOfStake = true);
+
+/**
+ * Kernel check of one stake candidate for a series of timestamps.
+ * Serialized kernel differs only in the trailing nTimeTx, so it is written once
+ * and the timestamp is patched in place before hashing. Weighted target is
+ * computed once as well. Result is the same as CheckKernel.
+ */
+class CStakeKernelHasher
+{
+public:
+    static const size_t KERNEL_SIZE = 56;
+
+    CStakeKernelHasher(const CBlockIndex* pindexPrev, unsigned int nBits, const CStakeCandidate& candidate);
+
+    bool Check(unsigned int nTimeTx);
+    /** Serialized kernel for nTimeTx, source of proof-of-stake hash */
+    CDataStream GetSource(unsigned int nTimeTx) const;
+
+private:
+    CStakeCandidate candidate;
+    arith_uint256 bnTarget;
+    unsigned char kernel[KERNEL_SIZE];
+};
+
+/** Remember times of block transactions, their outputs may later be coinstake kernels */
+void AddStakeTxTimes(const CBlock& block) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+/**
+ * Kernel of coinstake is taken from the coin in `view` and the block index,
+ * time of the previous transaction from recent transaction times. Block file
+ * holding the previous transaction is read only when its time is unknown.
+ */
+bool CheckProofOfStake(CBlockIndex* pindexPrev, CTransactionRef const & tx, const CCoinsViewCache& view, unsigned int nBits, arith_uint256& hashProofOfStake, CDataStream& hashProofOfStakeSource, arith_uint256& targetProofOfStake, std::vector<CScriptCheck> *pvChecks, bool fCheckSignature = false) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
 bool CheckStake(const std::shared_ptr<CBlock> pblock, std::shared_ptr<CWallet> wallet, CChainParams const & chainparams);
 
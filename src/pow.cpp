@@ -23,6 +23,11 @@ const CBlockIndex* GetLastBlockIndex(
   bool fProofOfStake
 )
 {
+  if (pindex && pindex->HasStakeIndex()) {
+    const CBlockIndex* pindexLast = fProofOfStake ? pindex->pindexLastStake : pindex->pindexLastWork;
+    return pindexLast ? pindexLast : pindex->GetAncestor(0);
+  }
+
   while (pindex && pindex->pprev && (pindex->IsProofOfStake() != fProofOfStake)) {
     pindex = pindex->pprev;
   }
@@ -6,6 +6,7 @@
 #include "core/indexdef.h"
 #include "core/indexopts.h"
 #include "core/keyvalue/variant.h"
+#include "core/lrucache.h"
 #include "core/namespacestat.h"
 #include "core/payload/payloadiface.h"
 #include "core/perfstatcounter.h"
@@ -47,6 +48,7 @@ public:
 	virtual Index* Clone() = 0;
 	virtual bool IsOrdered() const { return false; }
 	virtual IndexMemStat GetMemStat() = 0;
+	virtual void SetCacheProfile(const CacheProfile&) {}
 	void UpdatePayloadType(const PayloadType payloadType) { payloadType_ = payloadType; }
 
 	static Index* New(const IndexDef& idef, const PayloadType payloadType, const FieldsSet& fields_);
@@ -238,6 +238,11 @@ Index *IndexUnordered<T>::Clone() {
 	return new IndexUnordered<T>(*this);
 }
 
+template <typename T>
+void IndexUnordered<T>::SetCacheProfile(const CacheProfile &profile) {
+	cache_->SetLimits(profile.idsetCacheSize, profile.hitCountToCache, profile.pinned);
+}
+
 template <typename T>
 IndexMemStat IndexUnordered<T>::GetMemStat() {
 	IndexMemStat ret = IndexStore<typename T::key_type>::GetMemStat();
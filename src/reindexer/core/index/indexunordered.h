@@ -56,6 +56,7 @@ public:
 	void UpdateSortedIds(const UpdateSortedContext &) override;
 	Index *Clone() override;
 	IndexMemStat GetMemStat() override;
+	void SetCacheProfile(const CacheProfile &profile) override;
 	size_t Size() const override final { return idx_map.size(); }
 	IdSetRef Find(const Variant &key) override final;
 	void SetSortedIdxCount(int sortedIdxCount) override {
@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include "core/ft/ftsetcashe.h"
 #include "core/idset.h"
 #include "core/idsetcache.h"
@@ -28,6 +29,11 @@ typename LRUCache<K, V, hash, equal>::Iterator LRUCache<K, V, hash, equal>::Get(
 		lru_.splice(lru_.end(), lru_, it->second.lruPos, std::next(it->second.lruPos));
 		it->second.lruPos = std::prev(lru_.end());
 	}
+	if (it->second.filled) {
+		++hits_;
+	} else {
+		++misses_;
+	}
 	if (++it->second.hitCount < hitCountToCache_) {
 		return Iterator();
 	}
@@ -48,6 +54,7 @@ void LRUCache<K, V, hash, equal>::Put(const K &key, const V &v) {
 
 	totalCacheSize_ += v.Size() - it->second.val.Size();
 	it->second.val = v;
+	it->second.filled = true;
 
 	// logPrintf(LogInfo, "IdSetCache::Put () add %d,left %d,fwdCnt=%d,sz=%d", endIt - begIt, left, it->second.fwdCount,
 	// 		  it->second.ids->size());
@@ -70,7 +77,7 @@ void LRUCache<K, V, hash, equal>::eraseLRU() {
 		++eraseCount_;
 	}
 
-	if (eraseCount_ && putCount_ * 16 > getCount_) {
+	if (!fixedHitCount_ && eraseCount_ && putCount_ * 16 > getCount_) {
 		logPrintf(LogWarning, "IdSetCache::eraseLRU () cache invalidates too fast eraseCount=%d,putCount=%d,getCount=%d", eraseCount_,
 				  putCount_, eraseCount_);
 		eraseCount_ = 0;
@@ -92,11 +99,21 @@ bool LRUCache<K, V, hash, equal>::Clear() {
 	return res;
 }
 
+template <typename K, typename V, typename hash, typename equal>
+void LRUCache<K, V, hash, equal>::SetLimits(size_t sizeLimit, int hitCount, bool fixedHitCount) {
+	std::lock_guard<mutex> lk(lock_);
+	cacheSizeLimit_ = sizeLimit;
+	hitCountToCache_ = std::max(hitCount, 1);
+	fixedHitCount_ = fixedHitCount;
+	eraseLRU();
+}
+
 template <typename K, typename V, typename hash, typename equal>
 LRUCacheMemStat LRUCache<K, V, hash, equal>::GetMemStat() {
 	std::lock_guard<mutex> lk(lock_);
 	LRUCacheMemStat ret;
 	ret.totalSize = totalCacheSize_;
+	ret.sizeLimit = cacheSizeLimit_;
 	ret.itemsCount = items_.size();
 	ret.emptyCount = 0;
 	// for (auto &item : items_) {
@@ -104,6 +121,8 @@ LRUCacheMemStat LRUCache<K, V, hash, equal>::GetMemStat() {
 	// }
 
 	ret.hitCountLimit = hitCountToCache_;
+	ret.hits = hits_;
+	ret.misses = misses_;
 
 	return ret;
 };
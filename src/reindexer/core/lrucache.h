@@ -14,6 +14,19 @@ using std::unordered_map;
 const size_t kDefaultCacheSizeLimit = 1024 * 1024 * 128;
 const int kDefaultHitCountToCache = 2;
 
+/// Size limits and admission policy of namespace caches
+struct CacheProfile {
+	/// Limit of merged idsets cache of every index in bytes
+	size_t idsetCacheSize = kDefaultCacheSizeLimit;
+	/// Limit of join cache in bytes
+	size_t joinCacheSize = kDefaultCacheSizeLimit * 2;
+	/// Number of lookups of key before its value is stored
+	int hitCountToCache = kDefaultHitCountToCache;
+	/// Keep hit count fixed. Otherwise it is doubled every time cache is invalidated faster than it is used,
+	/// and never goes back, so caches of frequently updated namespaces stop storing anything
+	bool pinned = false;
+};
+
 template <typename K, typename V, typename hash, typename equal>
 class LRUCache {
 public:
@@ -31,6 +44,9 @@ public:
 
 	LRUCacheMemStat GetMemStat();
 
+	// Change limits. Entries above new size limit are evicted
+	void SetLimits(size_t sizeLimit, int hitCount, bool fixedHitCount);
+
 	bool Clear();
 
 protected:
@@ -42,6 +58,7 @@ protected:
 		V val;
 		typename LRUList::iterator lruPos;
 		int hitCount = 0;
+		bool filled = false;
 	};
 
 	unordered_map<K, Entry, hash, equal> items_;
@@ -50,8 +67,11 @@ protected:
 	size_t totalCacheSize_;
 	size_t cacheSizeLimit_;
 	int hitCountToCache_;
+	bool fixedHitCount_ = false;
 
 	int getCount_ = 0, putCount_ = 0, eraseCount_ = 0;
+	// Lookups answered with stored value and lookups without it, never reset
+	size_t hits_ = 0, misses_ = 0;
 };
 
 }  // namespace reindexer
@@ -61,6 +61,7 @@ Namespace::Namespace(const Namespace &src)
 	  queryCache_(src.queryCache_),
 	  joinCache_(src.joinCache_),
 	  cacheMode_(src.cacheMode_),
+	  cacheProfile_(src.cacheProfile_),
 	  enablePerfCounters_(src.enablePerfCounters_.load()),
 	  queriesLogLevel_(src.queriesLogLevel_),
 	  lsnCounter_(src.lsnCounter_),
@@ -108,6 +109,7 @@ void Namespace::recreateCompositeIndexes(int startIdx, int endIdx) {
 			indexDef.FromType(index->Type());
 
 			index.reset(Index::New(indexDef, payloadType_, index->Fields()));
+			index->SetCacheProfile(cacheProfile_);
 			for (IdType rowId = 0; rowId < static_cast<int>(items_.size()); ++rowId) {
 				if (!items_[rowId].IsFree()) {
 					indexes_[i]->Upsert(Variant(items_[rowId]), rowId);
@@ -415,6 +417,7 @@ void Namespace::AddCompositeIndex(const IndexDef &indexDef) {
 }
 
 void Namespace::insertIndex(Index *newIndex, int idxNo, const string &realName) {
+	newIndex->SetCacheProfile(cacheProfile_);
 	indexes_.insert(indexes_.begin() + idxNo, unique_ptr<Index>(newIndex));
 
 	for (auto &n : indexesNames_) {
@@ -944,7 +947,7 @@ void Namespace::saveIndexesToStorage() {
 					string_view(reinterpret_cast<const char *>(ser.Buf()), ser.Len()));
 }
 
-void Namespace::EnableStorage(const string &path, StorageOpts opts) {
+void Namespace::EnableStorage(const string &path, StorageOpts opts, const datastorage::StorageProfile &profile) {
 	string dbpath = fs::JoinPath(path, name_);
 	datastorage::StorageType storageType = datastorage::StorageType::LevelDB;
 
@@ -956,7 +959,7 @@ void Namespace::EnableStorage(const string &path, StorageOpts opts) {
 	bool success = false;
 	while (!success) {
 		storage_.reset(datastorage::StorageFactory::create(storageType));
-		Error status = storage_->Open(dbpath, opts);
+		Error status = storage_->Open(dbpath, opts, profile);
 		if (!status.ok()) {
 			if (!opts.IsDropOnFileFormatError()) {
 				storage_ = nullptr;
@@ -1064,6 +1067,24 @@ void Namespace::DeleteStorage() {
 	}
 }
 
+void Namespace::GetStorageStat(datastorage::StorageStat &stat) {
+	RLock lck(mtx_);
+	if (!storage_) throw Error(errLogic, "Storage is not enabled for namespace '%s'", name_.c_str());
+	storage_->GetStat(stat);
+}
+
+void Namespace::CompactStorage() {
+	flushStorage();
+	shared_ptr<datastorage::IDataStorage> storage;
+	{
+		RLock lck(mtx_);
+		storage = storage_;
+	}
+	if (!storage) throw Error(errLogic, "Storage is not enabled for namespace '%s'", name_.c_str());
+	// Compaction may take a while, do not block writers
+	storage->Compact();
+}
+
 void Namespace::CloseStorage() {
 	flushStorage();
 	WLock lck(mtx_);
@@ -1284,6 +1305,12 @@ void Namespace::SetCacheMode(CacheMode cacheMode) {
 	needPutCacheMode_ = true;
 	cacheMode_ = cacheMode;
 }
+void Namespace::SetCacheProfile(const CacheProfile &profile) {
+	WLock lock(mtx_);
+	cacheProfile_ = profile;
+	joinCache_->SetLimits(profile.joinCacheSize, profile.hitCountToCache, profile.pinned);
+	for (auto &index : indexes_) index->SetCacheProfile(profile);
+}
 void Namespace::putCachedMode() {
 	RLock lock(cache_mtx_);
 	if (!needPutCacheMode_) return;
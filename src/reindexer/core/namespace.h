@@ -91,9 +91,11 @@ public:
 
 	const string &GetName() { return name_; }
 
-	void EnableStorage(const string &path, StorageOpts opts);
+	void EnableStorage(const string &path, StorageOpts opts, const datastorage::StorageProfile &profile = datastorage::StorageProfile());
 	void LoadFromStorage();
 	void DeleteStorage();
+	void GetStorageStat(datastorage::StorageStat &stat);
+	void CompactStorage();
 
 	void AddIndex(const IndexDef &indexDef);
 	void UpdateIndex(const IndexDef &indexDef);
@@ -114,6 +116,7 @@ public:
 	void BackgroundRoutine();
 	void CloseStorage();
 	void SetCacheMode(CacheMode cacheMode);
+	void SetCacheProfile(const CacheProfile &profile);
 
 	Item NewItem();
 	void ToPool(ItemImpl *item);
@@ -223,6 +226,7 @@ private:
 
 	JoinCache::Ptr joinCache_;
 	CacheMode cacheMode_;
+	CacheProfile cacheProfile_;
 	bool needPutCacheMode_;
 
 	PerfStatCounterMT updatePerfCounter_, selectPerfCounter_;
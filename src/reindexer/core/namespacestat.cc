@@ -37,9 +37,12 @@ void NamespaceMemStat::GetJSON(WrSerializer &ser) {
 
 void LRUCacheMemStat::GetJSON(JsonBuilder &builder) {
 	builder.Put("total_size", totalSize);
+	builder.Put("size_limit", sizeLimit);
 	builder.Put("items_count", itemsCount);
 	builder.Put("empty_count", emptyCount);
 	builder.Put("hit_count_limit", hitCountLimit);
+	builder.Put("hits", hits);
+	builder.Put("misses", misses);
 }
 
 void IndexMemStat::GetJSON(JsonBuilder &builder) {
@@ -51,7 +54,8 @@ void IndexMemStat::GetJSON(JsonBuilder &builder) {
 	if (fulltextSize) builder.Put("fulltext_size", fulltextSize);
 	if (columnSize) builder.Put("column_size", columnSize);
 
-	if (idsetCache.totalSize || idsetCache.itemsCount || idsetCache.emptyCount || idsetCache.hitCountLimit) {
+	if (idsetCache.totalSize || idsetCache.itemsCount || idsetCache.emptyCount || idsetCache.hitCountLimit || idsetCache.hits ||
+		idsetCache.misses) {
 		auto obj = builder.Object("idset_cache");
 		idsetCache.GetJSON(obj);
 	}
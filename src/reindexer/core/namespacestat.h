@@ -15,9 +15,12 @@ struct LRUCacheMemStat {
 	void GetJSON(JsonBuilder &builder);
 
 	size_t totalSize = 0;
+	size_t sizeLimit = 0;
 	size_t itemsCount = 0;
 	size_t emptyCount = 0;
 	size_t hitCountLimit = 0;
+	size_t hits = 0;
+	size_t misses = 0;
 };
 
 struct IndexMemStat {
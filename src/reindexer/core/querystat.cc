@@ -9,14 +9,25 @@ void QueriesStatTracer::Hit(const Query &q, std::chrono::microseconds time) {
 	WrSerializer ser;
 	auto sqlq = q.GetSQL(ser, true).Slice().ToString();
 	std::unique_lock<std::mutex> lck(mtx_);
-	stat_.emplace(sqlq, PerfStatCounterST()).first->second.Hit(time);
+	auto &stat = stat_[sqlq];
+	stat.perf.Hit(time);
+	if (time > stat.maxTime) {
+		lck.unlock();
+		ser.Reset();
+		auto example = q.GetSQL(ser, false).Slice().ToString();
+		lck.lock();
+		if (time > stat.maxTime) {
+			stat.maxTime = time;
+			stat.example = std::move(example);
+		}
+	}
 };
 
 void QueriesStatTracer::LockHit(const Query &q, std::chrono::microseconds time) {
 	WrSerializer ser;
 	auto sqlq = q.GetSQL(ser, true).Slice().ToString();
 	std::unique_lock<std::mutex> lck(mtx_);
-	stat_.emplace(sqlq, PerfStatCounterST()).first->second.LockHit(time);
+	stat_[sqlq].perf.LockHit(time);
 };
 
 const std::vector<QueryPerfStat> QueriesStatTracer::Data() {
@@ -24,7 +35,7 @@ const std::vector<QueryPerfStat> QueriesStatTracer::Data() {
 
 	std::vector<QueryPerfStat> ret;
 	ret.reserve(stat_.size());
-	for (auto &stat : stat_) ret.push_back({stat.first, stat.second.Get<PerfStat>()});
+	for (auto &stat : stat_) ret.push_back({stat.first, stat.second.example, stat.second.perf.Get<PerfStat>()});
 	return ret;
 }
 
@@ -32,6 +43,7 @@ void QueryPerfStat::GetJSON(WrSerializer &ser) const {
 	JsonBuilder builder(ser);
 
 	builder.Put("query", query);
+	builder.Put("example", example);
 	builder.Put("total_queries_count", perf.totalHitCount);
 	builder.Put("total_avg_lock_time_us", perf.totalLockTimeUs);
 	builder.Put("total_avg_latency_us", perf.totalTimeUs);
@@ -17,6 +17,8 @@ namespace reindexer {
 struct QueryPerfStat {
 	void GetJSON(WrSerializer &ser) const;
 	std::string query;
+	// Query with arguments of the slowest execution
+	std::string example;
 	PerfStat perf;
 };
 
@@ -27,8 +29,14 @@ public:
 	const std::vector<QueryPerfStat> Data();
 
 protected:
+	struct Stat {
+		PerfStatCounterST perf;
+		std::string example;
+		std::chrono::microseconds maxTime = std::chrono::microseconds(0);
+	};
+
 	std::mutex mtx_;
-	std::unordered_map<std::string, PerfStatCounterST> stat_;
+	std::unordered_map<std::string, Stat> stat_;
 };
 
 class QueryStatCalculator {
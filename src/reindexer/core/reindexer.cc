@@ -1,5 +1,8 @@
 #include "core/reindexer.h"
 #include "core/reindexerimpl.h"
+#include "tools/serializer.h"
+
+#include <chrono>
 
 namespace reindexer {
 
@@ -26,14 +29,42 @@ Error Reindexer::PutMeta(const string& _namespace, const string& key, const stri
 }
 Error Reindexer::EnumMeta(const string& _namespace, vector<string>& keys) { return impl_->EnumMeta(_namespace, keys); }
 Error Reindexer::Delete(const Query& q, QueryResults& result) { return impl_->Delete(q, result); }
-Error Reindexer::Select(const string_view& query, QueryResults& result, Completion cmpl) { return impl_->Select(query, result, cmpl); }
-Error Reindexer::Select(const Query& q, QueryResults& result, Completion cmpl) { return impl_->Select(q, result, cmpl); }
+
+static thread_local IQueryTracer* queryTracer = nullptr;
+
+void Reindexer::SetQueryTracer(IQueryTracer* tracer) { queryTracer = tracer; }
+
+Error Reindexer::Select(const string_view& query, QueryResults& result, Completion cmpl) {
+	if (!queryTracer) return impl_->Select(query, result, cmpl);
+
+	auto start = std::chrono::steady_clock::now();
+	Error err = impl_->Select(query, result, cmpl);
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	queryTracer->OnQuery(query, err, elapsed.count());
+	return err;
+}
+Error Reindexer::Select(const Query& q, QueryResults& result, Completion cmpl) {
+	if (!queryTracer) return impl_->Select(q, result, cmpl);
+
+	auto start = std::chrono::steady_clock::now();
+	Error err = impl_->Select(q, result, cmpl);
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	WrSerializer ser;
+	queryTracer->OnQuery(q.GetSQL(ser).Slice(), err, elapsed.count());
+	return err;
+}
 Error Reindexer::Commit(const string& _namespace) { return impl_->Commit(_namespace); }
 Error Reindexer::AddIndex(const string& _namespace, const IndexDef& idx) { return impl_->AddIndex(_namespace, idx); }
 Error Reindexer::UpdateIndex(const string& _namespace, const IndexDef& idx) { return impl_->UpdateIndex(_namespace, idx); }
 Error Reindexer::DropIndex(const string& _namespace, const string& index) { return impl_->DropIndex(_namespace, index); }
 Error Reindexer::EnumNamespaces(vector<NamespaceDef>& defs, bool bEnumAll) { return impl_->EnumNamespaces(defs, bEnumAll); }
 Error Reindexer::InitSystemNamespaces() { return impl_->InitSystemNamespaces(); }
+Error Reindexer::SetStorageProfile(const string& nsName, const datastorage::StorageProfile& profile) {
+	return impl_->SetStorageProfile(nsName, profile);
+}
+Error Reindexer::GetStorageStat(const string& nsName, datastorage::StorageStat& stat) { return impl_->GetStorageStat(nsName, stat); }
+Error Reindexer::CompactStorage(const string& nsName) { return impl_->CompactStorage(nsName); }
+Error Reindexer::SetCacheProfile(const string& nsName, const CacheProfile& profile) { return impl_->SetCacheProfile(nsName, profile); }
 Error Reindexer::SubscribeUpdates(IUpdatesObserver* observer, bool subscribe) { return impl_->SubscribeUpdates(observer, subscribe); }
 
 }  // namespace reindexer
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "core/lrucache.h"
 #include "core/namespacedef.h"
+#include "core/storage/idatastorage.h"
 #include "core/query/query.h"
 #include "core/query/queryresults.h"
 
@@ -11,6 +13,17 @@ using std::string;
 class ReindexerImpl;
 class IUpdatesObserver;
 
+/// Receives queries executed by Select in the thread it was installed for.
+/// Lets host application trace which queries were issued by a slow request.
+class IQueryTracer {
+public:
+	virtual ~IQueryTracer() = default;
+	/// @param sql - Query in SQL form
+	/// @param err - Result of query execution
+	/// @param elapsedUs - Execution time in microseconds
+	virtual void OnQuery(const string_view &sql, const Error &err, int64_t elapsedUs) = 0;
+};
+
 /// The main Reindexer interface. Holds database object<br>
 /// *Thread safety*: All methods of Reindexer are thread safe. <br>
 /// *Resources lifetime*: All resources aquired from Reindexer, e.g Item or QueryResults are uses Copy-On-Write
@@ -108,6 +121,9 @@ public:
 	/// @param result - QueryResults with found items
 	/// @param cmpl - Optional async completion routine. If nullptr function will work syncronius
 	Error Select(const Query &query, QueryResults &result, Completion cmpl = nullptr);
+	/// Install tracer of Select calls made by the current thread
+	/// @param tracer - Tracer, or nullptr to stop tracing. Caller keeps ownership
+	static void SetQueryTracer(IQueryTracer *tracer);
 	/// Flush changes to storage
 	/// @param nsName - Name of namespace
 	Error Commit(const string &nsName);
@@ -133,6 +149,24 @@ public:
 	/// Init system namepaces, and load config from config namespace
 	Error InitSystemNamespaces();
 
+	/// Set storage tuning profile for namespace. Must be called before namespace is opened, i.e. before Connect
+	/// for existing namespaces. Storage of already opened namespace keeps its profile until reopen
+	/// @param nsName - Name of namespace
+	/// @param profile - Storage tuning profile
+	Error SetStorageProfile(const string &nsName, const datastorage::StorageProfile &profile);
+	/// Get statistics of namespace storage
+	/// @param nsName - Name of namespace
+	/// @param stat - output storage statistics
+	Error GetStorageStat(const string &nsName, datastorage::StorageStat &stat);
+	/// Compact namespace storage. Blocks caller until compaction is done
+	/// @param nsName - Name of namespace
+	Error CompactStorage(const string &nsName);
+	/// Set size limits and admission policy of namespace caches. Applied to opened namespace at once
+	/// and kept for namespace opened later
+	/// @param nsName - Name of namespace
+	/// @param profile - Cache profile
+	Error SetCacheProfile(const string &nsName, const CacheProfile &profile);
+
 	// Subsribe to updates of database
 	// @param observer - Observer interface, which will receive updates
 	// @param subsctibe - true: subsribe, false: unsubsrcibe
@@ -137,8 +137,9 @@ Error ReindexerImpl::AddNamespace(const NamespaceDef& nsDef) {
 			return Error(errParams, "Namespace name contains invalid character. Only alphas, digits,'_','-, are allowed");
 		}
 		ns = std::make_shared<Namespace>(nsDef.name, nsDef.cacheMode);
+		applyCacheProfile(ns);
 		if (nsDef.storage.IsEnabled() && !storagePath_.empty()) {
-			ns->EnableStorage(storagePath_, nsDef.storage);
+			ns->EnableStorage(storagePath_, nsDef.storage, getStorageProfile(nsDef.name));
 		}
 		for (auto& indexDef : nsDef.indexes) ns->AddIndex(indexDef);
 		if (nsDef.storage.IsEnabled() && !storagePath_.empty()) {
@@ -169,8 +170,9 @@ Error ReindexerImpl::OpenNamespace(const string& name, const StorageOpts& storag
 			return Error(errParams, "Namespace name contains invalid character. Only alphas, digits,'_','-, are allowed");
 		}
 		ns = std::make_shared<Namespace>(name, cacheMode);
+		applyCacheProfile(ns);
 		if (storage.IsEnabled() && !storagePath_.empty()) {
-			ns->EnableStorage(storagePath_, storage);
+			ns->EnableStorage(storagePath_, storage, getStorageProfile(name));
 			ns->LoadFromStorage();
 		}
 		lock_guard<shared_timed_mutex> lock(mtx_);
@@ -280,6 +282,57 @@ Error ReindexerImpl::GetMeta(const string& _namespace, const string& key, string
 	return errOK;
 }
 
+Error ReindexerImpl::SetStorageProfile(const string& nsName, const datastorage::StorageProfile& profile) {
+	std::lock_guard<std::mutex> lock(storageProfilesMtx_);
+	storageProfiles_[nsName] = profile;
+	return errOK;
+}
+
+datastorage::StorageProfile ReindexerImpl::getStorageProfile(const string& nsName) {
+	std::lock_guard<std::mutex> lock(storageProfilesMtx_);
+	auto it = storageProfiles_.find(nsName);
+	return it != storageProfiles_.end() ? it->second : datastorage::StorageProfile();
+}
+
+Error ReindexerImpl::SetCacheProfile(const string& nsName, const CacheProfile& profile) {
+	{
+		std::lock_guard<std::mutex> lock(storageProfilesMtx_);
+		cacheProfiles_[nsName] = profile;
+	}
+	Namespace::Ptr ns;
+	{
+		shared_lock<shared_timed_mutex> lock(mtx_);
+		auto it = namespaces_.find(nsName);
+		if (it != namespaces_.end()) ns = it->second;
+	}
+	if (ns) ns->SetCacheProfile(profile);
+	return errOK;
+}
+
+void ReindexerImpl::applyCacheProfile(Namespace::Ptr ns) {
+	std::lock_guard<std::mutex> lock(storageProfilesMtx_);
+	auto it = cacheProfiles_.find(ns->GetName());
+	if (it != cacheProfiles_.end()) ns->SetCacheProfile(it->second);
+}
+
+Error ReindexerImpl::GetStorageStat(const string& nsName, datastorage::StorageStat& stat) {
+	try {
+		getNamespace(nsName)->GetStorageStat(stat);
+	} catch (const Error& err) {
+		return err;
+	}
+	return errOK;
+}
+
+Error ReindexerImpl::CompactStorage(const string& nsName) {
+	try {
+		getNamespace(nsName)->CompactStorage();
+	} catch (const Error& err) {
+		return err;
+	}
+	return errOK;
+}
+
 Error ReindexerImpl::PutMeta(const string& nsName, const string& key, const string_view& data) {
 	try {
 		getNamespace(nsName)->PutMeta(key, data);
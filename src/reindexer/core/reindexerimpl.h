@@ -52,6 +52,10 @@ public:
 	Error EnumMeta(const string &_namespace, vector<string> &keys);
 	Error InitSystemNamespaces();
 	Error SubscribeUpdates(IUpdatesObserver *observer, bool subscribe);
+	Error SetStorageProfile(const string &_namespace, const datastorage::StorageProfile &profile);
+	Error GetStorageStat(const string &_namespace, datastorage::StorageStat &stat);
+	Error CompactStorage(const string &_namespace);
+	Error SetCacheProfile(const string &_namespace, const CacheProfile &profile);
 
 protected:
 	class NsLocker : public h_vector<pair<Namespace::Ptr, smart_lock<shared_timed_mutex>>, 4> {
@@ -101,12 +105,19 @@ protected:
 	Namespace::Ptr getNamespace(const string &_namespace);
 	std::vector<Namespace::Ptr> getNamespaces();
 	std::vector<string> getNamespacesNames();
+	datastorage::StorageProfile getStorageProfile(const string &_namespace);
+	void applyCacheProfile(Namespace::Ptr ns);
 
 	fast_hash_map<string, Namespace::Ptr, nocase_hash_str, nocase_equal_str> namespaces_;
 
 	shared_timed_mutex mtx_;
 	string storagePath_;
 
+	fast_hash_map<string, datastorage::StorageProfile, nocase_hash_str, nocase_equal_str> storageProfiles_;
+	std::mutex storageProfilesMtx_;
+
+	fast_hash_map<string, CacheProfile, nocase_hash_str, nocase_equal_str> cacheProfiles_;
+
 	std::thread backgroundThread_;
 	std::atomic<bool> stopBackgroundThread_;
 
@@ -27,6 +27,39 @@ public:
 	using Ptr = shared_ptr<const Snapshot>;
 };
 
+/// Tuning profile of a storage.
+/// Zero values mean backend defaults.
+struct StorageProfile {
+	/// Maximum number of open files.
+	int maxOpenFiles = 50;
+	/// Size of the in-memory write buffer (memtable) in bytes.
+	size_t writeBufferSize = 0;
+	/// Approximate size of user data packed per block in bytes.
+	size_t blockSize = 0;
+	/// Max size of a table file before switching to a new one in bytes.
+	/// Smaller files mean more frequent but cheaper compactions.
+	size_t maxFileSize = 0;
+	/// Size of the block cache in bytes.
+	size_t blockCacheSize = 0;
+	/// Use the process-wide block cache instead of a private one.
+	/// The shared cache is sized by the first profile that requests it.
+	bool sharedBlockCache = false;
+	/// Bits per key of the bloom filter, 0 - no filter.
+	int bloomBitsPerKey = 0;
+	/// Compress blocks.
+	bool compression = true;
+	/// Sync every write to disk.
+	bool syncWrites = false;
+};
+
+/// Statistics of a storage.
+struct StorageStat {
+	/// Backend specific human readable statistics.
+	string stats;
+	/// Approximate size of the whole storage on disk in bytes.
+	uint64_t approximateSize = 0;
+};
+
 /// Low-level data storage abstraction.
 class IDataStorage {
 public:
@@ -35,8 +68,9 @@ public:
 	/// Opens a storage.
 	/// @param path - path to storage.
 	/// @param opts - options.
+	/// @param profile - tuning profile.
 	/// @return Error object with an appropriate error code.
-	virtual Error Open(const string& path, const StorageOpts& opts) = 0;
+	virtual Error Open(const string& path, const StorageOpts& opts, const StorageProfile& profile = StorageProfile()) = 0;
 
 	/// Reads data from a storage.
 	/// @param opts - read options.
@@ -97,6 +131,13 @@ public:
 	/// Destroy the storage.
 	/// @param path - path to Storage.
 	virtual void Destroy(const string& path) = 0;
+
+	/// Collects statistics of a Storage.
+	/// @param stat - statistics to be filled.
+	virtual void GetStat(StorageStat& stat) = 0;
+
+	/// Compacts the whole key range of a Storage.
+	virtual void Compact() = 0;
 };
 
 /// Buffer for a Batch Write.
@@ -1,13 +1,18 @@
 #include "leveldbstorage.h"
 
+#include <leveldb/cache.h>
 #include <leveldb/comparator.h>
 #include <leveldb/db.h>
+#include <leveldb/filter_policy.h>
 #include <leveldb/iterator.h>
 #include <leveldb/slice.h>
+#include <mutex>
 
 const char* storageNotInitialized = "Storage is not initialized";
 
-void toWriteOptions(const StorageOpts& opts, leveldb::WriteOptions& wopts) { wopts.sync = opts.IsSync(); }
+void toWriteOptions(const StorageOpts& opts, const reindexer::datastorage::StorageProfile& profile, leveldb::WriteOptions& wopts) {
+	wopts.sync = opts.IsSync() || profile.syncWrites;
+}
 
 void toReadOptions(const StorageOpts& opts, leveldb::ReadOptions& ropts) {
 	ropts.fill_cache = opts.IsFillCache();
@@ -17,18 +22,46 @@ void toReadOptions(const StorageOpts& opts, leveldb::ReadOptions& ropts) {
 namespace reindexer {
 namespace datastorage {
 
+static shared_ptr<leveldb::Cache> sharedBlockCache(size_t size) {
+	static std::mutex mtx;
+	static shared_ptr<leveldb::Cache> cache;
+	std::lock_guard<std::mutex> lck(mtx);
+	if (!cache) cache.reset(leveldb::NewLRUCache(size ? size : 8 << 20));
+	return cache;
+}
+
 LevelDbStorage::LevelDbStorage() {}
 
 LevelDbStorage::~LevelDbStorage() {}
 
-Error LevelDbStorage::Open(const string& path, const StorageOpts& opts) {
+Error LevelDbStorage::Open(const string& path, const StorageOpts& opts, const StorageProfile& profile) {
 	if (path.empty()) {
 		throw Error(errParams, "Cannot enable storage: the path is empty '%s'", path.c_str());
 	}
 
 	leveldb::Options options;
 	options.create_if_missing = opts.IsCreateIfMissing();
-	options.max_open_files = 50;
+	options.max_open_files = profile.maxOpenFiles;
+	if (profile.writeBufferSize) options.write_buffer_size = profile.writeBufferSize;
+	if (profile.blockSize) options.block_size = profile.blockSize;
+	if (profile.maxFileSize) options.max_file_size = profile.maxFileSize;
+	options.compression = profile.compression ? leveldb::kSnappyCompression : leveldb::kNoCompression;
+
+	if (profile.sharedBlockCache) {
+		blockCache_ = sharedBlockCache(profile.blockCacheSize);
+	} else if (profile.blockCacheSize) {
+		blockCache_.reset(leveldb::NewLRUCache(profile.blockCacheSize));
+	} else {
+		blockCache_.reset();
+	}
+	options.block_cache = blockCache_.get();
+
+	if (profile.bloomBitsPerKey > 0) {
+		filterPolicy_.reset(leveldb::NewBloomFilterPolicy(profile.bloomBitsPerKey));
+	} else {
+		filterPolicy_.reset();
+	}
+	options.filter_policy = filterPolicy_.get();
 
 	leveldb::DB* db;
 	leveldb::Status status = leveldb::DB::Open(options, path.c_str(), &db);
@@ -38,6 +71,7 @@ Error LevelDbStorage::Open(const string& path, const StorageOpts& opts) {
 
 	if (status.ok()) {
 		opts_ = opts;
+		profile_ = profile;
 		dbpath_ = path;
 		return Error();
 	}
@@ -59,7 +93,7 @@ Error LevelDbStorage::Write(const StorageOpts& opts, const string_view& key, con
 	if (!db_) throw Error(errParams, "%s", storageNotInitialized);
 
 	leveldb::WriteOptions options;
-	toWriteOptions(opts, options);
+	toWriteOptions(opts, profile_, options);
 	leveldb::Status status = db_->Put(options, leveldb::Slice(key.data(), key.size()), leveldb::Slice(value.data(), value.size()));
 	if (status.ok()) return Error();
 	return Error(status.IsNotFound() ? errNotFound : errLogic, "%s", status.ToString().c_str());
@@ -69,7 +103,7 @@ Error LevelDbStorage::Write(const StorageOpts& opts, UpdatesCollection& buffer)
 	if (!db_) throw Error(errParams, "%s", storageNotInitialized);
 
 	leveldb::WriteOptions options;
-	toWriteOptions(opts, options);
+	toWriteOptions(opts, profile_, options);
 	LevelDbBatchBuffer* batchBuffer = static_cast<LevelDbBatchBuffer*>(&buffer);
 	leveldb::Status status = db_->Write(options, &batchBuffer->batchWrite_);
 	if (status.ok()) return Error();
@@ -80,7 +114,7 @@ Error LevelDbStorage::Delete(const StorageOpts& opts, const string_view& key) {
 	if (!db_) throw Error(errParams, "%s", storageNotInitialized);
 
 	leveldb::WriteOptions options;
-	toWriteOptions(opts, options);
+	toWriteOptions(opts, profile_, options);
 	leveldb::Status status = db_->Delete(options, leveldb::Slice(key.data(), key.size()));
 	if (status.ok()) return Error();
 	return Error(errLogic, "%s", status.ToString().c_str());
@@ -108,7 +142,7 @@ void LevelDbStorage::Flush() {
 	// way) is to just close the Storage and then open
 	// it again. So that is what we do:
 	db_.reset();
-	Open(dbpath_, opts_);
+	Open(dbpath_, opts_, profile_);
 }
 
 void LevelDbStorage::Destroy(const string& path) {
@@ -131,6 +165,23 @@ Cursor* LevelDbStorage::GetCursor(StorageOpts& opts) {
 
 UpdatesCollection* LevelDbStorage::GetUpdatesCollection() { return new LevelDbBatchBuffer(); }
 
+void LevelDbStorage::GetStat(StorageStat& stat) {
+	if (!db_) throw Error(errParams, "%s", storageNotInitialized);
+	db_->GetProperty("leveldb.stats", &stat.stats);
+
+	// Whole key space: empty key up to the greatest possible prefix
+	const string limit(16, '\xFF');
+	leveldb::Range range{leveldb::Slice(), leveldb::Slice(limit)};
+	uint64_t size = 0;
+	db_->GetApproximateSizes(&range, 1, &size);
+	stat.approximateSize = size;
+}
+
+void LevelDbStorage::Compact() {
+	if (!db_) throw Error(errParams, "%s", storageNotInitialized);
+	db_->CompactRange(nullptr, nullptr);
+}
+
 LevelDbBatchBuffer::LevelDbBatchBuffer() {}
 
 LevelDbBatchBuffer::~LevelDbBatchBuffer() {}
@@ -6,7 +6,9 @@
 using std::unique_ptr;
 
 namespace leveldb {
+class Cache;
 class DB;
+class FilterPolicy;
 class Snapshot;
 class Iterator;
 }  // namespace leveldb
@@ -19,7 +21,7 @@ public:
 	LevelDbStorage();
 	~LevelDbStorage();
 
-	Error Open(const string& path, const StorageOpts& opts) final;
+	Error Open(const string& path, const StorageOpts& opts, const StorageProfile& profile = StorageProfile()) final;
 	Error Read(const StorageOpts& opts, const string_view& key, string& value) final;
 	Error Write(const StorageOpts& opts, const string_view& key, const string_view& value) final;
 	Error Write(const StorageOpts& opts, UpdatesCollection& buffer) final;
@@ -32,10 +34,16 @@ public:
 	void Destroy(const string& path) final;
 	Cursor* GetCursor(StorageOpts& opts) final;
 	UpdatesCollection* GetUpdatesCollection() final;
+	void GetStat(StorageStat& stat) final;
+	void Compact() final;
 
 private:
 	string dbpath_;
 	StorageOpts opts_;
+	StorageProfile profile_;
+	// Cache and filter must outlive db_
+	shared_ptr<leveldb::Cache> blockCache_;
+	shared_ptr<const leveldb::FilterPolicy> filterPolicy_;
 	shared_ptr<leveldb::DB> db_;
 };
 
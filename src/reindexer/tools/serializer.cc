@@ -320,7 +320,17 @@ void WrSerializer::PrintJsonString(const string_view &str) {
 				*d++ = '6';
 				break;
 			default:
-				*d++ = c;
+				if (c >= 0 && c < 0x20) {
+					static const char hex[] = "0123456789abcdef";
+					*d++ = '\\';
+					*d++ = 'u';
+					*d++ = '0';
+					*d++ = '0';
+					*d++ = hex[c >> 4];
+					*d++ = hex[c & 0xF];
+				} else {
+					*d++ = c;
+				}
 		}
 	}
 	*d++ = '"';
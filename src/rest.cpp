@@ -594,7 +594,8 @@ static const struct {
 void StartREST()
 {
     for (unsigned int i = 0; i < ARRAYLEN(uri_prefixes); i++)
-        RegisterHTTPHandler(uri_prefixes[i].prefix, false, uri_prefixes[i].handler);
+        RegisterHTTPHandler(uri_prefixes[i].prefix, false, uri_prefixes[i].handler,
+            [](HTTPRequest*, const std::string&) { return HTTP_QUEUE_PUBLIC; });
 }
 
 void InterruptREST()
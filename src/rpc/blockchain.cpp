@@ -2650,7 +2650,7 @@ static const CRPCCommand commands[] =
 
 	{ "blockchain",         "getaddressinfo",         &getaddressinfo,         {"address"} },
 	{ "blockchain",         "gettransactions",        &gettransactions,        {"transactions"} },
-	{ "blockchain",         "getlastblocks",          &getlastblocks,          {"count","last_height","verbose"} },
+	{ "blockchain",         "getlastblocks",          &getlastblocks,          {"count","last_height","verbose"}, true, true },
 	{ "blockchain",         "checkstringtype",        &checkstringtype,        {"value"} },
     { "blockchain",         "getstatistic",           &getstatistic,           {"end_time","start_time"} },
     
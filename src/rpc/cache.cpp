@@ -0,0 +1,72 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/cache.h>
+
+#include <rpc/protocol.h>
+
+std::unique_ptr<CRPCResultCache> g_search_cache;
+std::unique_ptr<CRPCResultCache> g_tip_cache;
+
+CRPCResultCache::CRPCResultCache(size_t nMaxBytesIn) : nMaxBytes(nMaxBytesIn), nBytes(0) {}
+
+void CRPCResultCache::Evict()
+{
+    AssertLockHeld(cs);
+    while (nBytes > nMaxBytes && !entries.empty()) {
+        auto& last = entries.back();
+        nBytes -= last.nSize;
+        index.erase(last.key);
+        entries.pop_back();
+    }
+}
+
+bool CRPCResultCache::Get(const std::string& key, UniValue& result)
+{
+    LOCK(cs);
+    auto it = index.find(key);
+    if (it == index.end()) return false;
+
+    entries.splice(entries.begin(), entries, it->second);
+    result = it->second->value;
+    return true;
+}
+
+void CRPCResultCache::Put(const std::string& key, const UniValue& result)
+{
+    // Serialized size is a good enough estimate of the UniValue tree footprint
+    size_t size = key.size() * 2 + JSONRPCWrite(result).size();
+    if (size > nMaxBytes) return;
+
+    LOCK(cs);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        nBytes -= it->second->nSize;
+        entries.erase(it->second);
+        index.erase(it);
+    }
+
+    entries.push_front({key, result, size});
+    index.emplace(key, entries.begin());
+    nBytes += size;
+    Evict();
+}
+
+void CRPCResultCache::Clear()
+{
+    LOCK(cs);
+    entries.clear();
+    index.clear();
+    nBytes = 0;
+}
+
+void CRPCResultCache::BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex, const std::vector<CTransactionRef>& txnConflicted)
+{
+    Clear();
+}
+
+void CRPCResultCache::BlockDisconnected(const std::shared_ptr<const CBlock>& block)
+{
+    Clear();
+}
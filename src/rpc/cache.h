@@ -0,0 +1,65 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef POCKETCOIN_RPC_CACHE_H
+#define POCKETCOIN_RPC_CACHE_H
+
+#include <sync.h>
+#include <univalue.h>
+#include <validationinterface.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+static const int64_t DEFAULT_SEARCH_CACHE_SIZE = 32;
+static const int64_t DEFAULT_TIP_CACHE_SIZE = 64;
+
+/**
+ * LRU cache of RPC results bounded by the size of their serialized JSON.
+ * Results of PocketNet queries only change when the chain tip moves, so the
+ * whole cache is dropped on every connected or disconnected block. Callers
+ * should still include the tip in the key: notifications arrive on a
+ * background thread and a result computed right before a block would
+ * otherwise be served after it.
+ */
+class CRPCResultCache final : public CValidationInterface
+{
+private:
+    struct CEntry
+    {
+        std::string key;
+        UniValue value;
+        size_t nSize;
+    };
+    typedef std::list<CEntry> entries_t;
+
+    CCriticalSection cs;
+    entries_t entries;
+    std::unordered_map<std::string, entries_t::iterator> index;
+    size_t nMaxBytes;
+    size_t nBytes;
+
+    void Evict();
+
+protected:
+    void BlockConnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex, const std::vector<CTransactionRef>& txnConflicted) override;
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block) override;
+
+public:
+    explicit CRPCResultCache(size_t nMaxBytesIn);
+
+    /** Find result by key and mark it as recently used. */
+    bool Get(const std::string& key, UniValue& result);
+    /** Store result, evicting least recently used entries over the budget. */
+    void Put(const std::string& key, const UniValue& result);
+    void Clear();
+};
+
+/** Cache for full-text search RPC results */
+extern std::unique_ptr<CRPCResultCache> g_search_cache;
+/** Cache for results of commands marked tipCached */
+extern std::unique_ptr<CRPCResultCache> g_tip_cache;
+
+#endif // POCKETCOIN_RPC_CACHE_H
@@ -147,6 +147,7 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "bumpfee", 1, "options" },
     { "logging", 0, "include" },
     { "logging", 1, "exclude" },
+    { "getrpcstats", 0, "reset" },
     { "disconnectnode", 1, "nodeid" },
     { "addwitnessaddress", 1, "p2sh" },
     // Echo with conversion (For testing only)
@@ -181,6 +182,18 @@ static const CRPCConvertParam vRPCConvertParams[] =
 
     { "getstatistic", 0, "end_time" },
     { "getstatistic", 1, "start_time" },
+    { "getristoragestat", 1, "compact" },
+    { "getpocketdbstats", 1, "top" },
+    { "getpocketdbstats", 2, "profiling" },
+    { "getpocketdbstats", 3, "threshold" },
+    { "setpocketdbcache", 1, "idset" },
+    { "setpocketdbcache", 2, "join" },
+    { "setpocketdbcache", 3, "hitcount" },
+    { "setpocketdbcache", 4, "pinned" },
+    { "setpocketdbcache", 5, "warm" },
+    { "getcommentthreads", 2, "count" },
+    { "getcommentthreads", 3, "skip" },
+    { "getcommentthreads", 4, "replies" },
 };
 // clang-format on
 
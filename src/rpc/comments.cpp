@@ -1,5 +1,6 @@
 #include <index/addrindex.h>
 #include <antibot/antibot.h>
+#include <rpc/pocketrpc.h>
 #include <rpc/server.h>
 #include <timedata.h>
 #include <univalue.h>
@@ -215,29 +216,19 @@ UniValue getcomments(const JSONRPCRequest& request)
     else 
         g_pocketdb->Select(Query("Comments").Where("postid", CondEq, postid).Where("parentid", CondEq, parentid), commRes);
 
-    UniValue aResult(UniValue::VARR);
+    reindexer::WrSerializer ser;
+    reindexer::JsonBuilder aResult(ser, reindexer::JsonBuilder::TypeArray);
     for (auto& c : commRes) {
         reindexer::Item cmntItm = c.GetItem();
 
-        UniValue oCmnt(UniValue::VOBJ);
-        oCmnt.pushKV("id", cmntItm["id"].As<string>());
-        oCmnt.pushKV("postid", cmntItm["postid"].As<string>());
-        oCmnt.pushKV("address", cmntItm["address"].As<string>());
-        oCmnt.pushKV("pubkey", cmntItm["pubkey"].As<string>());
-        oCmnt.pushKV("signature", cmntItm["signature"].As<string>());
-        oCmnt.pushKV("time", cmntItm["time"].As<string>());
-        oCmnt.pushKV("block", cmntItm["block"].As<string>());
-        oCmnt.pushKV("msg", cmntItm["msg"].As<string>());
-        oCmnt.pushKV("parentid", cmntItm["parentid"].As<string>());
-        oCmnt.pushKV("answerid", cmntItm["answerid"].As<string>());
-        oCmnt.pushKV("timeupd", cmntItm["timeupd"].As<string>());
+        auto oCmnt = aResult.Object();
+        getCommentData(oCmnt, cmntItm);
         if (parentid == "")
-            oCmnt.pushKV("children", std::to_string(g_pocketdb->SelectCount(Query("Comments").Where("parentid", CondEq, cmntItm["id"].As<string>()))));
-
-        aResult.push_back(oCmnt);
+            oCmnt.Put("children", std::to_string(g_pocketdb->SelectCount(Query("Comments").Where("parentid", CondEq, cmntItm["id"].As<string>()))));
     }
 
-    return aResult;
+    aResult.End();
+    return RawJSON(ser);
 }
 
 UniValue getlastcomments(const JSONRPCRequest& request)
@@ -255,27 +246,17 @@ UniValue getlastcomments(const JSONRPCRequest& request)
     reindexer::QueryResults commRes;
 	g_pocketdb->Select(Query("Comments").Sort("time", true).Limit(resulCount), commRes);
 
-    UniValue aResult(UniValue::VARR);
+    reindexer::WrSerializer ser;
+    reindexer::JsonBuilder aResult(ser, reindexer::JsonBuilder::TypeArray);
     for (auto& c : commRes) {
         reindexer::Item cmntItm = c.GetItem();
 
-        UniValue oCmnt(UniValue::VOBJ);
-        oCmnt.pushKV("id", cmntItm["id"].As<string>());
-        oCmnt.pushKV("postid", cmntItm["postid"].As<string>());
-        oCmnt.pushKV("address", cmntItm["address"].As<string>());
-        oCmnt.pushKV("pubkey", cmntItm["pubkey"].As<string>());
-        oCmnt.pushKV("signature", cmntItm["signature"].As<string>());
-        oCmnt.pushKV("time", cmntItm["time"].As<string>());
-        oCmnt.pushKV("block", cmntItm["block"].As<string>());
-        oCmnt.pushKV("msg", cmntItm["msg"].As<string>());
-        oCmnt.pushKV("parentid", cmntItm["parentid"].As<string>());
-        oCmnt.pushKV("answerid", cmntItm["answerid"].As<string>());
-        oCmnt.pushKV("timeupd", cmntItm["timeupd"].As<string>());
-
-        aResult.push_back(oCmnt);
+        auto oCmnt = aResult.Object();
+        getCommentData(oCmnt, cmntItm);
     }
 
-    return aResult;
+    aResult.End();
+    return RawJSON(ser);
 }
 
 static const CRPCCommand commands[] =
@@ -283,8 +264,8 @@ static const CRPCCommand commands[] =
         //  category              name                            actor (function)            argNames
         //  --------------------- ------------------------        -----------------------     ----------
         {"rawtransactions", "sendcomment",     &sendcomment,       {"id", "postid", "address", "pubkey", "signature", "msg", "parentid", "answerid"}},
-        {"rawtransactions", "getcomments",     &getcomments,       {"postid", "parentid"}},
-        {"rawtransactions", "getlastcomments", &getlastcomments,   {"count"}},
+        {"rawtransactions", "getcomments",     &getcomments,       {"postid", "parentid"}, true},
+        {"rawtransactions", "getlastcomments", &getlastcomments,   {"count"}, true},
 };
 
 void RegisterCommentsRPCCommands(CRPCTable& t)
@@ -15,6 +15,7 @@
 #include <outputtype.h>
 #include <rpc/blockchain.h>
 #include <rpc/server.h>
+#include <rpc/stats.h>
 #include <rpc/util.h>
 #include <timedata.h>
 #include <util.h>
@@ -346,6 +347,90 @@ static void EnableOrDisableLogCategories(UniValue cats, bool enable)
     }
 }
 
+static UniValue getrpcqueueinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 0)
+        throw std::runtime_error(
+            "getrpcqueueinfo\n"
+            "Returns counters of HTTP work queues serving RPC requests.\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"name\": \"xxxx\",          (string) Queue name: node, public or mining\n"
+            "    \"threads\": n,             (numeric) Worker threads of the queue\n"
+            "    \"depth\": n,               (numeric) Requests waiting now\n"
+            "    \"maxdepth\": n,            (numeric) Requests over this depth are rejected\n"
+            "    \"processed\": n,           (numeric) Requests taken by workers\n"
+            "    \"rejected\": n,            (numeric) Requests rejected because the queue was full\n"
+            "    \"avgwait\": n,             (numeric) Average time in queue in microseconds\n"
+            "    \"maxwait\": n              (numeric) Maximum time in queue in microseconds\n"
+            "  }\n"
+            "]\n"
+            "\nExamples:\n" +
+            HelpExampleCli("getrpcqueueinfo", "") + HelpExampleRpc("getrpcqueueinfo", ""));
+
+    UniValue result(UniValue::VARR);
+    for (const HTTPWorkQueueStats& stats : GetHTTPWorkQueueStats()) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("name", stats.name);
+        entry.pushKV("threads", stats.threads);
+        entry.pushKV("depth", (uint64_t)stats.depth);
+        entry.pushKV("maxdepth", (uint64_t)stats.maxDepth);
+        entry.pushKV("processed", stats.processed);
+        entry.pushKV("rejected", stats.rejected);
+        entry.pushKV("avgwait", stats.processed > 0 ? stats.totalWaitMicros / (int64_t)stats.processed : 0);
+        entry.pushKV("maxwait", stats.maxWaitMicros);
+        result.push_back(entry);
+    }
+
+    return result;
+}
+
+static UniValue getrpcstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 1)
+        throw std::runtime_error(
+            "getrpcstats ( reset )\n"
+            "Returns per-method counters and latencies of RPC calls since start or last reset.\n"
+            "Percentiles are estimated from a histogram with fixed buckets.\n"
+            "\nArguments:\n"
+            "1. reset        (boolean, optional, default=false) Clear counters after reading them\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"method\": {             (string) RPC method name\n"
+            "    \"calls\": n,            (numeric) Number of calls\n"
+            "    \"errors\": n,           (numeric) Number of calls finished with error\n"
+            "    \"bytesout\": n,         (numeric) Size of successful replies in bytes\n"
+            "    \"avg\": n,              (numeric) Average call time in microseconds\n"
+            "    \"p50\": n,              (numeric) Median call time in microseconds\n"
+            "    \"p95\": n,              (numeric) 95th percentile of call time in microseconds\n"
+            "    \"p99\": n,              (numeric) 99th percentile of call time in microseconds\n"
+            "    \"max\": n               (numeric) Maximum call time in microseconds\n"
+            "  }, ...\n"
+            "}\n"
+            "\nExamples:\n" +
+            HelpExampleCli("getrpcstats", "") + HelpExampleRpc("getrpcstats", "true"));
+
+    UniValue result(UniValue::VOBJ);
+    for (const auto& method : g_rpc_stats.GetStats()) {
+        const CRPCStats::CMethodStats& stats = method.second;
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("calls", stats.nCalls);
+        entry.pushKV("errors", stats.nErrors);
+        entry.pushKV("bytesout", stats.nBytesOut);
+        entry.pushKV("avg", stats.nCalls > 0 ? stats.nTotalMicros / (int64_t)stats.nCalls : 0);
+        entry.pushKV("p50", stats.Percentile(0.5));
+        entry.pushKV("p95", stats.Percentile(0.95));
+        entry.pushKV("p99", stats.Percentile(0.99));
+        entry.pushKV("max", stats.nMaxMicros);
+        result.pushKV(method.first, entry);
+    }
+
+    if (!request.params[0].isNull() && request.params[0].get_bool()) g_rpc_stats.Reset();
+
+    return result;
+}
+
 UniValue logging(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 2) {
@@ -453,12 +538,145 @@ static UniValue getristat(const JSONRPCRequest& request)
     return ri_stat;
 }
 
+static UniValue getristoragestat(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 2)
+        throw std::runtime_error(
+            "getristoragestat ( \"table\" compact )\n"
+            "\nReturns LevelDB storage statistics of Reindexer DB namespaces.\n"
+            "\nArguments:\n"
+            "1. \"table\"     (string, optional) Namespace name, all namespaces if empty\n"
+            "2. compact       (boolean, optional, default=false) Compact storage of \"table\" before collecting statistics\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"namespace\": {\n"
+            "    \"approximate_size\": n,  (numeric) Approximate size on disk in bytes\n"
+            "    \"stats\": \"...\"          (string) Output of leveldb.stats property\n"
+            "  }, ...\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getristoragestat", "\"UTXO\"")
+            + HelpExampleRpc("getristoragestat", "\"UTXO\", true"));
+
+    std::string table = request.params[0].isNull() ? "" : request.params[0].get_str();
+    bool compact = request.params[1].isNull() ? false : request.params[1].get_bool();
+    if (compact) {
+        if (table.empty())
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Namespace name required for compaction");
+        if (!g_pocketdb->CompactStorage(table))
+            throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to compact namespace storage");
+    }
+
+    UniValue result(UniValue::VOBJ);
+    g_pocketdb->GetStorageStatistic(table, result);
+    return result;
+}
+
+static UniValue setpocketdbcache(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 6)
+        throw std::runtime_error(
+            "setpocketdbcache \"table\" ( idset join hitcount pinned warm )\n"
+            "\nChanges idset and join cache limits of Reindexer DB namespace until restart.\n"
+            "Omitted arguments are taken from node options. Use getpocketdbstats to watch hit rates.\n"
+            "\nArguments:\n"
+            "1. \"table\"     (string, required) Namespace name\n"
+            "2. idset         (numeric, optional) Size limit of idsets cache of every index in megabytes\n"
+            "3. join          (numeric, optional) Size limit of join cache in megabytes\n"
+            "4. hitcount      (numeric, optional) Number of lookups of key before its value is cached\n"
+            "5. pinned        (boolean, optional) Keep hit count fixed when cache is invalidated often\n"
+            "6. warm          (boolean, optional, default=false) Run hot join queries of namespace to fill the cache\n"
+            "\nExamples:\n"
+            + HelpExampleCli("setpocketdbcache", "\"Comment\" 256 1024 1 true true")
+            + HelpExampleRpc("setpocketdbcache", "\"Posts\", 512"));
+
+    std::string table = request.params[0].get_str();
+    CacheProfile profile = g_pocketdb->DefaultCacheProfile(table);
+    for (size_t i = 1; i <= 2; i++) {
+        if (!request.params[i].isNull() && request.params[i].get_int64() < 0)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Cache size must not be negative");
+    }
+    if (!request.params[1].isNull()) profile.idsetCacheSize = request.params[1].get_int64() << 20;
+    if (!request.params[2].isNull()) profile.joinCacheSize = request.params[2].get_int64() << 20;
+    if (!request.params[3].isNull()) profile.hitCountToCache = request.params[3].get_int();
+    if (!request.params[4].isNull()) profile.pinned = request.params[4].get_bool();
+    if (profile.hitCountToCache < 1)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Hit count must be positive");
+
+    if (!g_pocketdb->SetCacheProfile(table, profile))
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to change cache profile");
+    if (!request.params[5].isNull() && request.params[5].get_bool() && !g_pocketdb->WarmCaches(table))
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to warm caches");
+
+    UniValue result(UniValue::VOBJ);
+    g_pocketdb->GetPerfStatistic(table, 0, result);
+    return result;
+}
+
+static UniValue getpocketdbstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 4)
+        throw std::runtime_error(
+            "getpocketdbstats ( \"table\" top profiling threshold )\n"
+            "\nReturns memory, latency, cache and slow query statistics of Reindexer DB.\n"
+            "Latency and slow queries are collected only while profiling is enabled.\n"
+            "\nArguments:\n"
+            "1. \"table\"     (string, optional) Namespace name, all namespaces if empty\n"
+            "2. top           (numeric, optional, default=10) Number of slowest queries to return with explain plans\n"
+            "3. profiling     (boolean, optional) Enable or disable perf counters before collecting statistics\n"
+            "4. threshold     (numeric, optional, default=10) Queries faster than this number of microseconds are not traced\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"enabled\": true|false,         (boolean) Profiling state\n"
+            "  \"threshold_us\": n,             (numeric) Threshold of query tracing\n"
+            "  \"namespaces\": {\n"
+            "    \"namespace\": {\n"
+            "      \"items\": n,                (numeric) Number of items\n"
+            "      \"memory\": { \"data\": n, \"indexes\": n, \"caches\": n },  (object) Memory usage in bytes\n"
+            "      \"join_cache\": { \"items\": n, \"size\": n, \"limit\": n, \"hit_count_limit\": n, \"hits\": n, \"misses\": n, \"hit_rate\": x.xxx },\n"
+            "      \"query_cache\": { ... },     (object) Same as join_cache\n"
+            "      \"idset_cache\": { ... },     (object) Same as join_cache, sum over indexes\n"
+            "      \"selects\": { \"count\": n, \"avg_us\": n, \"avg_lock_us\": n, \"last_sec_qps\": n, \"last_sec_avg_us\": n },\n"
+            "      \"updates\": { ... }          (object) Same as selects, for commits\n"
+            "    }, ...\n"
+            "  },\n"
+            "  \"slow_queries\": [\n"
+            "    {\n"
+            "      \"query\": \"...\",            (string) Normalized query\n"
+            "      \"stat\": { ... },             (object) Same as selects\n"
+            "      \"example\": \"...\",          (string) The slowest execution of query\n"
+            "      \"explain\": { ... }           (object) Explain plan of example\n"
+            "    }, ...\n"
+            "  ]\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getpocketdbstats", "\"\" 10 true")
+            + HelpExampleRpc("getpocketdbstats", "\"Posts\", 5"));
+
+    std::string table = request.params[0].isNull() ? "" : request.params[0].get_str();
+    int top = request.params[1].isNull() ? 10 : request.params[1].get_int();
+    if (!request.params[2].isNull()) {
+        int64_t threshold = request.params[3].isNull() ? 10 : request.params[3].get_int64();
+        if (threshold < 0)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative threshold");
+        if (!g_pocketdb->SetProfiling(request.params[2].get_bool(), threshold))
+            throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to change profiling");
+    }
+
+    UniValue result(UniValue::VOBJ);
+    if (!g_pocketdb->GetPerfStatistic(table, top, result))
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to collect statistics");
+    return result;
+}
+
 // clang-format off
 static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
     { "control",            "getmemoryinfo",          &getmemoryinfo,          {"mode"} },
     { "control",            "logging",                &logging,                {"include", "exclude"}},
+    { "control",            "getrpcqueueinfo",        &getrpcqueueinfo,        {}},
+    { "control",            "getrpcstats",            &getrpcstats,            {"reset"}},
     { "util",               "validateaddress",        &validateaddress,        {"address"} },
     { "util",               "createmultisig",         &createmultisig,         {"nrequired","keys"} },
     { "util",               "verifymessage",          &verifymessage,          {"address","signature","message"} },
@@ -473,6 +691,9 @@ static const CRPCCommand commands[] =
 
 	/* For ReindexerDB */
 	{ "util",               "getristat",              &getristat,              {"table"}},
+	{ "util",               "getristoragestat",       &getristoragestat,       {"table","compact"}},
+	{ "util",               "getpocketdbstats",       &getpocketdbstats,       {"table","top","profiling","threshold"}},
+	{ "util",               "setpocketdbcache",       &setpocketdbcache,       {"table","idset","join","hitcount","pinned","warm"}},
 };
 // clang-format on
 
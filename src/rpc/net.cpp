@@ -615,7 +615,21 @@ UniValue getstakinginfo(const JSONRPCRequest &request)
     if (request.fHelp || request.params.size() != 0)
         throw std::runtime_error(
             "getstakinginfo\n"
-            "Returns an object containing staking-related information.");
+            "Returns an object containing staking-related information.\n"
+            "\nResult:\n"
+            "{\n"
+            "  ...\n"
+            "  \"wallets\": [                   (array) kernel search of each wallet\n"
+            "    {\n"
+            "      \"name\": \"xxx\",             (string) wallet name\n"
+            "      \"kernels_tried\": n,          (numeric) coins checked for a kernel\n"
+            "      \"kernels_found\": n,          (numeric) kernels found\n"
+            "      \"searching\": n,              (numeric) seconds since the search for the next kernel began\n"
+            "      \"last_time_to_find\": n,      (numeric) seconds it took to find the last kernel\n"
+            "      \"avg_time_to_find\": n        (numeric) average seconds to find a kernel\n"
+            "    }, ...\n"
+            "  ]\n"
+            "}\n");
 
     uint64_t nWeight = 0;
 
@@ -646,6 +660,20 @@ UniValue getstakinginfo(const JSONRPCRequest &request)
 
     obj.pushKV("expectedtime", nExpectedTime);
 
+    int64_t nNow = GetTime();
+    UniValue walletStats(UniValue::VARR);
+    for (const auto& it : Staker::getInstance()->getWalletStats()) {
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("name", it.first);
+        entry.pushKV("kernels_tried", it.second.kernelsTried);
+        entry.pushKV("kernels_found", it.second.kernelsFound);
+        entry.pushKV("searching", it.second.searchStart ? nNow - it.second.searchStart : 0);
+        entry.pushKV("last_time_to_find", it.second.lastTimeToFind);
+        entry.pushKV("avg_time_to_find", it.second.kernelsFound ? it.second.totalTimeToFind / (int64_t)it.second.kernelsFound : 0);
+        walletStats.push_back(entry);
+    }
+    obj.pushKV("wallets", walletStats);
+
     return obj;
 }
 
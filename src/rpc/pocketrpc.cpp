@@ -2,6 +2,44 @@
 
 #include <rpc/pocketrpc.h>
 
+#include <index/pocketindex.h>
+
+// Fields of old Comments written as is
+static const std::vector<JsonField> COMMENT_FIELDS = {
+    {&PocketSchema::Comments::id, "id"}, {&PocketSchema::Comments::postid, "postid"},
+    {&PocketSchema::Comments::address, "address"}, {&PocketSchema::Comments::pubkey, "pubkey"},
+    {&PocketSchema::Comments::signature, "signature"}, {&PocketSchema::Comments::time, "time"},
+    {&PocketSchema::Comments::block, "block"}, {&PocketSchema::Comments::msg, "msg"},
+    {&PocketSchema::Comments::parentid, "parentid"}, {&PocketSchema::Comments::answerid, "answerid"},
+    {&PocketSchema::Comments::timeupd, "timeupd"}};
+
+// Fields of last version of Comment written as is
+static const std::vector<JsonField> COMMENT_V2_FIELDS = {
+    {&PocketSchema::Comment::block, "block"}, {&PocketSchema::Comment::msg, "msg"},
+    {&PocketSchema::Comment::parentid, "parentid"}, {&PocketSchema::Comment::answerid, "answerid"},
+    {&PocketSchema::Comment::scoreUp, "scoreUp"}, {&PocketSchema::Comment::scoreDown, "scoreDown"},
+    {&PocketSchema::Comment::reputation, "reputation"}};
+
+void getCommentData(reindexer::JsonBuilder& oCmnt, reindexer::Item& cmntItm)
+{
+    PutItemStrings(oCmnt, cmntItm, COMMENT_FIELDS);
+}
+
+void getCommentDataV2(reindexer::JsonBuilder& oCmnt, reindexer::Item& cmntItm, reindexer::Item& ocmntItm, int myScore)
+{
+    std::string otxid = PocketSchema::Comment::otxid.String(cmntItm);
+
+    oCmnt.Put("id", otxid);
+    PutItemString(oCmnt, "postid", cmntItm, PocketSchema::Comment::postid);
+    PutItemString(oCmnt, "address", cmntItm, PocketSchema::Comment::address);
+    PutItemString(oCmnt, "time", ocmntItm, PocketSchema::Comment::time);
+    PutItemString(oCmnt, "timeUpd", cmntItm, PocketSchema::Comment::time);
+    PutItemStrings(oCmnt, cmntItm, COMMENT_V2_FIELDS);
+    oCmnt.Put("edit", otxid != PocketSchema::Comment::txid.String(cmntItm));
+    oCmnt.Put("deleted", reindexer::string_view(PocketSchema::Comment::msg.Get(cmntItm)).size() == 0);
+    oCmnt.Put("myScore", myScore);
+}
+
 UniValue getcommentsV2(const JSONRPCRequest& request)
 {
     if (request.fHelp)
@@ -39,6 +77,9 @@ UniValue getcommentsV2(const JSONRPCRequest& request)
         }
     }
     
+    // Children counts come from comment tree
+    if (g_pocketindex) g_pocketindex->BlockUntilSyncedToCurrentChain();
+
     // For joined tables
     // it.GetJoined()[1][0]
     // [1] - table
@@ -62,7 +103,8 @@ UniValue getcommentsV2(const JSONRPCRequest& request)
                 .LeftJoin("otxid", "commentid", CondEq, Query("CommentScores").Where("address", CondSet, address).Limit(1))
         ,commRes);
 
-    UniValue aResult(UniValue::VARR);
+    reindexer::WrSerializer ser;
+    reindexer::JsonBuilder aResult(ser, reindexer::JsonBuilder::TypeArray);
     for (auto& it : commRes) {
         reindexer::Item cmntItm = it.GetItem();
         reindexer::Item ocmntItm = it.GetJoined()[0][0].GetItem();
@@ -73,28 +115,116 @@ UniValue getcommentsV2(const JSONRPCRequest& request)
             myScore = ocmntScoreItm["value"].As<int>();
         }
 
-        UniValue oCmnt(UniValue::VOBJ);
-        oCmnt.pushKV("id", cmntItm["otxid"].As<string>());
-        oCmnt.pushKV("postid", cmntItm["postid"].As<string>());
-        oCmnt.pushKV("address", cmntItm["address"].As<string>());
-        oCmnt.pushKV("time", ocmntItm["time"].As<string>());
-        oCmnt.pushKV("timeUpd", cmntItm["time"].As<string>());
-        oCmnt.pushKV("block", cmntItm["block"].As<string>());
-        oCmnt.pushKV("msg", cmntItm["msg"].As<string>());
-        oCmnt.pushKV("parentid", cmntItm["parentid"].As<string>());
-        oCmnt.pushKV("answerid", cmntItm["answerid"].As<string>());
-        oCmnt.pushKV("scoreUp", cmntItm["scoreUp"].As<string>());
-        oCmnt.pushKV("scoreDown", cmntItm["scoreDown"].As<string>());
-        oCmnt.pushKV("reputation", cmntItm["reputation"].As<string>());
-        oCmnt.pushKV("edit", cmntItm["otxid"].As<string>() != cmntItm["txid"].As<string>());
-        oCmnt.pushKV("deleted", cmntItm["msg"].As<string>() == "");
-        oCmnt.pushKV("myScore", myScore);
-        oCmnt.pushKV("children", std::to_string(g_pocketdb->SelectCount(Query("Comment").Where("parentid", CondEq, cmntItm["otxid"].As<string>()).Where("last", CondEq, true))));
-
-        aResult.push_back(oCmnt);
+        auto oCmnt = aResult.Object();
+        getCommentDataV2(oCmnt, cmntItm, ocmntItm, myScore);
+        oCmnt.Put("children", std::to_string(g_commenttree->GetChildrenCount(PocketSchema::Comment::otxid.String(cmntItm))));
+    }
+
+    aResult.End();
+    return RawJSON(ser);
+}
+
+UniValue getcommentthreads(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() < 1 || request.params.size() > 5)
+        throw std::runtime_error(
+            "getcommentthreads \"postid\" ( \"address\" count skip replies )\n"
+            "\nGet root comments of post, newest first, with first replies of each.\n"
+            "\nArguments:\n"
+            "1. \"postid\"   (string, required) Post txid\n"
+            "2. \"address\"  (string, optional) Address of requester for `myScore`\n"
+            "3. count        (numeric, optional, default=10) Count of root comments\n"
+            "4. skip         (numeric, optional, default=0) Count of newest root comments to skip\n"
+            "5. replies      (numeric, optional, default=3) Count of first replies for every root comment\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"total\": n,      (numeric) Count of root comments of post\n"
+            "  \"comments\": [    Root comments as in getcomments2 with array `replies`\n"
+            "  ]\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getcommentthreads", "\"postid\" \"address\" 20 0 3")
+            + HelpExampleRpc("getcommentthreads", "\"postid\", \"address\", 20, 0, 3"));
+
+    std::string postid = request.params[0].get_str();
+    std::string address = (request.params.size() > 1 ? request.params[1].get_str() : "");
+    int count = (request.params.size() > 2 ? request.params[2].get_int() : 10);
+    int skip = (request.params.size() > 3 ? request.params[3].get_int() : 0);
+    int replies = (request.params.size() > 4 ? request.params[4].get_int() : 3);
+    if (count < 0 || skip < 0 || replies < 0)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative count");
+
+    if (g_pocketindex) g_pocketindex->BlockUntilSyncedToCurrentChain();
+    std::vector<CommentThread> threads;
+    int total = g_commenttree->GetThreads(postid, skip, count, replies, threads);
+
+    // All comments of page are loaded with one query
+    std::vector<std::string> ids;
+    for (const auto& thread : threads) {
+        ids.push_back(thread.id);
+        ids.insert(ids.end(), thread.replies.begin(), thread.replies.end());
+    }
+
+    reindexer::QueryResults commRes;
+    if (!ids.empty()) {
+        Error err = g_pocketdb->Select(
+            Query("Comment")
+                .Where("otxid", CondSet, ids)
+                .Where("last", CondEq, true)
+                .InnerJoin("otxid", "txid", CondEq, Query("Comment").Where("txid", CondSet, ids).Limit(1))
+                .LeftJoin("otxid", "commentid", CondEq, Query("CommentScores").Where("address", CondEq, address).Limit(1))
+        ,commRes);
+        if (!err.ok())
+            throw JSONRPCError(RPC_DATABASE_ERROR, "Failed to load comments: " + err.what());
+    }
+
+    std::map<std::string, int> found;
+    for (size_t i = 0; i < commRes.Count(); i++) {
+        reindexer::Item cmntItm = commRes[i].GetItem();
+        found.emplace(PocketSchema::Comment::otxid.String(cmntItm), (int)i);
+    }
+
+    auto putComment = [&](reindexer::JsonBuilder& oCmnt, int i) {
+        auto it = commRes[i];
+        reindexer::Item cmntItm = it.GetItem();
+        reindexer::Item ocmntItm = it.GetJoined()[0][0].GetItem();
+
+        int myScore = 0;
+        if (it.GetJoined().size() > 1 && it.GetJoined()[1].Count() > 0) {
+            reindexer::Item ocmntScoreItm = it.GetJoined()[1][0].GetItem();
+            myScore = PocketSchema::CommentScores::value.Int(ocmntScoreItm);
+        }
+
+        getCommentDataV2(oCmnt, cmntItm, ocmntItm, myScore);
+    };
+
+    reindexer::WrSerializer ser;
+    {
+        reindexer::JsonBuilder result(ser);
+        result.Put("total", total);
+
+        auto aComments = result.Array("comments");
+        for (const auto& thread : threads) {
+            auto root = found.find(thread.id);
+            if (root == found.end()) continue;
+
+            auto oCmnt = aComments.Object();
+            putComment(oCmnt, root->second);
+            oCmnt.Put("children", std::to_string(thread.children));
+
+            auto aReplies = oCmnt.Array("replies");
+            for (const auto& id : thread.replies) {
+                auto reply = found.find(id);
+                if (reply == found.end()) continue;
+
+                auto oReply = aReplies.Object();
+                putComment(oReply, reply->second);
+                oReply.Put("children", std::to_string(g_commenttree->GetChildrenCount(id)));
+            }
+        }
     }
 
-    return aResult;
+    return RawJSON(ser);
 }
 
 UniValue getlastcommentsV2(const JSONRPCRequest& request)
@@ -124,7 +254,8 @@ UniValue getlastcommentsV2(const JSONRPCRequest& request)
             .LeftJoin("otxid", "commentid", CondEq, Query("CommentScores").Where("address", CondSet, address).Limit(1))
     ,commRes);
 
-    UniValue aResult(UniValue::VARR);
+    reindexer::WrSerializer ser;
+    reindexer::JsonBuilder aResult(ser, reindexer::JsonBuilder::TypeArray);
     for (auto& it : commRes) {
         reindexer::Item cmntItm = it.GetItem();
         reindexer::Item ocmntItm = it.GetJoined()[0][0].GetItem();
@@ -135,33 +266,19 @@ UniValue getlastcommentsV2(const JSONRPCRequest& request)
             myScore = ocmntScoreItm["value"].As<int>();
         }
 
-        UniValue oCmnt(UniValue::VOBJ);
-        oCmnt.pushKV("id", cmntItm["otxid"].As<string>());
-        oCmnt.pushKV("postid", cmntItm["postid"].As<string>());
-        oCmnt.pushKV("address", cmntItm["address"].As<string>());
-        oCmnt.pushKV("time", ocmntItm["time"].As<string>());
-        oCmnt.pushKV("timeUpd", cmntItm["time"].As<string>());
-        oCmnt.pushKV("block", cmntItm["block"].As<string>());
-        oCmnt.pushKV("msg", cmntItm["msg"].As<string>());
-        oCmnt.pushKV("parentid", cmntItm["parentid"].As<string>());
-        oCmnt.pushKV("answerid", cmntItm["answerid"].As<string>());
-        oCmnt.pushKV("scoreUp", cmntItm["scoreUp"].As<string>());
-        oCmnt.pushKV("scoreDown", cmntItm["scoreDown"].As<string>());
-        oCmnt.pushKV("reputation", cmntItm["reputation"].As<string>());
-        oCmnt.pushKV("edit", cmntItm["otxid"].As<string>() != cmntItm["txid"].As<string>());
-        oCmnt.pushKV("deleted", cmntItm["msg"].As<string>() == "");
-        oCmnt.pushKV("myScore", myScore);
-
-        aResult.push_back(oCmnt);
+        auto oCmnt = aResult.Object();
+        getCommentDataV2(oCmnt, cmntItm, ocmntItm, myScore);
     }
 
-    return aResult;
+    aResult.End();
+    return RawJSON(ser);
 }
 
 static const CRPCCommand commands[] =
     {
-        {"pocketnetrpc",   "getlastcomments2",    &getlastcommentsV2,      {"count","address"}},
-        {"pocketnetrpc",   "getcomments2",        &getcommentsV2,          {"postid","parentid","address","ids"}},
+        {"pocketnetrpc",   "getlastcomments2",    &getlastcommentsV2,      {"count","address"}, true, true},
+        {"pocketnetrpc",   "getcomments2",        &getcommentsV2,          {"postid","parentid","address","ids"}, true},
+        {"pocketnetrpc",   "getcommentthreads",   &getcommentthreads,      {"postid","address","count","skip","replies"}, true},
 };
 
 void RegisterPocketnetRPCCommands(CRPCTable& t)
@@ -7,5 +7,11 @@
 #include <index/addrindex.h>
 #include <antibot/antibot.h>
 #include <rpc/server.h>
+#include <pocketdb/jsonwriter.h>
+
+/** Write fields of Comments item */
+void getCommentData(reindexer::JsonBuilder& oCmnt, reindexer::Item& cmntItm);
+/** Write last version of Comment item with time of its first version and score of requester */
+void getCommentDataV2(reindexer::JsonBuilder& oCmnt, reindexer::Item& cmntItm, reindexer::Item& ocmntItm, int myScore);
 
 #endif // POCKETCOIN_RPC_POCKETNET_H
@@ -47,7 +47,7 @@ UniValue JSONRPCReplyObj(const UniValue& result, const UniValue& error, const Un
 std::string JSONRPCReply(const UniValue& result, const UniValue& error, const UniValue& id)
 {
     UniValue reply = JSONRPCReplyObj(result, error, id);
-    return reply.write() + "\n";
+    return JSONRPCWrite(reply) + "\n";
 }
 
 UniValue JSONRPCError(int code, const std::string& message)
@@ -58,6 +58,85 @@ UniValue JSONRPCError(int code, const std::string& message)
     return error;
 }
 
+/**
+ * Raw JSON travels as a string with a prefix that no JSON text or RPC string
+ * starts with, so results holding it can be copied and cached as usual.
+ */
+static const std::string RAW_JSON_PREFIX("\0rawjson\0", 9);
+
+static bool IsRawValue(const UniValue& value)
+{
+    return value.isStr() && value.getValStr().compare(0, RAW_JSON_PREFIX.size(), RAW_JSON_PREFIX) == 0;
+}
+
+static bool ContainsRawValue(const UniValue& value)
+{
+    if (IsRawValue(value)) return true;
+    if (!value.isObject() && !value.isArray()) return false;
+    for (const UniValue& child : value.getValues()) {
+        if (ContainsRawValue(child)) return true;
+    }
+    return false;
+}
+
+static void WriteSpliced(const UniValue& value, std::string& s)
+{
+    if (IsRawValue(value)) {
+        s.append(value.getValStr(), RAW_JSON_PREFIX.size(), std::string::npos);
+    } else if (value.isObject()) {
+        s += '{';
+        for (size_t i = 0; i < value.size(); i++) {
+            if (i > 0) s += ',';
+            s += UniValue(value.getKeys()[i]).write();
+            s += ':';
+            WriteSpliced(value[i], s);
+        }
+        s += '}';
+    } else if (value.isArray()) {
+        s += '[';
+        for (size_t i = 0; i < value.size(); i++) {
+            if (i > 0) s += ',';
+            WriteSpliced(value[i], s);
+        }
+        s += ']';
+    } else {
+        s += value.write();
+    }
+}
+
+UniValue JSONRPCRawValue(const std::string& json)
+{
+    return UniValue(RAW_JSON_PREFIX + json);
+}
+
+std::string JSONRPCWrite(const UniValue& value)
+{
+    if (!ContainsRawValue(value)) return value.write();
+
+    std::string s;
+    WriteSpliced(value, s);
+    return s;
+}
+
+UniValue JSONRPCParseRaw(const UniValue& value)
+{
+    if (IsRawValue(value)) {
+        UniValue parsed;
+        parsed.read(value.getValStr().substr(RAW_JSON_PREFIX.size()));
+        return parsed;
+    }
+    if (!ContainsRawValue(value)) return value;
+
+    UniValue result(value.getType());
+    for (size_t i = 0; i < value.size(); i++) {
+        if (value.isObject())
+            result.__pushKV(value.getKeys()[i], JSONRPCParseRaw(value[i]));
+        else
+            result.push_back(JSONRPCParseRaw(value[i]));
+    }
+    return result;
+}
+
 /** Username used when cookie authentication is in use (arbitrary, only for
  * recognizability in debugging/logging purposes)
  */
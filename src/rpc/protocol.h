@@ -19,6 +19,7 @@
 enum HTTPStatusCode
 {
     HTTP_OK                    = 200,
+    HTTP_NOT_MODIFIED          = 304,
     HTTP_BAD_REQUEST           = 400,
     HTTP_UNAUTHORIZED          = 401,
     HTTP_FORBIDDEN             = 403,
@@ -98,6 +99,13 @@ UniValue JSONRPCReplyObj(const UniValue& result, const UniValue& error, const Un
 std::string JSONRPCReply(const UniValue& result, const UniValue& error, const UniValue& id);
 UniValue JSONRPCError(int code, const std::string& message);
 
+/** Wrap JSON serialized elsewhere into a value that JSONRPCWrite outputs verbatim */
+UniValue JSONRPCRawValue(const std::string& json);
+/** Write value like UniValue::write(), splicing JSON of values made by JSONRPCRawValue */
+std::string JSONRPCWrite(const UniValue& value);
+/** Replace values made by JSONRPCRawValue with parsed JSON, for callers that read the result */
+UniValue JSONRPCParseRaw(const UniValue& value);
+
 /** Generate a new RPC authentication cookie and write it to disk */
 bool GenerateAuthCookie(std::string *cookie_out);
 /** Read the RPC authentication cookie from disk */
@@ -8,6 +8,7 @@
 #include <compat/byteswap.h>
 #include <consensus/validation.h>
 #include <core_io.h>
+#include <index/pocketindex.h>
 #include <index/txindex.h>
 #include <key_io.h>
 #include <keystore.h>
@@ -37,6 +38,9 @@
 #include "antibot/antibot.h"
 #include "html.h"
 #include "index/addrindex.h"
+#include "pocketdb/jsonwriter.h"
+#include "rpc/pocketrpc.h"
+#include "rpc/cache.h"
 
 static void TxToJSON(const CTransaction& tx, const uint256 hashBlock, UniValue& entry)
 {
@@ -1977,85 +1981,57 @@ UniValue sendrawtransactionwithmessage(const JSONRPCRequest& request)
     return rt;
 }
 //----------------------------------------------------------
-UniValue getPostData(reindexer::Item& itm, std::string address, int comments_version = 0)
+// Fields of Post written as is
+static const std::vector<JsonField> POST_FIELDS = {
+    {&PocketSchema::Posts::address, "address"}, {&PocketSchema::Posts::time, "time"},
+    {&PocketSchema::Posts::lang, "l"}, {&PocketSchema::Posts::caption, "c"},
+    {&PocketSchema::Posts::message, "m"}, {&PocketSchema::Posts::url, "u"},
+    {&PocketSchema::Posts::scoreSum, "scoreSum"}, {&PocketSchema::Posts::scoreCnt, "scoreCnt"}};
+
+void getPostData(reindexer::JsonBuilder& entry, reindexer::Item& itm, std::string address, int comments_version = 0)
 {
-    UniValue entry(UniValue::VOBJ);
-
-    entry.pushKV("txid", itm["txid"].As<string>());
-    if (itm["txidEdit"].As<string>() != "") entry.pushKV("edit", "true");
-    entry.pushKV("address", itm["address"].As<string>());
-    entry.pushKV("time", itm["time"].As<string>());
-    entry.pushKV("l", itm["lang"].As<string>());
-    entry.pushKV("c", itm["caption"].As<string>());
-    entry.pushKV("m", itm["message"].As<string>());
-    entry.pushKV("u", itm["url"].As<string>());
+    std::string txid = PocketSchema::Posts::txid.String(itm);
 
-    entry.pushKV("scoreSum", itm["scoreSum"].As<string>());
-    entry.pushKV("scoreCnt", itm["scoreCnt"].As<string>());
-
-    try {
-        UniValue t(UniValue::VARR);
-        reindexer::VariantArray va = itm["tags"];
-        for (unsigned int idx = 0; idx < va.size(); idx++) {
-            t.push_back(va[idx].As<string>());
-        }
-        entry.pushKV("t", t);
-    } catch (...) {
-    }
-
-    try {
-        UniValue i(UniValue::VARR);
-        reindexer::VariantArray va = itm["images"];
-        for (unsigned int idx = 0; idx < va.size(); idx++) {
-            i.push_back(va[idx].As<string>());
-        }
-        entry.pushKV("i", i);
-    } catch (...) {
-    }
+    entry.Put("txid", txid);
+    if (reindexer::string_view(PocketSchema::Posts::txidEdit.Get(itm)).size() > 0) entry.Put("edit", "true");
+    PutItemStrings(entry, itm, POST_FIELDS);
+    PutItemArray(entry, "t", itm, PocketSchema::Posts::tags);
+    PutItemArray(entry, "i", itm, PocketSchema::Posts::images);
 
     UniValue ss(UniValue::VOBJ);
-    ss.read(itm["settings"].As<string>());
-    entry.pushKV("s", ss);
+    ss.read(PocketSchema::Posts::settings.String(itm));
+    entry.Raw("s", ss.write());
 
     if (address != "") {
         reindexer::Item scoreMyItm;
         reindexer::Error errS = g_pocketdb->SelectOne(
-            reindexer::Query("Scores").Where("address", CondEq, address).Where("posttxid", CondEq, itm["txid"].As<string>()),
+            reindexer::Query("Scores").Where("address", CondEq, address).Where("posttxid", CondEq, txid),
             scoreMyItm);
 
-        entry.pushKV("myVal", errS.ok() ? scoreMyItm["value"].As<string>() : "0");
+        if (errS.ok())
+            PutItemString(entry, "myVal", scoreMyItm, PocketSchema::Scores::value);
+        else
+            entry.Put("myVal", "0");
     }
 
 	if (comments_version == 0) {
-        int totalComments = g_pocketdb->SelectCount(Query("Comments").Where("postid", CondEq, itm["txid"].As<string>()));
+        int totalComments = g_pocketdb->SelectCount(Query("Comments").Where("postid", CondEq, txid));
         reindexer::Item cmntItm;
-        g_pocketdb->SelectOne(Query("Comments").Where("postid", CondEq, itm["txid"].As<string>()).Where("parentid", CondEq, "").Sort("time", true), cmntItm);
-        entry.pushKV("comments", totalComments);
+        g_pocketdb->SelectOne(Query("Comments").Where("postid", CondEq, txid).Where("parentid", CondEq, "").Sort("time", true), cmntItm);
+        entry.Put("comments", totalComments);
         if (totalComments > 0) {
-            UniValue oCmnt(UniValue::VOBJ);
-            oCmnt.pushKV("id", cmntItm["id"].As<string>());
-            oCmnt.pushKV("postid", cmntItm["postid"].As<string>());
-            oCmnt.pushKV("address", cmntItm["address"].As<string>());
-            oCmnt.pushKV("pubkey", cmntItm["pubkey"].As<string>());
-            oCmnt.pushKV("signature", cmntItm["signature"].As<string>());
-            oCmnt.pushKV("time", cmntItm["time"].As<string>());
-            oCmnt.pushKV("block", cmntItm["block"].As<string>());
-            oCmnt.pushKV("msg", cmntItm["msg"].As<string>());
-            oCmnt.pushKV("parentid", cmntItm["parentid"].As<string>());
-            oCmnt.pushKV("answerid", cmntItm["answerid"].As<string>());
-            oCmnt.pushKV("timeupd", cmntItm["timeupd"].As<string>());
-            oCmnt.pushKV("children", std::to_string(g_pocketdb->SelectCount(Query("Comments").Where("parentid", CondEq, cmntItm["id"].As<string>()))));
-
-            entry.pushKV("lastComment", oCmnt);
+            auto oCmnt = entry.Object("lastComment");
+            getCommentData(oCmnt, cmntItm);
+            oCmnt.Put("children", std::to_string(g_pocketdb->SelectCount(Query("Comments").Where("parentid", CondEq, cmntItm["id"].As<string>()))));
         }
     } else {
-        int totalComments = g_pocketdb->SelectCount(Query("Comment").Where("postid", CondEq, itm["txid"].As<string>()).Where("last", CondEq, true));
-        entry.pushKV("comments", totalComments);
+        int totalComments = g_pocketdb->SelectCount(Query("Comment").Where("postid", CondEq, txid).Where("last", CondEq, true));
+        entry.Put("comments", totalComments);
 
         reindexer::QueryResults cmntRes;
         g_pocketdb->Select(
             Query("Comment", 0, 1)
-                .Where("postid", CondEq, itm["txid"].As<string>())
+                .Where("postid", CondEq, txid)
                 .Where("parentid", CondEq, "")
                 .Where("last", CondEq, true)
                 .Sort("time", true)
@@ -2064,8 +2040,6 @@ UniValue getPostData(reindexer::Item& itm, std::string address, int comments_ver
             ,cmntRes);
         
         if (totalComments > 0 && cmntRes.Count() > 0) {
-            UniValue oCmnt(UniValue::VOBJ);
-
             reindexer::Item cmntItm = cmntRes[0].GetItem();
             reindexer::Item ocmntItm = cmntRes[0].GetJoined()[0][0].GetItem();
             
@@ -2075,28 +2049,11 @@ UniValue getPostData(reindexer::Item& itm, std::string address, int comments_ver
                 myScore = ocmntScoreItm["value"].As<int>();
             }
 
-            oCmnt.pushKV("id", cmntItm["otxid"].As<string>());
-            oCmnt.pushKV("postid", cmntItm["postid"].As<string>());
-            oCmnt.pushKV("address", cmntItm["address"].As<string>());
-            oCmnt.pushKV("time", ocmntItm["time"].As<string>());
-            oCmnt.pushKV("timeUpd", cmntItm["time"].As<string>());
-            oCmnt.pushKV("block", cmntItm["block"].As<string>());
-            oCmnt.pushKV("msg", cmntItm["msg"].As<string>());
-            oCmnt.pushKV("parentid", cmntItm["parentid"].As<string>());
-            oCmnt.pushKV("answerid", cmntItm["answerid"].As<string>());
-            oCmnt.pushKV("scoreUp", cmntItm["scoreUp"].As<string>());
-            oCmnt.pushKV("scoreDown", cmntItm["scoreDown"].As<string>());
-            oCmnt.pushKV("reputation", cmntItm["reputation"].As<string>());
-            oCmnt.pushKV("edit", cmntItm["otxid"].As<string>() != cmntItm["txid"].As<string>());
-            oCmnt.pushKV("deleted", cmntItm["msg"].As<string>() == "");
-            oCmnt.pushKV("myScore", myScore);
-            oCmnt.pushKV("children", std::to_string(g_pocketdb->SelectCount(Query("Comment").Where("parentid", CondEq, cmntItm["otxid"].As<string>()).Where("last", CondEq, true))));
-
-            entry.pushKV("lastComment", oCmnt);
+            auto oCmnt = entry.Object("lastComment");
+            getCommentDataV2(oCmnt, cmntItm, ocmntItm, myScore);
+            oCmnt.Put("children", std::to_string(g_pocketdb->SelectCount(Query("Comment").Where("parentid", CondEq, cmntItm["otxid"].As<string>()).Where("last", CondEq, true))));
         }
 	}
-
-    return entry;
 }
 
 UniValue getrawtransactionwithmessage(const JSONRPCRequest& request, int version = 0) {
@@ -2105,8 +2062,6 @@ UniValue getrawtransactionwithmessage(const JSONRPCRequest& request, int version
             "getrawtransactionwithmessage\n"
             "\nReturn Pocketnet posts.\n");
 
-    UniValue a(UniValue::VARR);
-
     reindexer::QueryResults queryRes;
     reindexer::Error err;
 
@@ -2187,6 +2142,9 @@ UniValue getrawtransactionwithmessage(const JSONRPCRequest& request, int version
             queryRes);
     }
 
+    reindexer::WrSerializer ser;
+    reindexer::JsonBuilder a(ser, reindexer::JsonBuilder::TypeArray);
+
     int iQuery = 0;
     reindexer::QueryResults::Iterator it = queryRes.begin();
     while (resultCount > 0 && it != queryRes.end()) {
@@ -2198,14 +2156,16 @@ UniValue getrawtransactionwithmessage(const JSONRPCRequest& request, int version
         err = g_pocketdb->DB()->Select(reindexer::Query("Scores").Where("posttxid", CondEq, itm["txid"].As<string>()).Where("value", CondGt, 3), queryResUpv);
 
         if (queryResComp.Count() <= 7 || queryResComp.Count() / (queryResUpv.Count() == 0 ? 1 : queryResUpv.Count() == 0 ? 1 : queryResUpv.Count()) <= 0.1) {
-            a.push_back(getPostData(itm, address_from, version));
+            auto entry = a.Object();
+            getPostData(entry, itm, address_from, version);
             resultCount -= 1;
         }
         iQuery += 1;
         it = queryRes[iQuery];
     }
 
-    return a;
+    a.End();
+    return RawJSON(ser);
 }
 
 UniValue getrawtransactionwithmessage(const JSONRPCRequest& request)
@@ -2247,8 +2207,6 @@ UniValue getrawtransactionwithmessagebyid(const JSONRPCRequest& request, int ver
             throw JSONRPCError(RPC_INVALID_PARAMS, "Invalid address in HEX transaction");
     }
 
-    UniValue a(UniValue::VARR);
-
     reindexer::QueryResults queryRes;
     reindexer::Error err;
 
@@ -2256,11 +2214,16 @@ UniValue getrawtransactionwithmessagebyid(const JSONRPCRequest& request, int ver
         reindexer::Query("Posts").Where("txid", CondSet, TxIds).Sort("time", true),
         queryRes);
 
+    reindexer::WrSerializer ser;
+    reindexer::JsonBuilder a(ser, reindexer::JsonBuilder::TypeArray);
     for (auto it : queryRes) {
         reindexer::Item itm(it.GetItem());
-        a.push_back(getPostData(itm, address, version));
+        auto entry = a.Object();
+        getPostData(entry, itm, address, version);
     }
-    return a;
+
+    a.End();
+    return RawJSON(ser);
 }
 
 UniValue getrawtransactionwithmessagebyid(const JSONRPCRequest& request) {
@@ -2296,7 +2259,12 @@ UniValue gethotposts(const JSONRPCRequest& request, int version = 0)
             throw JSONRPCError(RPC_INVALID_PARAMS, "Invalid address in HEX transaction");
     }
 
-    int64_t curTime = GetAdjustedTime();
+    // Window ends at tip block time, so reply depends only on chain tip (tipCached)
+    int64_t curTime;
+    {
+        LOCK(cs_main);
+        curTime = chainActive.Tip()->GetBlockTime();
+    }
 
     // Excluded posts
     vector<string> addrsblock;
@@ -2333,19 +2301,24 @@ UniValue gethotposts(const JSONRPCRequest& request, int version = 0)
                            .Sort("scoreSum", true),
         postsRes);
 
-    UniValue result(UniValue::VARR);
+    reindexer::WrSerializer ser;
+    reindexer::JsonBuilder result(ser, reindexer::JsonBuilder::TypeArray);
 
+    int resultCount = 0;
     for (auto& p : postsRes) {
         reindexer::Item postItm = p.GetItem();
 
         if (postItm["reputation"].As<int>() > 0) {
-            result.push_back(getPostData(postItm, address, version));
+            auto entry = result.Object();
+            getPostData(entry, postItm, address, version);
+            resultCount += 1;
         }
 
-        if (result.size() >= count) break;
+        if (resultCount >= count) break;
     }
 
-    return result;
+    result.End();
+    return RawJSON(ser);
 }
 
 UniValue gethotposts(const JSONRPCRequest& request) { return gethotposts(request, 0); }
@@ -2368,108 +2341,119 @@ std::map<std::string, UniValue> getUsersProfiles(std::vector<string> addresses,
         }
     }
 
+    // Count of referrals by addresses
+    std::map<std::string, int> _referrals_cnt;
+    if (g_pocketdb->SelectAggr(reindexer::Query("UsersView").Where("referrer", CondSet, addresses).Aggregate("referrer", AggFacet), "referrer", aggRes).ok()) {
+        for (const auto& f : aggRes.facets) {
+            _referrals_cnt.insert_or_assign(f.value, f.count);
+        }
+    }
+
+    // Relations for full form are loaded for all addresses at once and grouped by address
+    std::map<std::string, std::vector<std::pair<std::string, std::string>>> _subscribes;
+    std::map<std::string, std::vector<std::string>> _subscribers;
+    std::map<std::string, std::vector<std::string>> _blockings;
+    if (!shortForm) {
+        reindexer::QueryResults queryResSubscribes;
+        if (g_pocketdb->DB()->Select(reindexer::Query("SubscribesView").Where("address", CondSet, addresses), queryResSubscribes).ok()) {
+            for (auto itS : queryResSubscribes) {
+                reindexer::Item curSbscrbItm(itS.GetItem());
+                _subscribes[curSbscrbItm["address"].As<string>()].emplace_back(curSbscrbItm["address_to"].As<string>(), curSbscrbItm["private"].As<string>());
+            }
+        }
+
+        reindexer::QueryResults queryResSubscribers;
+        if (g_pocketdb->DB()->Select(reindexer::Query("SubscribesView").Where("address_to", CondSet, addresses).Where("private", CondEq, false), queryResSubscribers).ok()) {
+            for (auto itS : queryResSubscribers) {
+                reindexer::Item curSbscrbItm(itS.GetItem());
+                _subscribers[curSbscrbItm["address_to"].As<string>()].push_back(curSbscrbItm["address"].As<string>());
+            }
+        }
+
+        reindexer::QueryResults queryResBlockings;
+        if (g_pocketdb->DB()->Select(reindexer::Query("BlockingView").Where("address", CondSet, addresses), queryResBlockings).ok()) {
+            for (auto itB : queryResBlockings) {
+                reindexer::Item curBlckItm(itB.GetItem());
+                _blockings[curBlckItm["address"].As<string>()].push_back(curBlckItm["address_to"].As<string>());
+            }
+        }
+    }
+
+    auto putList = [](reindexer::JsonBuilder& entry, const char* name, const std::map<std::string, std::vector<std::string>>& lists, const std::string& address) {
+        auto arr = entry.Array(name);
+        auto it = lists.find(address);
+        if (it == lists.end()) return;
+        for (const auto& a : it->second)
+            arr.Put(nullptr, a);
+    };
+
     // Build return object array
     for (auto& it : _users_res) {
-        UniValue entry(UniValue::VOBJ);
         reindexer::Item itm = it.GetItem();
-        std::string _address = itm["address"].As<string>();
-
-        // Minimal fields for short form
-        entry.pushKV("address", _address);
-        entry.pushKV("name", itm["name"].As<string>());
-        entry.pushKV("id", itm["id"].As<int>() + 1);
-        entry.pushKV("i", itm["avatar"].As<string>());
-        entry.pushKV("b", itm["donations"].As<string>());
-        entry.pushKV("r", itm["referrer"].As<string>());
-        entry.pushKV("reputation", itm["reputation"].As<string>());
-
-        if (_posts_cnt.find(_address) != _posts_cnt.end()) {
-            entry.pushKV("postcnt", _posts_cnt[_address]);
-        }
-
-        // Count of referrals
-        size_t _referrals_count = g_pocketdb->SelectCount(reindexer::Query("UsersView").Where("referrer", CondEq, _address));
-        entry.pushKV("rc", (int)_referrals_count);
-
-        if (option == 1)
-            entry.pushKV("a", itm["about"].As<string>());
-
-        // In full form add other fields
-        if (!shortForm) {
-            entry.pushKV("regdate", itm["regdate"].As<int64_t>());
-            if (option != 1)
-                entry.pushKV("a", itm["about"].As<string>());
-            entry.pushKV("l", itm["lang"].As<string>());
-            entry.pushKV("s", itm["url"].As<string>());
-            entry.pushKV("update", itm["time"].As<int64_t>());
-            entry.pushKV("k", itm["pubkey"].As<string>());
-            //entry.pushKV("birthday", itm["birthday"].As<int>());
-            //entry.pushKV("gender", itm["gender"].As<int>());
-
-            // Subscribes
-            reindexer::QueryResults queryResSubscribes;
-            reindexer::Error errS = g_pocketdb->DB()->Select(
-                reindexer::Query("SubscribesView")
-                    .Where("address", CondEq, _address),
-                queryResSubscribes);
-
-            UniValue aS(UniValue::VARR);
-            if (errS.ok() && queryResSubscribes.Count() > 0) {
-                for (auto itS : queryResSubscribes) {
-                    UniValue entryS(UniValue::VOBJ);
-                    reindexer::Item curSbscrbItm(itS.GetItem());
-                    entryS.pushKV("adddress", curSbscrbItm["address_to"].As<string>());
-                    entryS.pushKV("private", curSbscrbItm["private"].As<string>());
-                    aS.push_back(entryS);
-                }
-            }
-            entry.pushKV("subscribes", aS);
-
-            // Subscribers
-            reindexer::QueryResults queryResSubscribers;
-            reindexer::Error errRS = g_pocketdb->DB()->Select(
-                reindexer::Query("SubscribesView")
-                    .Where("address_to", CondEq, _address)
-                    .Where("private", CondEq, false),
-                queryResSubscribers);
-
-            UniValue arS(UniValue::VARR);
-            if (errRS.ok() && queryResSubscribers.Count() > 0) {
-                for (auto itS : queryResSubscribers) {
-                    reindexer::Item curSbscrbItm(itS.GetItem());
-                    arS.push_back(curSbscrbItm["address"].As<string>());
-                }
+        std::string _address = PocketSchema::UsersView::address.String(itm);
+
+        reindexer::WrSerializer ser;
+        {
+            reindexer::JsonBuilder entry(ser);
+
+            // Minimal fields for short form
+            entry.Put("address", _address);
+            PutItemString(entry, "name", itm, PocketSchema::UsersView::name);
+            entry.Put("id", PocketSchema::UsersView::id.Int(itm) + 1);
+            PutItemString(entry, "i", itm, PocketSchema::UsersView::avatar);
+            PutItemString(entry, "b", itm, PocketSchema::UsersView::donations);
+            PutItemString(entry, "r", itm, PocketSchema::UsersView::referrer);
+            PutItemString(entry, "reputation", itm, PocketSchema::UsersView::reputation);
+
+            if (_posts_cnt.find(_address) != _posts_cnt.end()) {
+                entry.Put("postcnt", _posts_cnt[_address]);
             }
-            entry.pushKV("subscribers", arS);
-
-            // Blockings
-            reindexer::QueryResults queryResBlockings;
-            reindexer::Error errRB = g_pocketdb->DB()->Select(
-                reindexer::Query("BlockingView")
-                    .Where("address", CondEq, _address),
-                queryResBlockings);
-
-            UniValue arB(UniValue::VARR);
-            if (errRB.ok() && queryResBlockings.Count() > 0) {
-                for (auto itB : queryResBlockings) {
-                    reindexer::Item curBlckItm(itB.GetItem());
-                    arB.push_back(curBlckItm["address_to"].As<string>());
+
+            // Count of referrals
+            entry.Put("rc", _referrals_cnt[_address]);
+
+            if (option == 1)
+                PutItemString(entry, "a", itm, PocketSchema::UsersView::about);
+
+            // In full form add other fields
+            if (!shortForm) {
+                entry.Put("regdate", PocketSchema::UsersView::regdate.Int64(itm));
+                if (option != 1)
+                    PutItemString(entry, "a", itm, PocketSchema::UsersView::about);
+                PutItemString(entry, "l", itm, PocketSchema::UsersView::lang);
+                PutItemString(entry, "s", itm, PocketSchema::UsersView::url);
+                entry.Put("update", PocketSchema::UsersView::time.Int64(itm));
+                PutItemString(entry, "k", itm, PocketSchema::UsersView::pubkey);
+                //entry.pushKV("birthday", itm["birthday"].As<int>());
+                //entry.pushKV("gender", itm["gender"].As<int>());
+
+                {
+                    auto aS = entry.Array("subscribes");
+                    auto itS = _subscribes.find(_address);
+                    if (itS != _subscribes.end()) {
+                        for (const auto& sbscr : itS->second) {
+                            auto entryS = aS.Object();
+                            entryS.Put("adddress", sbscr.first);
+                            entryS.Put("private", sbscr.second);
+                        }
+                    }
                 }
-            }
-            entry.pushKV("blocking", arB);
 
-            // Recommendations subscribtions
-            std::vector<string> recomendedSubscriptions;
-            g_addrindex->GetRecomendedSubscriptions(_address, 10, recomendedSubscriptions);
+                putList(entry, "subscribers", _subscribers, _address);
+                putList(entry, "blocking", _blockings, _address);
 
-            UniValue rs(UniValue::VARR);
-            for (std::string r : recomendedSubscriptions) {
-                rs.push_back(r);
+                // Recommendations subscribtions
+                std::vector<string> recomendedSubscriptions;
+                g_addrindex->GetRecomendedSubscriptions(_address, 10, recomendedSubscriptions);
+
+                auto rs = entry.Array("recomendedSubscribes");
+                for (const std::string& r : recomendedSubscriptions) {
+                    rs.Put(nullptr, r);
+                }
             }
-            entry.pushKV("recomendedSubscribes", rs);
         }
 
-        result.insert_or_assign(_address, entry);
+        result.insert_or_assign(_address, RawJSON(ser));
     }
 
     return result;
@@ -3185,15 +3169,16 @@ UniValue searchtags(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() < 1) {
         throw std::runtime_error(
-            "searchtags search_string count\n"
-            "\nReturns array of found tags.\n"
+            "searchtags search_string count lang\n"
+            "\nReturns tags starting with search string ordered by frequency usage.\n"
             "\nArguments:\n"
-            "1. search_string      (string) Symbols for search (minimum 3 symbols)\n"
-            "2. count              (int) Max count results\n"
+            "1. search_string      (string) Tag prefix\n"
+            "2. count              (int, optional) Max count results\n"
+            "3. lang               (string, optional) Search only in posts with this language\n"
             "\nResult\n"
-            "[                     (array of tags with frequency usage)\n"
+            "{                     (object of tags with frequency usage)\n"
             "  ...\n"
-            "]");
+            "}");
     }
 
     std::string search_string;
@@ -3207,11 +3192,18 @@ UniValue searchtags(const JSONRPCRequest& request)
         ParseInt32(request.params[1].get_str(), &count);
     }
 
-    int totalCount = 0;
-    std::map<std::string, int> foundTags;
-    g_pocketdb->SearchTags(search_string, count, foundTags, totalCount);
+    std::string lang = "";
+    if (request.params.size() >= 3) {
+        RPCTypeCheckArgument(request.params[2], UniValue::VSTR);
+        lang = request.params[2].get_str();
+    }
 
     UniValue a(UniValue::VOBJ);
+    if (search_string.empty()) return a;
+
+    if (g_pocketindex) g_pocketindex->BlockUntilSyncedToCurrentChain();
+    std::vector<std::pair<std::string, int>> foundTags;
+    g_tagindex->Search(search_string, lang, count, foundTags);
     for (auto& p : foundTags) {
         a.pushKV(p.first, p.second);
     }
@@ -3253,6 +3245,22 @@ void getFastSearchString(std::string search, std::string str, std::map<std::stri
     }
 }
 
+// Trim and collapse whitespaces so equal queries share one cache entry
+static std::string NormalizeSearchString(const std::string& str)
+{
+    std::string ret;
+    ret.reserve(str.size());
+    for (char c : str) {
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            if (!ret.empty() && ret.back() != ' ') ret += ' ';
+        } else {
+            ret += c;
+        }
+    }
+    if (!ret.empty() && ret.back() == ' ') ret.pop_back();
+    return ret;
+}
+
 UniValue search(const JSONRPCRequest& request, int version = 0)
 {
     if (request.fHelp)
@@ -3266,7 +3274,7 @@ UniValue search(const JSONRPCRequest& request, int version = 0)
     std::string search_string = "";
     if (request.params.size() > 0) {
         RPCTypeCheckArgument(request.params[0], UniValue::VSTR);
-        search_string = UrlDecode(request.params[0].get_str());
+        search_string = NormalizeSearchString(UrlDecode(request.params[0].get_str()));
     }
 
     std::string type = "";
@@ -3309,6 +3317,20 @@ UniValue search(const JSONRPCRequest& request, int version = 0)
         address = request.params[5].get_str();
     }
 
+    // --- Repeated searches between blocks are served from cache
+    std::string cacheKey;
+    if (g_search_cache) {
+        uint256 tip;
+        {
+            LOCK(cs_main);
+            tip = chainActive.Tip()->GetBlockHash();
+        }
+
+        cacheKey = strprintf("%s|%s|%d|%d|%d|%s|%d|%s", search_string, type, blockNumber, resultStart, resulCount, address, version, tip.GetHex());
+        UniValue cached;
+        if (g_search_cache->Get(cacheKey, cached)) return cached;
+    }
+
     int fsresultCount = 10;
 
     // --- Return object -----------------------------------------------
@@ -3334,7 +3356,8 @@ UniValue search(const JSONRPCRequest& request, int version = 0)
                               .ReqTotal(),
                           resPostsBySearchString)
                 .ok()) {
-            UniValue aPosts(UniValue::VARR);
+            reindexer::WrSerializer serPosts;
+            reindexer::JsonBuilder aPosts(serPosts, reindexer::JsonBuilder::TypeArray);
 
             for (auto& it : resPostsBySearchString) {
                 Item _itm = it.GetItem();
@@ -3345,13 +3368,17 @@ UniValue search(const JSONRPCRequest& request, int version = 0)
                 if (fs) getFastSearchString(search_string, _caption, mFastSearch);
                 if (fs) getFastSearchString(search_string, _message, mFastSearch);
 
-                if (all || type == "posts") aPosts.push_back(getPostData(_itm, "", version));
+                if (all || type == "posts") {
+                    auto entry = aPosts.Object();
+                    getPostData(entry, _itm, "", version);
+                }
             }
+            aPosts.End();
 
             if (all || type == "posts") {
                 UniValue oPosts(UniValue::VOBJ);
                 oPosts.pushKV("count", resPostsBySearchString.totalCount);
-                oPosts.pushKV("data", aPosts);
+                oPosts.pushKV("data", RawJSON(serPosts));
                 result.pushKV("posts", oPosts);
             }
         }
@@ -3418,6 +3445,8 @@ UniValue search(const JSONRPCRequest& request, int version = 0)
         result.pushKV("fastsearch", fastsearch);
     }
 
+    if (g_search_cache) g_search_cache->Put(cacheKey, result);
+
     return result;
 }
 
@@ -3555,34 +3584,85 @@ UniValue gettags(const JSONRPCRequest& request)
         ParseInt32(request.params[2].get_str(), &from);
     }
 
-    std::map<std::string, int> mapTags;
-    reindexer::QueryResults posts;
-    g_pocketdb->Select(reindexer::Query("Posts").Where("block", CondGe, from).Where("address", address == "" ? CondGt : CondEq, address), posts);
-    for (auto& p : posts) {
-        reindexer::Item postItm = p.GetItem();
+    std::string lang = "";
+    if (request.params.size() >= 4) {
+        RPCTypeCheckArgument(request.params[3], UniValue::VSTR);
+        lang = request.params[3].get_str();
+    }
 
-        UniValue t(UniValue::VARR);
-        reindexer::VariantArray va = postItm["tags"];
-        for (unsigned int idx = 0; idx < va.size(); idx++) {
-            std::string sTag = lower(va[idx].As<string>());
-            if (std::all_of(sTag.begin(), sTag.end(), [](unsigned char ch) { return ::isdigit(ch) || ::isalpha(ch); })) {
-                if (mapTags.count(sTag) == 0)
-                    mapTags[sTag] = 1;
-                else
-                    mapTags[sTag] = mapTags[sTag] + 1;
+    // Only tags of latin letters and digits are returned
+    TagIndex::Filter alnum = [](const std::string& tag) {
+        return std::all_of(tag.begin(), tag.end(), [](unsigned char ch) { return ::isdigit(ch) || ::isalpha(ch); });
+    };
+
+    if (g_pocketindex) g_pocketindex->BlockUntilSyncedToCurrentChain();
+    std::vector<std::pair<std::string, int>> vTags;
+    if (address == "") {
+        g_tagindex->GetTopFrom(lang, count, from, vTags, alnum);
+    } else {
+        std::map<std::string, int> mapTags;
+        reindexer::QueryResults posts;
+        reindexer::Query query = reindexer::Query("Posts").Where("block", CondGe, from).Where("address", CondEq, address);
+        if (lang != "") query.Where("lang", CondEq, lang);
+        g_pocketdb->Select(query, posts);
+        for (auto& p : posts) {
+            reindexer::Item postItm = p.GetItem();
+            reindexer::VariantArray va = postItm["tags"];
+            for (unsigned int idx = 0; idx < va.size(); idx++) {
+                std::string sTag = TagIndex::Normalize(va[idx].As<string>());
+                if (sTag != "" && alnum(sTag)) mapTags[sTag] += 1;
             }
         }
+
+        vTags.assign(mapTags.begin(), mapTags.end());
+        std::sort(vTags.begin(), vTags.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) {
+            return a.second != b.second ? a.second > b.second : a.first < b.first;
+        });
+        if ((int)vTags.size() > count) vTags.resize(std::max(count, 0));
+    }
+
+    UniValue aResult(UniValue::VARR);
+    for (auto& t : vTags) {
+        UniValue oTag(UniValue::VOBJ);
+        oTag.pushKV("tag", t.first);
+        oTag.pushKV("count", std::to_string(t.second));
+
+        aResult.push_back(oTag);
+    }
+
+    return aResult;
+}
+
+UniValue gettrendingtags(const JSONRPCRequest& request)
+{
+    if (request.fHelp)
+        throw std::runtime_error(
+            "gettrendingtags count lang\n"
+            "\nReturns most used tags in posts from recent blocks (see -tagwindow).\n"
+            "\nArguments:\n"
+            "1. count              (int, optional) Max count results\n"
+            "2. lang               (string, optional) Only posts with this language\n");
+
+    int count = 50;
+    if (request.params.size() >= 1) {
+        ParseInt32(request.params[0].get_str(), &count);
+    }
+
+    std::string lang = "";
+    if (request.params.size() >= 2) {
+        RPCTypeCheckArgument(request.params[1], UniValue::VSTR);
+        lang = request.params[1].get_str();
     }
 
-    typedef std::function<bool(std::pair<std::string, int>, std::pair<std::string, int>)> Comparator;
-    Comparator compFunctor = [](std::pair<std::string, int> elem1, std::pair<std::string, int> elem2) { return elem1.second > elem2.second; };
-    std::set<std::pair<std::string, int>, Comparator> setTags(mapTags.begin(), mapTags.end(), compFunctor);
+    if (g_pocketindex) g_pocketindex->BlockUntilSyncedToCurrentChain();
+    std::vector<std::pair<std::string, int>> vTags;
+    g_tagindex->GetTop(lang, count, true, vTags);
 
     UniValue aResult(UniValue::VARR);
-    for (std::set<std::pair<std::string, int>, Comparator>::iterator it = setTags.begin(); it != setTags.end() && count; ++it, --count) {
+    for (auto& t : vTags) {
         UniValue oTag(UniValue::VOBJ);
-        oTag.pushKV("tag", it->first);
-        oTag.pushKV("count", std::to_string(it->second));
+        oTag.pushKV("tag", t.first);
+        oTag.pushKV("count", std::to_string(t.second));
 
         aResult.push_back(oTag);
     }
@@ -3693,34 +3773,35 @@ static const CRPCCommand commands[] =
     { "rawtransactions",    "createpsbt",                           &createpsbt,                        {"inputs","outputs","locktime","replaceable"} },
     { "rawtransactions",    "converttopsbt",                        &converttopsbt,                     {"hexstring","permitsigdata","iswitness"} },
     { "rawtransactions",    "sendrawtransactionwithmessage",        &sendrawtransactionwithmessage,     {"hexstring", "message", "type"} },
-    { "rawtransactions",    "getrawtransactionwithmessage",         &getrawtransactionwithmessage,      { "address_from", "address_to", "start_txid", "count" } },
-    { "rawtransactions",    "getrawtransactionwithmessage2",        &getrawtransactionwithmessage2,     { "address_from", "address_to", "start_txid", "count" } },
-    { "rawtransactions",    "getrawtransactionwithmessagebyid",     &getrawtransactionwithmessagebyid,  { "txs","address" } },
-    { "rawtransactions",    "getrawtransactionwithmessagebyid2",    &getrawtransactionwithmessagebyid2, { "txs","address" } },
-    { "rawtransactions",    "getuserprofile",                       &getuserprofile,                    { "addresses", "short" } },
-    { "rawtransactions",    "getmissedinfo",                        &getmissedinfo,                     { "address", "blocknumber" } },
-    { "rawtransactions",    "getmissedinfo2",                       &getmissedinfo2,                    { "address", "blocknumber" } },
+    { "rawtransactions",    "getrawtransactionwithmessage",         &getrawtransactionwithmessage,      { "address_from", "address_to", "start_txid", "count" }, true },
+    { "rawtransactions",    "getrawtransactionwithmessage2",        &getrawtransactionwithmessage2,     { "address_from", "address_to", "start_txid", "count" }, true },
+    { "rawtransactions",    "getrawtransactionwithmessagebyid",     &getrawtransactionwithmessagebyid,  { "txs","address" }, true },
+    { "rawtransactions",    "getrawtransactionwithmessagebyid2",    &getrawtransactionwithmessagebyid2, { "txs","address" }, true },
+    { "rawtransactions",    "getuserprofile",                       &getuserprofile,                    { "addresses", "short" }, true },
+    { "rawtransactions",    "getmissedinfo",                        &getmissedinfo,                     { "address", "blocknumber" }, true },
+    { "rawtransactions",    "getmissedinfo2",                       &getmissedinfo2,                    { "address", "blocknumber" }, true },
     { "rawtransactions",    "txunspent",                            &txunspent,                         { "addresses","minconf","maxconf","include_unsafe","query_options" } },
-    { "rawtransactions",    "getaddressregistration",               &getaddressregistration,            { "addresses" } },
-    { "rawtransactions",    "getuserstate",                         &getuserstate,                      { "address", "time" } },
-    { "rawtransactions",    "gettime",                              &gettime,                           {} },
-    { "rawtransactions",    "getrecommendedposts",                  &getrecommendedposts,               { "address", "count" } },
-    { "rawtransactions",    "getrecommendedposts2",                 &getrecommendedposts2,              { "address", "count" } },
-    { "rawtransactions",    "searchtags",                           &searchtags,                        { "search_string", "count" } },
-    { "rawtransactions",    "search",                               &search,                            { "search_string", "type", "count" } },
-    { "rawtransactions",    "search2",                              &search2,                           { "search_string", "type", "count" } },
-    { "rawtransactions",    "gethotposts",                          &gethotposts,                       { "count", "depth" } },
-    { "rawtransactions",    "gethotposts2",                         &gethotposts2,                      { "count", "depth" } },
-    { "rawtransactions",    "getuseraddress",                       &getuseraddress,                    { "name", "count" } },
-	{ "rawtransactions",    "getreputations",                       &getreputations,                    {} },
-	{ "rawtransactions",    "getcontents",                          &getcontents,                       { "address" } },
-	{ "rawtransactions",    "gettags",                              &gettags,                           { "address", "count" } },
+    { "rawtransactions",    "getaddressregistration",               &getaddressregistration,            { "addresses" }, true },
+    { "rawtransactions",    "getuserstate",                         &getuserstate,                      { "address", "time" }, true },
+    { "rawtransactions",    "gettime",                              &gettime,                           {}, true },
+    { "rawtransactions",    "getrecommendedposts",                  &getrecommendedposts,               { "address", "count" }, true },
+    { "rawtransactions",    "getrecommendedposts2",                 &getrecommendedposts2,              { "address", "count" }, true },
+    { "rawtransactions",    "searchtags",                           &searchtags,                        { "search_string", "count", "lang" }, true },
+    { "rawtransactions",    "search",                               &search,                            { "search_string", "type", "count" }, true },
+    { "rawtransactions",    "search2",                              &search2,                           { "search_string", "type", "count" }, true },
+    { "rawtransactions",    "gethotposts",                          &gethotposts,                       { "count", "depth" }, true, true },
+    { "rawtransactions",    "gethotposts2",                         &gethotposts2,                      { "count", "depth" }, true, true },
+    { "rawtransactions",    "getuseraddress",                       &getuseraddress,                    { "name", "count" }, true },
+	{ "rawtransactions",    "getreputations",                       &getreputations,                    {}, true },
+	{ "rawtransactions",    "getcontents",                          &getcontents,                       { "address" }, true },
+	{ "rawtransactions",    "gettags",                              &gettags,                           { "address", "count", "from", "lang" }, true, true },
+    { "rawtransactions",    "gettrendingtags",                      &gettrendingtags,                   { "count", "lang" }, true },
 
     { "blockchain",         "gettxoutproof",                        &gettxoutproof,                     {"txids", "blockhash"} },
     { "blockchain",         "verifytxoutproof",                     &verifytxoutproof,                  {"proof"} },
 
     { "rawtransactions",    "debug",                                &debug,                             {} },
-    { "rawtransactions",    "getaddressbalance",                    &getaddressbalance,                 { "address" } },
+    { "rawtransactions",    "getaddressbalance",                    &getaddressbalance,                 { "address" }, true },
 };
 // clang-format on
 
@@ -6,6 +6,9 @@
 #include <rpc/server.h>
 
 #include <fs.h>
+#include <index/pocketindex.h>
+#include <rpc/cache.h>
+#include <rpc/stats.h>
 #include <key_io.h>
 #include <random.h>
 #include <shutdown.h>
@@ -13,13 +16,18 @@
 #include <ui_interface.h>
 #include <util.h>
 #include <utilstrencodings.h>
+#include <validation.h>
 
 #include <boost/bind.hpp>
 #include <boost/signals2/signal.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <memory> // for unique_ptr
+#include <thread>
 #include <unordered_map>
 
 static CCriticalSection cs_rpcWarmup;
@@ -31,6 +39,75 @@ static RPCTimerInterface* timerInterface = nullptr;
 /* Map of name to timer. */
 static std::map<std::string, std::unique_ptr<RPCTimerBase> > deadlineTimers;
 
+/**
+ * Shared pool of threads executing read-only elements of JSON-RPC batches.
+ * Queued work is always finished before the threads exit, so HTTP workers
+ * waiting on results are never left blocked during shutdown.
+ */
+class CRPCBatchExecutor
+{
+private:
+    std::mutex cs;
+    std::condition_variable cond;
+    std::deque<std::function<void()>> queue;
+    std::vector<std::thread> threads;
+    bool running = false;
+
+    void ThreadWorker()
+    {
+        RenameThread("pocketcoin-rpcbatch");
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(cs);
+                cond.wait(lock, [this] { return !running || !queue.empty(); });
+                if (queue.empty()) return;
+                task = std::move(queue.front());
+                queue.pop_front();
+            }
+            task();
+        }
+    }
+
+public:
+    void Start(int nThreads)
+    {
+        std::unique_lock<std::mutex> lock(cs);
+        if (running) return;
+        running = true;
+        for (int i = 0; i < nThreads; i++)
+            threads.emplace_back(&CRPCBatchExecutor::ThreadWorker, this);
+    }
+
+    void Stop()
+    {
+        {
+            std::unique_lock<std::mutex> lock(cs);
+            running = false;
+        }
+        cond.notify_all();
+        for (auto& thread : threads)
+            thread.join();
+        threads.clear();
+    }
+
+    /** Queue task for execution, run it in the calling thread if the pool is stopped */
+    void Submit(std::function<void()> task)
+    {
+        {
+            std::unique_lock<std::mutex> lock(cs);
+            if (running && !threads.empty()) {
+                queue.push_back(std::move(task));
+                cond.notify_one();
+                return;
+            }
+        }
+        task();
+    }
+};
+
+static CRPCBatchExecutor g_rpc_batch_executor;
+
 static struct CRPCSignals
 {
     boost::signals2::signal<void ()> Started;
@@ -304,6 +381,8 @@ void StartRPC()
 {
     LogPrint(BCLog::RPC, "Starting RPC\n");
     fRPCRunning = true;
+    g_rpc_batch_executor.Start(std::max((int)gArgs.GetArg("-rpcbatchthreads", DEFAULT_RPC_BATCH_THREADS), 0));
+    g_rpc_stats.SetSlowCallTime(gArgs.GetArg("-rpcslowcalltime", DEFAULT_RPC_SLOW_CALL_TIME));
     g_rpcSignals.Started();
 }
 
@@ -318,6 +397,7 @@ void StopRPC()
 {
     LogPrint(BCLog::RPC, "Stopping RPC\n");
     deadlineTimers.clear();
+    g_rpc_batch_executor.Stop();
     DeleteAuthCookie();
     g_rpcSignals.Stopped();
 }
@@ -411,13 +491,50 @@ static UniValue JSONRPCExecOne(JSONRPCRequest jreq, const UniValue& req)
     return rpc_result;
 }
 
+static bool IsReadOnlyRequest(const UniValue& req)
+{
+    if (!req.isObject()) return false;
+    const UniValue& method = find_value(req.get_obj(), "method");
+    if (!method.isStr()) return false;
+    const CRPCCommand* pcmd = tableRPC[method.get_str()];
+    return pcmd && pcmd->readOnly;
+}
+
 std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq)
 {
-    UniValue ret(UniValue::VARR);
-    for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++)
-        ret.push_back(JSONRPCExecOne(jreq, vReq[reqIdx]));
+    // Runs of read-only calls are executed in parallel, any other call
+    // waits for everything before it so batch order is preserved
+    std::vector<std::future<UniValue>> results;
+    results.reserve(vReq.size());
+    for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++) {
+        if (!IsReadOnlyRequest(vReq[reqIdx])) {
+            for (auto& result : results) result.wait();
+
+            std::promise<UniValue> promise;
+            promise.set_value(JSONRPCExecOne(jreq, vReq[reqIdx]));
+            results.push_back(promise.get_future());
+            continue;
+        }
 
-    return ret.write() + "\n";
+        auto task = std::make_shared<std::packaged_task<UniValue()>>(std::bind(&JSONRPCExecOne, jreq, std::cref(vReq[reqIdx])));
+        results.push_back(task->get_future());
+        g_rpc_batch_executor.Submit([task] { (*task)(); });
+    }
+
+    // Serialize elements one by one to account reply bytes per method
+    std::string strReply = "[";
+    for (unsigned int reqIdx = 0; reqIdx < results.size(); reqIdx++) {
+        std::string strResult = JSONRPCWrite(results[reqIdx].get());
+        if (vReq[reqIdx].isObject()) {
+            const UniValue& method = find_value(vReq[reqIdx].get_obj(), "method");
+            if (method.isStr()) g_rpc_stats.AddBytes(method.get_str(), strResult.size());
+        }
+
+        if (reqIdx > 0) strReply += ",";
+        strReply += strResult;
+    }
+
+    return strReply + "]\n";
 }
 
 /**
@@ -470,6 +587,24 @@ static inline JSONRPCRequest transformNamedArguments(const JSONRPCRequest& in, c
     return out;
 }
 
+std::string CRPCTable::GetTipCacheKey(const JSONRPCRequest& request) const
+{
+    const CRPCCommand *pcmd = tableRPC[request.strMethod];
+    if (!pcmd || !pcmd->tipCached || request.fHelp)
+        return "";
+
+    uint256 tip;
+    {
+        LOCK(cs_main);
+        if (!chainActive.Tip()) return "";
+        tip = chainActive.Tip()->GetBlockHash();
+    }
+
+    // Named and positional forms of the same call share the key
+    UniValue params = (request.params.isObject() ? transformNamedArguments(request, pcmd->argNames).params : request.params);
+    return strprintf("%s|%s|%s", tip.GetHex(), request.strMethod, params.write());
+}
+
 UniValue CRPCTable::execute(const JSONRPCRequest &request) const
 {
     // Return immediately if in warmup
@@ -486,19 +621,37 @@ UniValue CRPCTable::execute(const JSONRPCRequest &request) const
 
     g_rpcSignals.PreCommand(*pcmd);
 
+    CRPCCallTimer timer(request);
     try
     {
+        // Calls depending only on chain tip are answered from cache between blocks
+        std::string tipKey = (g_tip_cache ? GetTipCacheKey(request) : "");
+        UniValue result;
+        if (!tipKey.empty() && g_tip_cache->Get(tipKey, result)) return result;
+
+        // Tags, comment tree and addresses of the keyed tip are written by PocketIndex
+        if (!tipKey.empty() && g_pocketindex) g_pocketindex->BlockUntilSyncedToCurrentChain();
+
         // Execute, convert arguments to array if necessary
         if (request.params.isObject()) {
-            return pcmd->actor(transformNamedArguments(request, pcmd->argNames));
+            result = pcmd->actor(transformNamedArguments(request, pcmd->argNames));
         } else {
-            return pcmd->actor(request);
+            result = pcmd->actor(request);
         }
+
+        if (!tipKey.empty()) g_tip_cache->Put(tipKey, result);
+        return result;
     }
     catch (const std::exception& e)
     {
+        timer.SetError();
         throw JSONRPCError(RPC_MISC_ERROR, e.what());
     }
+    catch (...)
+    {
+        timer.SetError();
+        throw;
+    }
 }
 
 std::vector<std::string> CRPCTable::listCommands() const
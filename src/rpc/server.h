@@ -135,6 +135,10 @@ public:
     std::string name;
     rpcfn_type actor;
     std::vector<std::string> argNames;
+    /** Command does not change node state and may run in parallel with other such commands of a batch */
+    bool readOnly = false;
+    /** Result depends only on params and chain tip, so it is cached until the next block and served with ETag */
+    bool tipCached = false;
 };
 
 /**
@@ -149,6 +153,12 @@ public:
     const CRPCCommand* operator[](const std::string& name) const;
     std::string help(const std::string& name, const JSONRPCRequest& helpreq) const;
 
+    /**
+     * Key of the call result for commands with tipCached: chain tip, method and
+     * positional params. Empty for other commands.
+     */
+    std::string GetTipCacheKey(const JSONRPCRequest& request) const;
+
     /**
      * Execute a method.
      * @param request The JSONRPCRequest to execute
@@ -198,6 +208,8 @@ extern CAmount AmountFromValue(const UniValue& value);
 extern std::string HelpExampleCli(const std::string& methodname, const std::string& args);
 extern std::string HelpExampleRpc(const std::string& methodname, const std::string& args);
 
+static const int DEFAULT_RPC_BATCH_THREADS = 4;
+
 void StartRPC();
 void InterruptRPC();
 void StopRPC();
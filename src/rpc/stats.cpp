@@ -0,0 +1,156 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/stats.h>
+
+#include <tinyformat.h>
+#include <util.h>
+#include <utiltime.h>
+
+#include "reindexer/core/reindexer.h"
+
+#include <algorithm>
+#include <limits>
+
+CRPCStats g_rpc_stats;
+
+/** Limits of data kept for the slow-call log */
+static const size_t MAX_SLOW_CALL_QUERIES = 100;
+static const size_t MAX_SLOW_CALL_PARAMS = 1000;
+
+const std::vector<int64_t>& CRPCStats::Buckets()
+{
+    static const std::vector<int64_t> buckets{
+        100, 250, 500,
+        1000, 2500, 5000,
+        10000, 25000, 50000,
+        100000, 250000, 500000,
+        1000000, 2500000, 5000000,
+        10000000, std::numeric_limits<int64_t>::max()};
+    return buckets;
+}
+
+int64_t CRPCStats::CMethodStats::Percentile(double q) const
+{
+    if (nCalls == 0) return 0;
+
+    uint64_t rank = std::max<uint64_t>(1, (uint64_t)(q * nCalls + 0.5));
+    uint64_t count = 0;
+    for (size_t i = 0; i < vHistogram.size(); i++) {
+        count += vHistogram[i];
+        if (count >= rank) return std::min(Buckets()[i], nMaxMicros);
+    }
+    return nMaxMicros;
+}
+
+void CRPCStats::AddCall(const std::string& method, int64_t nMicros, bool fError)
+{
+    const auto& buckets = Buckets();
+    size_t bucket = std::lower_bound(buckets.begin(), buckets.end(), nMicros) - buckets.begin();
+
+    LOCK(cs);
+    CMethodStats& stats = mapMethods[method];
+    if (stats.vHistogram.empty()) stats.vHistogram.resize(buckets.size());
+
+    stats.nCalls++;
+    if (fError) stats.nErrors++;
+    stats.nTotalMicros += nMicros;
+    stats.nMaxMicros = std::max(stats.nMaxMicros, nMicros);
+    stats.vHistogram[std::min(bucket, buckets.size() - 1)]++;
+}
+
+void CRPCStats::AddBytes(const std::string& method, uint64_t nBytes)
+{
+    LOCK(cs);
+    auto it = mapMethods.find(method);
+    if (it != mapMethods.end()) it->second.nBytesOut += nBytes;
+}
+
+std::map<std::string, CRPCStats::CMethodStats> CRPCStats::GetStats() const
+{
+    LOCK(cs);
+    return mapMethods;
+}
+
+void CRPCStats::Reset()
+{
+    LOCK(cs);
+    mapMethods.clear();
+}
+
+std::string CRPCStats::ToPrometheus() const
+{
+    const auto& buckets = Buckets();
+    auto methods = GetStats();
+
+    std::string result;
+    result += "# TYPE pocketcoin_rpc_calls_total counter\n";
+    for (const auto& m : methods)
+        result += strprintf("pocketcoin_rpc_calls_total{method=\"%s\"} %u\n", m.first, m.second.nCalls);
+
+    result += "# TYPE pocketcoin_rpc_errors_total counter\n";
+    for (const auto& m : methods)
+        result += strprintf("pocketcoin_rpc_errors_total{method=\"%s\"} %u\n", m.first, m.second.nErrors);
+
+    result += "# TYPE pocketcoin_rpc_bytes_out_total counter\n";
+    for (const auto& m : methods)
+        result += strprintf("pocketcoin_rpc_bytes_out_total{method=\"%s\"} %u\n", m.first, m.second.nBytesOut);
+
+    result += "# TYPE pocketcoin_rpc_duration_seconds histogram\n";
+    for (const auto& m : methods) {
+        uint64_t count = 0;
+        for (size_t i = 0; i < buckets.size(); i++) {
+            count += m.second.vHistogram[i];
+            std::string le = (i + 1 < buckets.size() ? strprintf("%g", buckets[i] / 1e6) : "+Inf");
+            result += strprintf("pocketcoin_rpc_duration_seconds_bucket{method=\"%s\",le=\"%s\"} %u\n", m.first, le, count);
+        }
+        result += strprintf("pocketcoin_rpc_duration_seconds_sum{method=\"%s\"} %g\n", m.first, m.second.nTotalMicros / 1e6);
+        result += strprintf("pocketcoin_rpc_duration_seconds_count{method=\"%s\"} %u\n", m.first, m.second.nCalls);
+    }
+
+    return result;
+}
+
+/** Collects reindexer queries of the current thread while installed */
+class CRPCQueryTrace final : public reindexer::IQueryTracer
+{
+public:
+    std::vector<std::pair<std::string, int64_t>> vQueries;
+    size_t nSkipped = 0;
+
+    void OnQuery(const reindexer::string_view& sql, const reindexer::Error& err, int64_t elapsedUs) override
+    {
+        if (vQueries.size() >= MAX_SLOW_CALL_QUERIES) {
+            nSkipped++;
+            return;
+        }
+        vQueries.emplace_back(std::string(sql.data(), sql.size()), elapsedUs);
+    }
+};
+
+CRPCCallTimer::CRPCCallTimer(const JSONRPCRequest& requestIn) : request(requestIn), nStart(GetTimeMicros()), fError(false)
+{
+    if (g_rpc_stats.GetSlowCallMicros() > 0) {
+        trace.reset(new CRPCQueryTrace());
+        reindexer::Reindexer::SetQueryTracer(trace.get());
+    }
+}
+
+CRPCCallTimer::~CRPCCallTimer()
+{
+    int64_t nMicros = GetTimeMicros() - nStart;
+    g_rpc_stats.AddCall(request.strMethod, nMicros, fError);
+
+    if (!trace) return;
+    reindexer::Reindexer::SetQueryTracer(nullptr);
+    if (nMicros < g_rpc_stats.GetSlowCallMicros()) return;
+
+    std::string params = request.params.write();
+    if (params.size() > MAX_SLOW_CALL_PARAMS) params = params.substr(0, MAX_SLOW_CALL_PARAMS) + "...";
+
+    LogPrintf("Slow RPC call %s from %s: %.2fms, %u queries, params %s\n",
+        request.strMethod, request.peerAddr, nMicros * 0.001, trace->vQueries.size() + trace->nSkipped, params);
+    for (const auto& query : trace->vQueries)
+        LogPrintf("    %.2fms %s\n", query.second * 0.001, query.first);
+}
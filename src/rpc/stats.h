@@ -0,0 +1,85 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef POCKETCOIN_RPC_STATS_H
+#define POCKETCOIN_RPC_STATS_H
+
+#include <rpc/server.h>
+#include <sync.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** Calls slower than this are logged with their reindexer queries, 0 to disable */
+static const int64_t DEFAULT_RPC_SLOW_CALL_TIME = 0;
+static const bool DEFAULT_RPC_METRICS = false;
+
+/**
+ * Per-method RPC counters with a latency histogram.
+ * Bucket bounds are fixed, so percentiles are estimated as the upper
+ * bound of the bucket holding the requested rank.
+ */
+class CRPCStats
+{
+public:
+    struct CMethodStats
+    {
+        uint64_t nCalls = 0;
+        uint64_t nErrors = 0;
+        uint64_t nBytesOut = 0;
+        int64_t nTotalMicros = 0;
+        int64_t nMaxMicros = 0;
+        std::vector<uint64_t> vHistogram;
+
+        /** Estimated latency in microseconds below which `q` of calls fall */
+        int64_t Percentile(double q) const;
+    };
+
+    /** Upper bounds of histogram buckets in microseconds, the last bucket is unbounded */
+    static const std::vector<int64_t>& Buckets();
+
+    void AddCall(const std::string& method, int64_t nMicros, bool fError);
+    void AddBytes(const std::string& method, uint64_t nBytes);
+    std::map<std::string, CMethodStats> GetStats() const;
+    void Reset();
+    /** Counters in Prometheus text exposition format */
+    std::string ToPrometheus() const;
+
+    void SetSlowCallTime(int64_t nMillis) { nSlowCallMicros = nMillis * 1000; }
+    int64_t GetSlowCallMicros() const { return nSlowCallMicros; }
+
+private:
+    mutable CCriticalSection cs;
+    std::map<std::string, CMethodStats> mapMethods;
+    std::atomic<int64_t> nSlowCallMicros{0};
+};
+
+extern CRPCStats g_rpc_stats;
+
+class CRPCQueryTrace;
+
+/**
+ * Measures one RPC call in the current thread and records it on destruction.
+ * When slow-call logging is enabled it also collects reindexer queries
+ * issued by the call and logs them if the call was slow.
+ */
+class CRPCCallTimer
+{
+public:
+    explicit CRPCCallTimer(const JSONRPCRequest& request);
+    ~CRPCCallTimer();
+
+    void SetError() { fError = true; }
+
+private:
+    const JSONRPCRequest& request;
+    int64_t nStart;
+    bool fError;
+    std::unique_ptr<CRPCQueryTrace> trace;
+};
+
+#endif // POCKETCOIN_RPC_STATS_H
@@ -7,6 +7,10 @@
 #include <miner.h>
 #include <net.h>
 #include <pos.h>
+#include <pow.h>
+#include <txmempool.h>
+#include <util.h>
+#include <utiltime.h>
 #include <validation.h>
 #include <wallet/wallet.h>
 #include <script/sign.h>
@@ -14,6 +18,64 @@
 
 #include "index/addrindex.h"
 
+/** Kernel search of one wallet at one timestamp, buckets of coins are taken by any free thread */
+class StakeSearch {
+public:
+    StakeSearch(const CBlockIndex* pindexPrevIn, unsigned int nBitsIn, unsigned int nTimeIn, std::vector<CStakeCandidate>&& candidatesIn) :
+        pindexPrev(pindexPrevIn),
+        nBits(nBitsIn),
+        nTime(nTimeIn),
+        candidates(std::move(candidatesIn)),
+        nBuckets((candidates.size() + STAKER_BUCKET_SIZE - 1) / STAKER_BUCKET_SIZE),
+        nextBucket(0),
+        found(false),
+        tried(0),
+        nDone(0) {
+    }
+
+    /** Search buckets until none is left, remaining buckets are skipped once a kernel is found */
+    void Run() {
+        while (true) {
+            size_t bucket = nextBucket++;
+            if (bucket >= nBuckets) return;
+
+            size_t end = std::min(candidates.size(), (bucket + 1) * STAKER_BUCKET_SIZE);
+            for (size_t i = bucket * STAKER_BUCKET_SIZE; i < end && !found; i++) {
+                tried++;
+                if (CStakeKernelHasher(pindexPrev, nBits, candidates[i]).Check(nTime)) {
+                    found = true;
+                }
+            }
+
+            boost::lock_guard<boost::mutex> lock(mutex);
+            if (++nDone == nBuckets) cond.notify_all();
+        }
+    }
+
+    /** Wait for buckets taken by other threads */
+    void Wait() {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        while (nDone < nBuckets) cond.wait(lock);
+    }
+
+    bool Found() const { return found; }
+    uint64_t Tried() const { return tried; }
+
+private:
+    const CBlockIndex* pindexPrev;
+    unsigned int nBits;
+    unsigned int nTime;
+    std::vector<CStakeCandidate> candidates;
+    size_t nBuckets;
+    std::atomic<size_t> nextBucket;
+    std::atomic<bool> found;
+    std::atomic<uint64_t> tried;
+
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    size_t nDone;
+};
+
 Staker *Staker::getInstance() {
     static Staker instance;
     return &instance;
@@ -23,7 +85,8 @@ Staker::Staker() :
     workersStarted(false),
     isStaking(false),
     minerSleep(500),
-    lastCoinStakeSearchInterval(0) {
+    lastCoinStakeSearchInterval(0),
+    tipChanged(false) {
 }
 
 void Staker::setIsStaking(bool staking) {
@@ -38,136 +101,111 @@ uint64_t Staker::getLastCoinStakeSearchInterval() {
     return lastCoinStakeSearchInterval;
 }
 
+std::map<std::string, StakerWalletStats> Staker::getWalletStats() {
+    LOCK(cs_stats);
+    return walletStats;
+}
+
 void Staker::startWorkers(
     boost::thread_group & threadGroup,
     CChainParams const & chainparams,
+    int threads,
     unsigned int minerSleep
 ) {
     if (workersStarted) { return; }
     workersStarted = true;
 
     this->minerSleep = minerSleep;
+    RegisterValidationInterface(this);
+
     threadGroup.create_thread(
         boost::bind(
-            &Staker::run, this, boost::cref(chainparams), boost::ref(threadGroup)
+            &Staker::run, this, boost::cref(chainparams)
         )
     );
-}
-
-void Staker::run(CChainParams const & chainparams, boost::thread_group & threadGroup) {
-    while (true) {
-        auto wallets = GetWallets();
-
-        std::unordered_set<std::string> walletNames;
-
-        for (auto & wallet : wallets) {
-            std::string name(wallet->GetName());
-
-            if (walletWorkers.find(name) == walletWorkers.end()) {
-                // Create a worker thread for the wallet.
-                threadGroup.create_thread(
-                    boost::bind(
-                        &Staker::worker, this, boost::cref(chainparams), boost::cref(name)
-                    )
-                );
-                walletWorkers.insert(name);
-            }
-
-            walletNames.insert(name);
-        }
 
-        std::vector<std::string> removes;
+    threads = std::max(0, std::min(threads, MAX_STAKER_THREADS));
+    for (int i = 0; i < threads; i++) {
+        threadGroup.create_thread(boost::bind(&Staker::searchWorker, this));
+    }
+}
 
-        for (auto & name : walletWorkers) {
-            if (GetWallet(name) == nullptr) {
-                removes.push_back(name);
-            }
-        }
+void Staker::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) {
+    if (fInitialDownload) { return; }
 
-        MilliSleep(minerSleep * 10);
+    {
+        boost::lock_guard<boost::mutex> lock(wakeMutex);
+        tipChanged = true;
     }
+    wakeCond.notify_one();
 }
 
-void Staker::worker(
-    CChainParams const & chainparams, std::string const & walletName
-) {
-    LogPrintf("Staker thread started for %s\n", walletName);
+bool Staker::canStake(CChainParams const & chainparams) {
+    if (!isStaking) { return false; }
 
-    RenameThread("coin-staker");
+    if (chainparams.GetConsensus().fPosRequiresPeers) {
+        if (!g_connman || g_connman->GetNodeCount(CConnman::CONNECTIONS_ALL) == 0)
+            return false;
+        if (IsInitialBlockDownload())
+            return false;
+    }
 
-    bool running = true;
+    return chainparams.GetConsensus().nPosFirstBlock <= chainActive.Tip()->nHeight;
+}
 
-    int nLastCoinStakeSearchInterval = 0;
+void Staker::run(CChainParams const & chainparams) {
+    LogPrintf("Staker thread started\n");
 
-    auto coinbaseScript = std::make_shared<CReserveScript>();
+    RenameThread("coin-staker");
 
-    auto wallet = GetWallet(walletName);
-    if (!wallet) { return; }
-    wallet->GetScriptForMining(coinbaseScript);
+    int64_t nLastKernelSearchTime = GetAdjustedTime() & ~STAKE_TIMESTAMP_MASK;
+    const CBlockIndex* pindexLastSearch = nullptr;
+    int64_t nWait = 0;
 
     try {
-
-        if (!coinbaseScript || coinbaseScript->reserveScript.empty())
-            throw std::runtime_error("No coinbase script available (staking requires a wallet)");
-
-        while (running) {
-            auto wallet = GetWallet(walletName);
-
-            if (!wallet) {
-                running = false;
-                continue;
-            }
-
-            while (wallet->IsLocked()) {
-                nLastCoinStakeSearchInterval = 0;
-                MilliSleep(1000);
-            }
-
-            if (chainparams.GetConsensus().fPosRequiresPeers) {
-                do {
-                    bool fvNodesEmpty;
-                    {
-                        fvNodesEmpty = !g_connman || g_connman->GetNodeCount(
-                            CConnman::CONNECTIONS_ALL
-                        ) == 0;
-                    }
-                    if (!fvNodesEmpty && !IsInitialBlockDownload())
-                        break;
-                    MilliSleep(1000);
-                } while (true);
+        while (true) {
+            {
+                boost::unique_lock<boost::mutex> lock(wakeMutex);
+                if (!tipChanged && nWait > 0) {
+                    wakeCond.timed_wait(lock, boost::posix_time::milliseconds(nWait));
+                }
+                tipChanged = false;
             }
 
-            while (!isStaking) {
-                MilliSleep(1000);
+            nWait = 1000;
+            if (!canStake(chainparams)) {
+                continue;
             }
 
-            while (
-                chainparams.GetConsensus().nPosFirstBlock > chainActive.Tip()->nHeight
-                ) {
-                MilliSleep(30000);
-            }
+            // Kernel can only change with the masked coinstake timestamp
+            // or with the stake modifier of a new tip
+            int64_t nSearchTime = GetAdjustedTime() & ~STAKE_TIMESTAMP_MASK;
+            CBlockIndex* pindexTip = chainActive.Tip();
+            if (nSearchTime > nLastKernelSearchTime || pindexTip != pindexLastSearch) {
+                if (nSearchTime > nLastKernelSearchTime) {
+                    lastCoinStakeSearchInterval = nSearchTime - nLastKernelSearchTime;
+                    nLastKernelSearchTime = nSearchTime;
+                }
+                pindexLastSearch = pindexTip;
 
-            uint64_t nFees = 0;
-            auto assembler = BlockAssembler(chainparams);
-            auto blocktemplate = assembler.CreateNewBlock(
-                coinbaseScript->reserveScript, true, true, &nFees
-            );
+                CBlockHeader header;
+                header.nTime = nSearchTime;
+                unsigned int nBits = GetNextWorkRequired(pindexTip, &header, chainparams.GetConsensus());
 
-            // Write ReindexerDB current state to coinbase transaction
-            if (chainActive.Tip()->nHeight >= Params().GetConsensus().nHeight_version_1_0_0) {
-                g_addrindex->WriteRHash(blocktemplate->block, chainActive.Tip());
+                for (auto & wallet : GetWallets()) {
+                    if (wallet->IsLocked()) { continue; }
+                    try {
+                        stakeWallet(chainparams, wallet, pindexTip, nBits, nSearchTime);
+                    }
+                    catch (const std::runtime_error &e) {
+                        LogPrintf("Pocketcoin Staker runtime error for wallet %s: %s\n", wallet->GetName(), e.what());
+                    }
+                }
             }
-            
-            std::shared_ptr<CBlock> block = std::make_shared<CBlock>(blocktemplate->block);
 
-            if (signBlock(block, wallet, nFees)) {
-                LogPrintf("=== New PoS Block signed\n");
-                CheckStake(block, wallet, chainparams);
-                MilliSleep(500);
-            }
-            else {
-                MilliSleep(minerSleep);
-            }
+            // Sleep until the next masked timestamp
+            int64_t nNextSearchTime = nLastKernelSearchTime + STAKE_TIMESTAMP_MASK + 1;
+            nWait = std::max<int64_t>(minerSleep, (nNextSearchTime - GetAdjustedTime()) * 1000);
         }
     }
     catch (const boost::thread_interrupted&)
@@ -175,10 +213,99 @@ void Staker::worker(
         LogPrintf("Pocketcoin Staker terminated\n");
         throw;
     }
-    catch (const std::runtime_error &e)
+}
+
+void Staker::searchWorker() {
+    RenameThread("coin-staker-search");
+
+    std::shared_ptr<StakeSearch> last;
+    while (true) {
+        std::shared_ptr<StakeSearch> search;
+        {
+            boost::unique_lock<boost::mutex> lock(searchMutex);
+            while (currentSearch == last) searchCond.wait(lock);
+            search = last = currentSearch;
+        }
+        if (search) search->Run();
+    }
+}
+
+bool Staker::searchKernel(std::shared_ptr<StakeSearch> search) {
     {
-        LogPrintf("Pocketcoin Staker runtime error: %s\n", e.what());
-        return;
+        boost::lock_guard<boost::mutex> lock(searchMutex);
+        currentSearch = search;
+    }
+    searchCond.notify_all();
+
+    // Scheduler takes buckets as well, so search works without pool threads
+    search->Run();
+    search->Wait();
+
+    {
+        boost::lock_guard<boost::mutex> lock(searchMutex);
+        currentSearch.reset();
+    }
+    return search->Found();
+}
+
+void Staker::stakeWallet(
+    CChainParams const & chainparams, std::shared_ptr<CWallet> wallet,
+    CBlockIndex * pindexTip, unsigned int nBits, int64_t nSearchTime
+) {
+    std::string name(wallet->GetName());
+
+    std::vector<CStakeCandidate> vCandidates;
+    if (!wallet->GetStakeCandidates(nSearchTime, vCandidates)) { return; }
+
+    int64_t nStart = GetTime();
+    auto search = std::make_shared<StakeSearch>(pindexTip, nBits, nSearchTime, std::move(vCandidates));
+    bool found = searchKernel(search);
+
+    {
+        LOCK(cs_stats);
+        StakerWalletStats & stats = walletStats[name];
+        if (stats.searchStart == 0) { stats.searchStart = nStart; }
+        stats.kernelsTried += search->Tried();
+        if (found) {
+            stats.kernelsFound++;
+            stats.lastTimeToFind = GetTime() - stats.searchStart;
+            stats.totalTimeToFind += stats.lastTimeToFind;
+            stats.searchStart = 0;
+        }
+    }
+
+    if (!found) { return; }
+
+    StakeTemplate & stakeTemplate = templates[name];
+    if (!stakeTemplate.coinbaseScript) {
+        wallet->GetScriptForMining(stakeTemplate.coinbaseScript);
+        if (!stakeTemplate.coinbaseScript || stakeTemplate.coinbaseScript->reserveScript.empty()) {
+            LogPrintf("Pocketcoin Staker: no coinbase script available for wallet %s\n", name);
+            stakeTemplate.coinbaseScript.reset();
+            return;
+        }
+    }
+
+    if (!stakeTemplate.blocktemplate || stakeTemplate.hashTip != pindexTip->GetBlockHash() || stakeTemplate.nMempoolUpdated != mempool.GetTransactionsUpdated()) {
+        stakeTemplate.hashTip = pindexTip->GetBlockHash();
+        stakeTemplate.nMempoolUpdated = mempool.GetTransactionsUpdated();
+
+        stakeTemplate.nFees = 0;
+        stakeTemplate.blocktemplate = BlockAssembler(chainparams).CreateNewBlock(
+            stakeTemplate.coinbaseScript->reserveScript, true, true, &stakeTemplate.nFees
+        );
+
+        // Write ReindexerDB current state to coinbase transaction
+        if (pindexTip->nHeight >= Params().GetConsensus().nHeight_version_1_0_0) {
+            g_addrindex->WriteRHash(stakeTemplate.blocktemplate->block, pindexTip);
+        }
+    }
+
+    std::shared_ptr<CBlock> block = std::make_shared<CBlock>(stakeTemplate.blocktemplate->block);
+
+    if (signBlock(block, wallet, stakeTemplate.nFees)) {
+        LogPrintf("=== New PoS Block signed\n");
+        CheckStake(block, wallet, chainparams);
     }
 }
 
@@ -200,75 +327,64 @@ bool Staker::signBlock(
         return true;
     }
 
-    static int64_t nLastCoinStakeSearchTime = GetAdjustedTime();
-
     CKey key;
     CMutableTransaction txCoinStake;
     CTransaction txNew;
-    int nBestHeight = chainActive.Tip()->nHeight;
 
     txCoinStake.nTime = GetAdjustedTime();
     txCoinStake.nTime &= ~STAKE_TIMESTAMP_MASK;
 
-    int64_t nSearchTime = txCoinStake.nTime;
-
-    if (nSearchTime > nLastCoinStakeSearchTime)
-    {
-        int64_t nSearchInterval = nBestHeight + 1 > 0 ? 1 : nSearchTime - nLastCoinStakeSearchTime;
-        if (wallet->CreateCoinStake(*wallet.get(), block->nBits, nSearchInterval, nFees, txCoinStake, key)) {
-            if (txCoinStake.nTime >= chainActive.Tip()->GetPastTimeLimit() + 1) {
-                // make sure coinstake would meet timestamp protocol
-                // as it would be the same as the block timestamp
-                CMutableTransaction txn(*block->vtx[0].get());
-                txn.nTime = block->nTime = txCoinStake.nTime;
-                block->vtx[0] = MakeTransactionRef(std::move(txn));
-
-                // We have to make sure that we have no future timestamps in
-                // our transactions set
-                for (auto it = vtx.begin(); it != vtx.end();) {
-                    auto tx = *it;
-                    if (tx->nTime > block->nTime) {
-                        it = vtx.erase(it);
-                    }
-                    else {
-                        ++it;
-                    }
+    // Worker searches once per masked timestamp, so only one second is searched here
+    int64_t nSearchInterval = 1;
+    if (wallet->CreateCoinStake(*wallet.get(), block->nBits, nSearchInterval, nFees, txCoinStake, key)) {
+        if (txCoinStake.nTime >= chainActive.Tip()->GetPastTimeLimit() + 1) {
+            // make sure coinstake would meet timestamp protocol
+            // as it would be the same as the block timestamp
+            CMutableTransaction txn(*block->vtx[0].get());
+            txn.nTime = block->nTime = txCoinStake.nTime;
+            block->vtx[0] = MakeTransactionRef(std::move(txn));
+
+            // We have to make sure that we have no future timestamps in
+            // our transactions set
+            for (auto it = vtx.begin(); it != vtx.end();) {
+                auto tx = *it;
+                if (tx->nTime > block->nTime) {
+                    it = vtx.erase(it);
+                }
+                else {
+                    ++it;
                 }
+            }
 
-                txCoinStake.nVersion = CTransaction::CURRENT_VERSION;
+            txCoinStake.nVersion = CTransaction::CURRENT_VERSION;
 
-                // After the changes, we need to resign inputs.
-                CMutableTransaction txNewConst(txCoinStake);
+            // After the changes, we need to resign inputs.
+            CMutableTransaction txNewConst(txCoinStake);
 
-                for (unsigned int i = 0; i < txCoinStake.vin.size(); i++) {
-                    bool signSuccess;
-                    uint256 prevHash = txCoinStake.vin[i].prevout.hash;
-                    uint32_t n = txCoinStake.vin[i].prevout.n;
-                    assert(wallet->mapWallet.count(prevHash));
-                    auto prevTx = wallet->GetWalletTx(prevHash);
-                    const CScript& scriptPubKey = prevTx->tx->vout[n].scriptPubKey;
-                    SignatureData sigdata;
-                    signSuccess = ProduceSignature(*wallet.get(), MutableTransactionSignatureCreator(&txNewConst, i, prevTx->tx->vout[n].nValue, SIGHASH_ALL), scriptPubKey, sigdata);
+            for (unsigned int i = 0; i < txCoinStake.vin.size(); i++) {
+                bool signSuccess;
+                uint256 prevHash = txCoinStake.vin[i].prevout.hash;
+                uint32_t n = txCoinStake.vin[i].prevout.n;
+                assert(wallet->mapWallet.count(prevHash));
+                auto prevTx = wallet->GetWalletTx(prevHash);
+                const CScript& scriptPubKey = prevTx->tx->vout[n].scriptPubKey;
+                SignatureData sigdata;
+                signSuccess = ProduceSignature(*wallet.get(), MutableTransactionSignatureCreator(&txNewConst, i, prevTx->tx->vout[n].nValue, SIGHASH_ALL), scriptPubKey, sigdata);
 
-                    if (!signSuccess) {
-                        return false;
-                    }
-                    else {
-                        UpdateInput(txCoinStake.vin[i], sigdata);
-                    }
+                if (!signSuccess) {
+                    return false;
+                }
+                else {
+                    UpdateInput(txCoinStake.vin[i], sigdata);
                 }
+            }
 
-                CTransactionRef txNew = MakeTransactionRef(std::move(txCoinStake));
-                block->vtx.insert(block->vtx.begin() + 1, txNew);
-                block->hashMerkleRoot = BlockMerkleRoot(*block);
+            CTransactionRef txNew = MakeTransactionRef(std::move(txCoinStake));
+            block->vtx.insert(block->vtx.begin() + 1, txNew);
+            block->hashMerkleRoot = BlockMerkleRoot(*block);
 
-                return key.Sign(block->GetHash(), block->vchBlockSig);
-            }
+            return key.Sign(block->GetHash(), block->vchBlockSig);
         }
-        lastCoinStakeSearchInterval = nSearchTime - nLastCoinStakeSearchTime;
-        nLastCoinStakeSearchTime = nSearchTime;
-    }
-    else {
     }
 #endif
     return false;
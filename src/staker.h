@@ -7,47 +7,93 @@
 
 #include <boost/thread.hpp>
 #include <chainparams.h>
-#include <unordered_set>
+#include <sync.h>
+#include <validationinterface.h>
+#include <map>
 #include <memory>
 
 class CWallet;
+class CReserveScript;
+struct CBlockTemplate;
+class StakeSearch;
 
-class Staker {
+/** Number of kernel search threads shared by all wallets, besides the scheduler */
+static const int DEFAULT_STAKER_THREADS = 2;
+static const int MAX_STAKER_THREADS = 16;
+/** Coins of one wallet are handed out to search threads in buckets of this size */
+static const size_t STAKER_BUCKET_SIZE = 64;
+
+/** Kernel search counters of one wallet */
+struct StakerWalletStats {
+  uint64_t kernelsTried = 0;
+  uint64_t kernelsFound = 0;
+  /** Time the search for the next kernel began, 0 if not searching */
+  int64_t searchStart = 0;
+  int64_t lastTimeToFind = 0;
+  int64_t totalTimeToFind = 0;
+};
+
+/**
+ * Single staking scheduler for all loaded wallets.
+ * Wakes up on a new tip or when the masked coinstake timestamp changes,
+ * and splits kernel search of every wallet between a fixed pool of threads.
+ */
+class Staker : public CValidationInterface {
 public:
   static Staker * getInstance();
   void setIsStaking(bool staking);
   bool getIsStaking();
   uint64_t getLastCoinStakeSearchInterval();
+  std::map<std::string, StakerWalletStats> getWalletStats();
   void startWorkers(
     boost::thread_group & threadGroup,
     CChainParams const & chainparams,
+    int threads = DEFAULT_STAKER_THREADS,
     unsigned int minerSleep = 500
   );
-  void run(CChainParams const &, boost::thread_group &);
-  void worker(CChainParams const &, std::string const & walletName);
+  void run(CChainParams const &);
+  void searchWorker();
   bool signBlock(std::shared_ptr<CBlock>, std::shared_ptr<CWallet>, int64_t);
 
+protected:
+  void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
+
 private:
   Staker();
   Staker(Staker const &);
   void operator=(Staker const &);
 
+  /** Block template of one wallet, reused while chain tip and mempool stay the same */
+  struct StakeTemplate {
+    std::shared_ptr<CReserveScript> coinbaseScript;
+    std::shared_ptr<CBlockTemplate> blocktemplate;
+    uint64_t nFees = 0;
+    uint256 hashTip;
+    unsigned int nMempoolUpdated = 0;
+  };
+
+  bool canStake(CChainParams const &);
+  void stakeWallet(CChainParams const &, std::shared_ptr<CWallet>, CBlockIndex * pindexTip, unsigned int nBits, int64_t nSearchTime);
+  bool searchKernel(std::shared_ptr<StakeSearch>);
+
   bool workersStarted;
   bool isStaking;
   unsigned int minerSleep;
   uint64_t lastCoinStakeSearchInterval;
-  std::unordered_set<std::string> walletWorkers;
-};
 
-class StakerWorker {
-public:
-  StakerWorker(
-    std::string const & walletName,
-    unsigned int minerSleep
-  );
+  boost::mutex wakeMutex;
+  boost::condition_variable wakeCond;
+  bool tipChanged;
 
-private:
-  std::string walletName;
+  boost::mutex searchMutex;
+  boost::condition_variable searchCond;
+  std::shared_ptr<StakeSearch> currentSearch;
+
+  CCriticalSection cs_stats;
+  std::map<std::string, StakerWalletStats> walletStats;
+
+  /** Used by the scheduler thread only */
+  std::map<std::string, StakeTemplate> templates;
 };
 
 #endif
@@ -0,0 +1,75 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/commenttree.h>
+
+#include <test/test_pocketcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(commenttree_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(commenttree_threads)
+{
+    CommentTree tree;
+    tree.AddComment("r1", "p", "", 100, 1);
+    tree.AddComment("r2", "p", "", 200, 2);
+    tree.AddComment("r3", "p", "", 300, 3);
+    tree.AddComment("c1", "p", "r1", 150, 2);
+    tree.AddComment("c2", "p", "r1", 120, 2);
+    tree.AddComment("c3", "p", "r1", 400, 4);
+    tree.AddComment("x", "other", "", 100, 1);
+
+    // Roots newest first, replies oldest first
+    std::vector<CommentThread> threads;
+    BOOST_CHECK_EQUAL(tree.GetThreads("p", 0, 10, 2, threads), 3);
+    BOOST_CHECK_EQUAL(threads.size(), 3U);
+    BOOST_CHECK_EQUAL(threads[0].id, "r3");
+    BOOST_CHECK_EQUAL(threads[2].id, "r1");
+    BOOST_CHECK_EQUAL(threads[2].children, 3);
+    BOOST_CHECK_EQUAL(threads[2].replies.size(), 2U);
+    BOOST_CHECK_EQUAL(threads[2].replies[0], "c2");
+    BOOST_CHECK_EQUAL(threads[2].replies[1], "c1");
+    BOOST_CHECK_EQUAL(threads[1].children, 0);
+
+    // Paging
+    threads.clear();
+    BOOST_CHECK_EQUAL(tree.GetThreads("p", 1, 1, 0, threads), 3);
+    BOOST_CHECK_EQUAL(threads.size(), 1U);
+    BOOST_CHECK_EQUAL(threads[0].id, "r2");
+    BOOST_CHECK(threads[0].replies.empty());
+
+    threads.clear();
+    BOOST_CHECK_EQUAL(tree.GetThreads("none", 0, 10, 2, threads), 0);
+    BOOST_CHECK(threads.empty());
+
+    BOOST_CHECK_EQUAL(tree.GetChildrenCount("r1"), 3);
+    BOOST_CHECK_EQUAL(tree.GetChildrenCount("c1"), 0);
+    BOOST_CHECK_EQUAL(tree.Size(), 7U);
+}
+
+BOOST_AUTO_TEST_CASE(commenttree_rollback)
+{
+    CommentTree tree;
+    tree.AddComment("r1", "p", "", 100, 1);
+    tree.AddComment("c1", "p", "r1", 150, 2);
+    tree.AddComment("r2", "p", "", 200, 3);
+
+    std::vector<std::string> above = tree.GetCommentsAbove(1);
+    BOOST_CHECK_EQUAL(above.size(), 2U);
+    for (const auto& id : above)
+        tree.RemoveComment(id);
+
+    std::vector<CommentThread> threads;
+    BOOST_CHECK_EQUAL(tree.GetThreads("p", 0, 10, 10, threads), 1);
+    BOOST_CHECK_EQUAL(threads[0].id, "r1");
+    BOOST_CHECK_EQUAL(threads[0].children, 0);
+    BOOST_CHECK(tree.GetCommentsAbove(1).empty());
+
+    // Re-adding comment does not duplicate it
+    tree.AddComment("r1", "p", "", 100, 1);
+    BOOST_CHECK_EQUAL(tree.Size(), 1U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,53 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <httpserver.h>
+
+#include <test/test_pocketcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zlib.h>
+
+BOOST_FIXTURE_TEST_SUITE(httpserver_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(httpserver_accept_encoding)
+{
+    BOOST_CHECK(ParseAcceptEncoding("") == HTTPContentEncoding::NONE);
+    BOOST_CHECK(ParseAcceptEncoding("identity, br") == HTTPContentEncoding::NONE);
+    BOOST_CHECK(ParseAcceptEncoding("gzip, deflate") == HTTPContentEncoding::GZIP);
+    BOOST_CHECK(ParseAcceptEncoding("deflate") == HTTPContentEncoding::DEFLATE);
+    BOOST_CHECK(ParseAcceptEncoding(" GZip ") == HTTPContentEncoding::GZIP);
+    BOOST_CHECK(ParseAcceptEncoding("*") == HTTPContentEncoding::GZIP);
+
+    // q-values
+    BOOST_CHECK(ParseAcceptEncoding("gzip;q=0.5, deflate") == HTTPContentEncoding::DEFLATE);
+    BOOST_CHECK(ParseAcceptEncoding("gzip;q=0, deflate;q=0") == HTTPContentEncoding::NONE);
+    BOOST_CHECK(ParseAcceptEncoding("*;q=0.1, gzip;q=0") == HTTPContentEncoding::DEFLATE);
+}
+
+BOOST_AUTO_TEST_CASE(httpserver_compress)
+{
+    std::string body;
+    for (int i = 0; i < 1000; i++)
+        body += "{\"txid\":\"" + std::to_string(i) + "\",\"address\":\"PP582V47P8vCvXjdV3inwYNgxScZCuTWsq\"},";
+
+    std::string out;
+    BOOST_CHECK(!CompressHTTPBody(body, HTTPContentEncoding::NONE, out));
+
+    // zlib wrapper is decoded by uncompress
+    BOOST_CHECK(CompressHTTPBody(body, HTTPContentEncoding::DEFLATE, out));
+    BOOST_CHECK(out.size() < body.size() / 4);
+    std::string decoded(body.size(), '\0');
+    uLongf decodedSize = decoded.size();
+    BOOST_CHECK_EQUAL(uncompress((Bytef*)&decoded[0], &decodedSize, (const Bytef*)out.data(), out.size()), Z_OK);
+    BOOST_CHECK_EQUAL(decodedSize, body.size());
+    BOOST_CHECK(decoded == body);
+
+    // gzip magic
+    BOOST_CHECK(CompressHTTPBody(body, HTTPContentEncoding::GZIP, out));
+    BOOST_CHECK(out.size() > 2 && (unsigned char)out[0] == 0x1f && (unsigned char)out[1] == 0x8b);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
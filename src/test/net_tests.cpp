@@ -10,6 +10,7 @@
 #include <streams.h>
 #include <net.h>
 #include <netbase.h>
+#include <netmessagemaker.h>
 #include <chainparams.h>
 #include <util.h>
 
@@ -189,4 +190,54 @@ BOOST_AUTO_TEST_CASE(cnode_simple_test)
     BOOST_CHECK(pnode2->fFeeler == false);
 }
 
+#ifndef WIN32
+BOOST_FIXTURE_TEST_CASE(socket_events_socketpair, TestingSetup)
+{
+    int fds[2];
+    BOOST_REQUIRE_EQUAL(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+    CAddress addr(CService(), NODE_NONE);
+    CNode* node = new CNode(0, NODE_NETWORK, 0, fds[0], addr, 0, 0, CAddress(), "", /*fInboundIn=*/ true);
+    CConnmanTest::AddNode(*node);
+    CConnmanTest::RegisterSocketEvents(*node);
+
+    // Nothing to read yet
+    CConnmanTest::SocketEvents(true);
+    BOOST_CHECK(!node->fHasRecvData);
+
+    // Peer sends a ping
+    CSerializedNetMsg msg = CNetMsgMaker(INIT_PROTO_VERSION).Make(NetMsgType::PING, (uint64_t)42);
+    uint256 hash = Hash(msg.data.data(), msg.data.data() + msg.data.size());
+    CMessageHeader hdr(Params().MessageStart(), msg.command.c_str(), msg.data.size());
+    memcpy(hdr.pchChecksum, hash.begin(), CMessageHeader::CHECKSUM_SIZE);
+    std::vector<unsigned char> data;
+    CVectorWriter{SER_NETWORK, INIT_PROTO_VERSION, data, 0, hdr};
+    data.insert(data.end(), msg.data.begin(), msg.data.end());
+    BOOST_REQUIRE_EQUAL(send(fds[1], data.data(), data.size(), 0), (ssize_t)data.size());
+
+    CConnmanTest::SocketEvents(false);
+    BOOST_CHECK(node->fHasRecvData);
+    BOOST_CHECK(CConnmanTest::SocketRecvData(*node));
+    {
+        LOCK(node->cs_vProcessMsg);
+        BOOST_REQUIRE_EQUAL(node->vProcessMsg.size(), 1U);
+        BOOST_CHECK_EQUAL(node->vProcessMsg.front().hdr.GetCommand(), NetMsgType::PING);
+    }
+
+    // Socket is drained until the read would block
+    BOOST_CHECK(!CConnmanTest::SocketRecvData(*node));
+    BOOST_CHECK(!node->fHasRecvData);
+    BOOST_CHECK(!node->fDisconnect);
+
+    // Hangup is reported as readable and disconnects the peer
+    close(fds[1]);
+    CConnmanTest::SocketEvents(false);
+    BOOST_CHECK(node->fHasRecvData);
+    BOOST_CHECK(!CConnmanTest::SocketRecvData(*node));
+    BOOST_CHECK(node->fDisconnect);
+
+    CConnmanTest::ClearNodes();
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <pos.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <pow.h>
+#include <test/test_pocketcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(pos_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(kernel_hasher_matches_kernel_hash)
+{
+    CBlockIndex prev;
+    prev.nHeight = 1000;
+    prev.nTime = 1560000000;
+    prev.nStakeModifier = 0x0123456789abcdefULL;
+
+    CStakeCandidate candidate;
+    candidate.prevout = COutPoint(uint256S("a1b2c3d4e5f60718293a4b5c6d7e8f90a1b2c3d4e5f60718293a4b5c6d7e8f90"), 3);
+    candidate.nValue = 500 * COIN;
+    candidate.nTimeBlockFrom = prev.nTime - Params().GetConsensus().nStakeMinAge - 1000;
+    candidate.nTimeTxPrev = candidate.nTimeBlockFrom - 10;
+
+    // Weighted targets near 2^255 and 2^251: most and few timestamps pass
+    for (unsigned int nBits : {0x1c0fffffU, 0x1c00ffffU}) {
+        CStakeKernelHasher hasher(&prev, nBits, candidate);
+        for (unsigned int nTimeTx = prev.nTime; nTimeTx < prev.nTime + 256; nTimeTx++) {
+            arith_uint256 hashProofOfStake, targetProofOfStake;
+            CDataStream source(SER_GETHASH, 0);
+            bool expected = CheckStakeKernelHash(&prev, nBits, candidate, nTimeTx, hashProofOfStake, source, targetProofOfStake);
+
+            BOOST_CHECK_EQUAL(hasher.Check(nTimeTx), expected);
+            BOOST_CHECK(hasher.GetSource(nTimeTx).str() == source.str());
+        }
+    }
+
+    // Coin younger than minimal stake age never passes
+    CStakeKernelHasher hasher(&prev, 0x1c0fffff, candidate);
+    BOOST_CHECK(!hasher.Check(candidate.nTimeBlockFrom + 1));
+}
+
+BOOST_AUTO_TEST_CASE(stake_index_matches_chain_walk)
+{
+    // Same chain twice, only the first one gets stake index
+    const int nBlocks = 400;
+    std::vector<CBlockIndex> indexed(nBlocks), plain(nBlocks);
+    for (int i = 0; i < nBlocks; i++) {
+        for (auto* chain : {&indexed, &plain}) {
+            CBlockIndex& index = (*chain)[i];
+            index.nHeight = i;
+            index.pprev = i ? &(*chain)[i - 1] : nullptr;
+            index.nTime = 1560000000 + i * 60 + (i % 3) * 7;
+            index.nBits = 0x1d00ffff - (i % 7) * 0x1000;
+            if (i > 20 && i % 5 != 0) index.SetProofOfStake();
+            index.SetStakeModifier(i, i % 9 == 0);
+            index.BuildSkip();
+        }
+        BuildStakeIndex(&indexed[i]);
+    }
+
+    for (int i = 0; i < nBlocks; i++) {
+        const CBlockIndex& index = indexed[i];
+        BOOST_CHECK(index.HasStakeIndex());
+        BOOST_CHECK_EQUAL(GetLastBlockIndex(&index, true)->nHeight, GetLastBlockIndex(&plain[i], true)->nHeight);
+        BOOST_CHECK_EQUAL(GetLastBlockIndex(&index, false)->nHeight, GetLastBlockIndex(&plain[i], false)->nHeight);
+
+        // Window of GetPoSKernelPS walked as before
+        double dDifficulty = 0;
+        unsigned int nTime = 0, nPairs = 0;
+        const CBlockIndex* pindexPrevStake = nullptr;
+        for (const CBlockIndex* pindex = &plain[i]; pindex && nPairs < POS_KERNEL_PS_INTERVAL; pindex = pindex->pprev) {
+            if (!pindex->IsProofOfStake()) continue;
+            if (pindexPrevStake) {
+                dDifficulty += GetPosDifficulty(pindexPrevStake);
+                nTime += pindexPrevStake->nTime - pindex->nTime;
+                nPairs++;
+            }
+            pindexPrevStake = pindex;
+        }
+
+        if (!index.pindexLastStake) {
+            BOOST_CHECK(i <= 20);
+            continue;
+        }
+        BOOST_CHECK_EQUAL(index.pindexLastStake->nChainStakeBlocks - index.pindexStakeWindow->nChainStakeBlocks, nPairs);
+        BOOST_CHECK_EQUAL(index.pindexLastStake->nTime - index.pindexStakeWindow->nTime, nTime);
+        BOOST_CHECK_SMALL(index.pindexLastStake->dChainStakeDifficulty - index.pindexStakeWindow->dChainStakeDifficulty - dDifficulty, 1e-6);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,65 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/recommendations.h>
+
+#include <test/test_pocketcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(recommendations_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(recommendations_similarity)
+{
+    std::map<std::string, std::vector<std::string>> userItems;
+    userItems["u1"] = {"a", "b"};
+    userItems["u2"] = {"a", "b", "c"};
+    userItems["u3"] = {"a", "c"};
+    userItems["u4"] = {"d"};
+
+    similarity_t similarity;
+    Recommendations::BuildSimilarity(userItems, 10, similarity);
+
+    // Item without co-occurrence has no neighbours
+    BOOST_CHECK(similarity.find("d") == similarity.end());
+
+    // a-b: 2 / sqrt(3 * 2), a-c: 2 / sqrt(3 * 2), b-c: 1 / sqrt(2 * 2)
+    BOOST_CHECK_EQUAL(similarity["a"].size(), 2U);
+    BOOST_CHECK_EQUAL(similarity["a"][0].first, "b");
+    BOOST_CHECK_EQUAL(similarity["a"][1].first, "c");
+    BOOST_CHECK_CLOSE(similarity["b"][1].second, 0.5, 0.0001);
+
+    // Neighbour list is truncated
+    Recommendations::BuildSimilarity(userItems, 1, similarity);
+    BOOST_CHECK_EQUAL(similarity["a"].size(), 1U);
+}
+
+BOOST_AUTO_TEST_CASE(recommendations_recommend)
+{
+    std::map<std::string, std::vector<std::string>> userItems;
+    userItems["u1"] = {"a", "b"};
+    userItems["u2"] = {"a", "b", "c"};
+    userItems["u3"] = {"b", "c", "d"};
+
+    similarity_t similarity;
+    Recommendations::BuildSimilarity(userItems, 10, similarity);
+
+    std::vector<std::string> result;
+    Recommendations::Recommend({"a"}, similarity, 10, result);
+    BOOST_CHECK_EQUAL(result.size(), 2U);
+    BOOST_CHECK_EQUAL(result[0], "b");
+    BOOST_CHECK_EQUAL(result[1], "c");
+
+    // Own items are never recommended, result is limited by count
+    result.clear();
+    Recommendations::Recommend({"a", "b"}, similarity, 1, result);
+    BOOST_CHECK_EQUAL(result.size(), 1U);
+    BOOST_CHECK_EQUAL(result[0], "c");
+
+    result.clear();
+    Recommendations::Recommend({"x"}, similarity, 10, result);
+    BOOST_CHECK(result.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,68 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/cache.h>
+
+#include <test/test_pocketcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(rpc_cache_tests, BasicTestingSetup)
+
+static UniValue MakeResult(const std::string& str)
+{
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("data", str);
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache_get_put)
+{
+    CRPCResultCache cache(1 << 20);
+    UniValue result;
+
+    BOOST_CHECK(!cache.Get("a", result));
+
+    cache.Put("a", MakeResult("first"));
+    BOOST_CHECK(cache.Get("a", result));
+    BOOST_CHECK_EQUAL(result["data"].get_str(), "first");
+
+    // Same key replaces value
+    cache.Put("a", MakeResult("second"));
+    BOOST_CHECK(cache.Get("a", result));
+    BOOST_CHECK_EQUAL(result["data"].get_str(), "second");
+
+    cache.Clear();
+    BOOST_CHECK(!cache.Get("a", result));
+}
+
+BOOST_AUTO_TEST_CASE(rpc_cache_eviction)
+{
+    const std::string payload(100, 'x');
+    const size_t entrySize = 2 + MakeResult(payload).write().size();
+
+    // Room for exactly three entries
+    CRPCResultCache cache(entrySize * 3);
+    UniValue result;
+
+    cache.Put("1", MakeResult(payload));
+    cache.Put("2", MakeResult(payload));
+    cache.Put("3", MakeResult(payload));
+
+    // Touch "1" so "2" becomes least recently used
+    BOOST_CHECK(cache.Get("1", result));
+
+    cache.Put("4", MakeResult(payload));
+    BOOST_CHECK(cache.Get("1", result));
+    BOOST_CHECK(!cache.Get("2", result));
+    BOOST_CHECK(cache.Get("3", result));
+    BOOST_CHECK(cache.Get("4", result));
+
+    // Entry larger than the whole budget is not stored
+    cache.Put("5", MakeResult(std::string(entrySize * 4, 'x')));
+    BOOST_CHECK(!cache.Get("5", result));
+    BOOST_CHECK(cache.Get("4", result));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
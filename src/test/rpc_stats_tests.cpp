@@ -0,0 +1,56 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/stats.h>
+
+#include <test/test_pocketcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(rpc_stats_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(rpc_stats_counters)
+{
+    CRPCStats stats;
+    for (int i = 0; i < 98; i++)
+        stats.AddCall("getnodeinfo", 200, false);
+    stats.AddCall("getnodeinfo", 40000, false);
+    stats.AddCall("getnodeinfo", 20000000, true);
+    stats.AddBytes("getnodeinfo", 100);
+    // Bytes of unknown methods are not counted
+    stats.AddBytes("unknown", 100);
+
+    auto result = stats.GetStats();
+    BOOST_CHECK_EQUAL(result.size(), 1U);
+
+    const CRPCStats::CMethodStats& method = result["getnodeinfo"];
+    BOOST_CHECK_EQUAL(method.nCalls, 100U);
+    BOOST_CHECK_EQUAL(method.nErrors, 1U);
+    BOOST_CHECK_EQUAL(method.nBytesOut, 100U);
+    BOOST_CHECK_EQUAL(method.nMaxMicros, 20000000);
+
+    // Percentiles are upper bounds of buckets, limited by maximum
+    BOOST_CHECK_EQUAL(method.Percentile(0.5), 250);
+    BOOST_CHECK_EQUAL(method.Percentile(0.99), 50000);
+    BOOST_CHECK_EQUAL(method.Percentile(1), 20000000);
+
+    stats.Reset();
+    BOOST_CHECK(stats.GetStats().empty());
+}
+
+BOOST_AUTO_TEST_CASE(rpc_stats_prometheus)
+{
+    CRPCStats stats;
+    stats.AddCall("getnodeinfo", 200, false);
+    stats.AddCall("getnodeinfo", 20000000, false);
+
+    std::string text = stats.ToPrometheus();
+    BOOST_CHECK(text.find("pocketcoin_rpc_calls_total{method=\"getnodeinfo\"} 2\n") != std::string::npos);
+    BOOST_CHECK(text.find("pocketcoin_rpc_duration_seconds_bucket{method=\"getnodeinfo\",le=\"0.00025\"} 1\n") != std::string::npos);
+    BOOST_CHECK(text.find("pocketcoin_rpc_duration_seconds_bucket{method=\"getnodeinfo\",le=\"10\"} 1\n") != std::string::npos);
+    BOOST_CHECK(text.find("pocketcoin_rpc_duration_seconds_bucket{method=\"getnodeinfo\",le=\"+Inf\"} 2\n") != std::string::npos);
+    BOOST_CHECK(text.find("pocketcoin_rpc_duration_seconds_count{method=\"getnodeinfo\"} 2\n") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
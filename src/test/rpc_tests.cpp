@@ -416,4 +416,24 @@ BOOST_AUTO_TEST_CASE(rpc_getblockstats_calculate_percentiles_by_weight)
     }
 }
 
+BOOST_AUTO_TEST_CASE(rpc_raw_json_values)
+{
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("posts", JSONRPCRawValue("[{\"txid\":\"a\"},{\"txid\":\"b\"}]"));
+    result.pushKV("height", 10);
+    BOOST_CHECK_EQUAL(JSONRPCWrite(result), "{\"posts\":[{\"txid\":\"a\"},{\"txid\":\"b\"}],\"height\":10}");
+    BOOST_CHECK_EQUAL(JSONRPCReply(result, NullUniValue, 1), "{\"result\":{\"posts\":[{\"txid\":\"a\"},{\"txid\":\"b\"}],\"height\":10},\"error\":null,\"id\":1}\n");
+
+    UniValue parsed = JSONRPCParseRaw(result);
+    BOOST_CHECK(parsed["posts"].isArray());
+    BOOST_CHECK_EQUAL(parsed["posts"][1]["txid"].get_str(), "b");
+    BOOST_CHECK_EQUAL(parsed["height"].get_int(), 10);
+
+    // Values without raw JSON are written as usual
+    UniValue plain(UniValue::VARR);
+    plain.push_back("rawjson");
+    BOOST_CHECK_EQUAL(JSONRPCWrite(plain), plain.write());
+    BOOST_CHECK_EQUAL(JSONRPCParseRaw(plain).write(), plain.write());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
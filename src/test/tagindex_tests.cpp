@@ -0,0 +1,134 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/tagindex.h>
+
+#include <test/test_pocketcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(tagindex_tests, BasicTestingSetup)
+
+typedef std::vector<std::pair<std::string, int>> tags_t;
+
+BOOST_AUTO_TEST_CASE(tagindex_prefix_search)
+{
+    TagIndex index(10);
+    index.AddPost("a", 1, "en", {"Bitcoin", "blockchain"});
+    index.AddPost("b", 2, "en", {"bitcoin", " bitcoin "});
+    index.AddPost("c", 3, "ru", {"bit", "news"});
+
+    tags_t result;
+    index.Search("BI", "", 10, result);
+    BOOST_CHECK_EQUAL(result.size(), 2U);
+    BOOST_CHECK_EQUAL(result[0].first, "bitcoin");
+    BOOST_CHECK_EQUAL(result[0].second, 2);
+    BOOST_CHECK_EQUAL(result[1].first, "bit");
+
+    result.clear();
+    index.Search("b", "ru", 10, result);
+    BOOST_CHECK_EQUAL(result.size(), 1U);
+    BOOST_CHECK_EQUAL(result[0].first, "bit");
+
+    result.clear();
+    index.Search("b", "de", 10, result);
+    BOOST_CHECK(result.empty());
+
+    result.clear();
+    index.Search("b", "", 1, result);
+    BOOST_CHECK_EQUAL(result.size(), 1U);
+    BOOST_CHECK_EQUAL(index.Size(), 4U);
+}
+
+BOOST_AUTO_TEST_CASE(tagindex_edit_and_remove)
+{
+    TagIndex index(10);
+    index.AddPost("a", 1, "en", {"one", "two"});
+    index.AddPost("b", 1, "en", {"two"});
+
+    // Edit replaces tags of previous version
+    index.AddPost("a", 2, "en", {"three"});
+
+    tags_t result;
+    index.GetTop("", 10, false, result);
+    BOOST_CHECK_EQUAL(result.size(), 2U);
+    BOOST_CHECK_EQUAL(result[0].first, "three");
+    BOOST_CHECK_EQUAL(result[0].second, 1);
+    BOOST_CHECK_EQUAL(result[1].first, "two");
+
+    index.RemovePost("a");
+    index.RemovePost("b");
+    BOOST_CHECK_EQUAL(index.Size(), 0U);
+    BOOST_CHECK(index.GetPostsAbove(0).empty());
+}
+
+BOOST_AUTO_TEST_CASE(tagindex_recency_window)
+{
+    TagIndex index(2);
+    index.AddPost("a", 1, "en", {"old"});
+    index.AddPost("b", 2, "en", {"mid"});
+    index.AddPost("c", 3, "ru", {"new"});
+    index.SetTip(3);
+
+    tags_t result;
+    index.GetTop("", 10, true, result);
+    BOOST_CHECK_EQUAL(result.size(), 2U);
+
+    result.clear();
+    index.GetTop("ru", 10, true, result);
+    BOOST_CHECK_EQUAL(result.size(), 1U);
+    BOOST_CHECK_EQUAL(result[0].first, "new");
+
+    // All time counters are not affected by window
+    result.clear();
+    index.GetTop("", 10, false, result);
+    BOOST_CHECK_EQUAL(result.size(), 3U);
+
+    // Aggregation from arbitrary block
+    result.clear();
+    index.GetTopFrom("en", 10, 1, result);
+    BOOST_CHECK_EQUAL(result.size(), 2U);
+
+    // Rollback brings old blocks back to the window
+    for (const auto& txid : index.GetPostsAbove(2))
+        index.RemovePost(txid);
+    index.SetTip(2);
+
+    result.clear();
+    index.GetTop("", 10, true, result);
+    BOOST_CHECK_EQUAL(result.size(), 2U);
+    result.clear();
+    index.Search("ne", "", 10, result);
+    BOOST_CHECK(result.empty());
+}
+
+BOOST_AUTO_TEST_CASE(tagindex_top_order_and_filter)
+{
+    TagIndex index(10);
+    index.AddPost("a", 1, "en", {"zeta", "alpha", "mid"});
+    index.AddPost("b", 2, "en", {"mid", "news-24"});
+    index.SetTip(2);
+
+    // Ties are ordered by tag
+    tags_t result;
+    index.GetTop("", 10, false, result);
+    BOOST_CHECK_EQUAL(result.size(), 4U);
+    BOOST_CHECK_EQUAL(result[0].first, "mid");
+    BOOST_CHECK_EQUAL(result[1].first, "alpha");
+    BOOST_CHECK_EQUAL(result[2].first, "news-24");
+    BOOST_CHECK_EQUAL(result[3].first, "zeta");
+
+    TagIndex::Filter letters = [](const std::string& tag) { return tag.find('-') == std::string::npos; };
+    result.clear();
+    index.GetTop("", 10, true, result, letters);
+    BOOST_CHECK_EQUAL(result.size(), 3U);
+    BOOST_CHECK_EQUAL(result[2].first, "zeta");
+
+    result.clear();
+    index.GetTopFrom("en", 10, 2, result, letters);
+    BOOST_CHECK_EQUAL(result.size(), 1U);
+    BOOST_CHECK_EQUAL(result[0].first, "mid");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,10 @@
 #include <ui_interface.h>
 #include <validation.h>
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
 const std::function<std::string(const char*)> G_TRANSLATION_FUN = nullptr;
 
 void CConnmanTest::AddNode(CNode& node)
@@ -35,6 +39,27 @@ void CConnmanTest::ClearNodes()
     g_connman->vNodes.clear();
 }
 
+void CConnmanTest::RegisterSocketEvents(CNode& node)
+{
+    LOCK(g_connman->cs_vNodes);
+#ifdef USE_EPOLL
+    // Created by Start otherwise
+    if (g_connman->epollfd == -1) g_connman->epollfd = epoll_create1(EPOLL_CLOEXEC);
+#endif
+    g_connman->RegisterSocketEvents(&node);
+}
+
+void CConnmanTest::SocketEvents(bool fNoWait)
+{
+    std::set<SOCKET> setListenReady;
+    g_connman->SocketEvents(setListenReady, fNoWait);
+}
+
+bool CConnmanTest::SocketRecvData(CNode& node)
+{
+    return g_connman->SocketRecvData(&node);
+}
+
 uint256 insecure_rand_seed = GetRandHash();
 FastRandomContext insecure_rand_ctx(insecure_rand_seed);
 
@@ -60,6 +60,9 @@ class CNode;
 struct CConnmanTest {
     static void AddNode(CNode& node);
     static void ClearNodes();
+    static void RegisterSocketEvents(CNode& node);
+    static void SocketEvents(bool fNoWait);
+    static bool SocketRecvData(CNode& node);
 };
 
 class PeerLogicValidation;
@@ -0,0 +1,147 @@
+// Copyright (c) 2019 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Unit tests for ordering of peer messages around transaction precheck
+
+#include <chainparams.h>
+#include <hash.h>
+#include <net.h>
+#include <net_processing.h>
+#include <scheduler.h>
+#include <streams.h>
+#include <utiltime.h>
+
+#include <test/test_pocketcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(txprecheck_tests, TestingSetup)
+
+static NodeId id = 100;
+
+/** Add complete message to the queue read by the message handler */
+static void QueueMessage(CNode& node, const std::string& command, const std::vector<unsigned char>& payload)
+{
+    CMessageHeader hdr(Params().MessageStart(), command.c_str(), payload.size());
+    uint256 hash = Hash(payload.begin(), payload.end());
+    memcpy(hdr.pchChecksum, hash.begin(), CMessageHeader::CHECKSUM_SIZE);
+    std::vector<unsigned char> data;
+    CVectorWriter{SER_NETWORK, INIT_PROTO_VERSION, data, 0, hdr};
+    data.insert(data.end(), payload.begin(), payload.end());
+
+    CNetMessage msg(Params().MessageStart(), SER_NETWORK, INIT_PROTO_VERSION);
+    const char* pch = (const char*)data.data();
+    int handled = msg.readHeader(pch, data.size());
+    if (!payload.empty())
+        msg.readData(pch + handled, data.size() - handled);
+    BOOST_REQUIRE(msg.complete());
+
+    LOCK(node.cs_vProcessMsg);
+    node.nProcessQueueSize += msg.vRecv.size() + CMessageHeader::HEADER_SIZE;
+    node.vProcessMsg.push_back(std::move(msg));
+}
+
+static void QueuePing(CNode& node)
+{
+    std::vector<unsigned char> payload;
+    CVectorWriter{SER_NETWORK, INIT_PROTO_VERSION, payload, 0, (uint64_t)42};
+    QueueMessage(node, NetMsgType::PING, payload);
+}
+
+/**
+ * Run the message handler for the node until `count` replies are sent or
+ * `timeout` milliseconds pass. Commands of replies are recorded in the order
+ * they are sent: malformed tx gets a reject, ping gets a pong.
+ */
+static void ProcessReplies(PeerLogicValidation& peerLogic, CNode& node, size_t count, int64_t timeout, std::vector<std::string>& replies)
+{
+    std::atomic<bool> interrupt(false);
+    int64_t nStop = GetTimeMillis() + timeout;
+    while (replies.size() < count && GetTimeMillis() < nStop) {
+        peerLogic.ProcessMessages(&node, interrupt);
+
+        // Socket is not connected, so messages stay in the send buffer as header and payload
+        LOCK(node.cs_vSend);
+        for (auto it = node.vSendMsg.begin(); it != node.vSendMsg.end(); ++it) {
+            CMessageHeader hdr(Params().MessageStart());
+            CDataStream(*it, SER_NETWORK, INIT_PROTO_VERSION) >> hdr;
+            replies.push_back(hdr.GetCommand());
+            if (hdr.nMessageSize > 0) ++it;
+        }
+        node.vSendMsg.clear();
+        node.nSendSize = 0;
+        node.fPauseSend = false;
+        MilliSleep(1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(precheck_keeps_peer_order)
+{
+    CScheduler scheduler;
+    PeerLogicValidation peerLogic(connman, scheduler, /*enable_bip61=*/true, /*precheck_threads=*/1);
+
+    CAddress addr(CService(), NODE_NONE);
+    CNode node(id++, NODE_NETWORK, 0, INVALID_SOCKET, addr, 0, 0, CAddress(), "", /*fInboundIn=*/ true);
+    node.SetSendVersion(PROTOCOL_VERSION);
+    peerLogic.InitializeNode(&node);
+    node.nVersion = PROTOCOL_VERSION;
+    node.fSuccessfullyConnected = true;
+
+    // Empty tx goes to precheck, ping received after it waits
+    QueueMessage(node, NetMsgType::TX, {});
+    QueuePing(node);
+
+    std::atomic<bool> interrupt(false);
+    peerLogic.ProcessMessages(&node, interrupt);
+    {
+        LOCK(node.cs_vProcessMsg);
+        BOOST_CHECK_EQUAL(node.vProcessMsg.size(), 1U);
+    }
+
+    std::vector<std::string> replies;
+    ProcessReplies(peerLogic, node, 2, 10000, replies);
+    BOOST_REQUIRE_EQUAL(replies.size(), 2U);
+    BOOST_CHECK_EQUAL(replies[0], NetMsgType::REJECT);
+    BOOST_CHECK_EQUAL(replies[1], NetMsgType::PONG);
+
+    bool dummy;
+    peerLogic.FinalizeNode(node.GetId(), dummy);
+}
+
+BOOST_AUTO_TEST_CASE(precheck_dropped_on_disconnect)
+{
+    CScheduler scheduler;
+    PeerLogicValidation peerLogic(connman, scheduler, /*enable_bip61=*/true, /*precheck_threads=*/1);
+
+    CAddress addr(CService(), NODE_NONE);
+    CNode node(id++, NODE_NETWORK, 0, INVALID_SOCKET, addr, 0, 0, CAddress(), "", /*fInboundIn=*/ true);
+    node.SetSendVersion(PROTOCOL_VERSION);
+    peerLogic.InitializeNode(&node);
+    node.nVersion = PROTOCOL_VERSION;
+    node.fSuccessfullyConnected = true;
+
+    QueueMessage(node, NetMsgType::TX, {});
+    std::atomic<bool> interrupt(false);
+    peerLogic.ProcessMessages(&node, interrupt);
+
+    // Pending precheck belongs to the disconnected peer only
+    bool dummy;
+    peerLogic.FinalizeNode(node.GetId(), dummy);
+    peerLogic.InitializeNode(&node);
+    MilliSleep(100);
+
+    QueuePing(node);
+    std::vector<std::string> replies;
+    ProcessReplies(peerLogic, node, 1, 10000, replies);
+    BOOST_REQUIRE_EQUAL(replies.size(), 1U);
+    BOOST_CHECK_EQUAL(replies[0], NetMsgType::PONG);
+
+    // Nothing of the dropped tx comes later
+    ProcessReplies(peerLogic, node, 2, 200, replies);
+    BOOST_CHECK_EQUAL(replies.size(), 1U);
+
+    peerLogic.FinalizeNode(node.GetId(), dummy);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
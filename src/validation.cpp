@@ -1904,6 +1904,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 	// Special case for the genesis block, skipping connection of its transactions
 	// (its coinbase is unspendable)
 	if (block.GetHash() == chainparams.GetConsensus().hashGenesisBlock) {
+		BuildStakeIndex(pindex);
 		if (!fJustCheck)
 			view.SetBestBlock(pindex->GetBlockHash());
 		return true;
@@ -1924,7 +1925,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 	if (block.IsProofOfStake()) {
 		arith_uint256 targetProofOfStake;
 		// Signature will be checked in CheckInputs(), we can avoid it here (fCheckSignature = false)
-		if (!CheckProofOfStake(pindex->pprev, block.vtx[1], block.nBits, hashProof, hashProofOfStakeSource, targetProofOfStake, NULL, false)) {
+		if (!CheckProofOfStake(pindex->pprev, block.vtx[1], view, block.nBits, hashProof, hashProofOfStakeSource, targetProofOfStake, NULL, false)) {
 			return error("ContextualCheckBlock() : check proof-of-stake signature failed for block %s", block.GetHash().GetHex());
 		}
 	}
@@ -1945,6 +1946,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 		return state.DoS(1, error("ContextualCheckBlock() : ComputeNextStakeModifier() failed"), REJECT_INVALID, "bad-stake-modifier");
 
 	pindex->SetStakeModifier(nStakeModifier, fGeneratedStakeModifier);
+	BuildStakeIndex(pindex);
 
 	nBlocksTotal++;
 
@@ -2261,6 +2263,9 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 	// add this block to the view's block chain
 	view.SetBestBlock(pindex->GetBlockHash());
 
+	// Outputs of this block may be kernels of later coinstakes
+	AddStakeTxTimes(block);
+
 	int64_t nTime5 = GetTimeMicros();
 	nTimeIndex += nTime5 - nTime4;
 	LogPrint(BCLog::BENCH, "    - Index writing: %.2fms [%.2fs (%.2fms/blk)]\n", MILLI * (nTime5 - nTime4), nTimeIndex * MICRO, nTimeIndex * MILLI / nBlocksTotal);
@@ -2791,15 +2796,15 @@ void CChainState::NotifyWSClients(const CBlock& block, CBlockIndex* blockIndex)
                 if (optype == "userInfo") {
                     reindexer::Item _user_itm;
                     if (g_pocketdb->SelectOne(reindexer::Query("UsersView").Where("txid", CondEq, txid), _user_itm).ok()) {
-                        if (_user_itm["time"].As<int64_t>() == _user_itm["regdate"].As<int64_t>()) {
-                            if (_user_itm["referrer"].As<string>() != "") {
+                        if (PocketSchema::UsersView::time.Int64(_user_itm) == PocketSchema::UsersView::regdate.Int64(_user_itm)) {
+                            if (PocketSchema::UsersView::referrer.String(_user_itm) != "") {
                             
                                 custom_fields cFields {
                                     { "mesType", optype },
                                     { "addrFrom", addr.first }
                                 };
                                 
-                                PrepareWSMessage(messages, "event", _user_itm["referrer"].As<string>(), txid, txtime, cFields);
+                                PrepareWSMessage(messages, "event", PocketSchema::UsersView::referrer.String(_user_itm), txid, txtime, cFields);
                             }
                         }
                     }
@@ -2818,7 +2823,7 @@ void CChainState::NotifyWSClients(const CBlock& block, CBlockIndex* blockIndex)
 
                         reindexer::Error errP = g_pocketdb->DB()->Select(
                             reindexer::Query("Posts", 0, 1)
-                                .Where("txid", CondEq, itmS["posttxid"].As<string>()),
+                                .Where("txid", CondEq, PocketSchema::Scores::posttxid.String(itmS)),
                             queryResP);
 
                         if (errP.ok() && queryResP.Count() > 0) {
@@ -2827,11 +2832,11 @@ void CChainState::NotifyWSClients(const CBlock& block, CBlockIndex* blockIndex)
                             custom_fields cFields {
                                 { "mesType", optype },
                                 { "addrFrom", addr.first },
-                                { "posttxid", itmS["posttxid"].As<string>() },
-                                { "upvoteVal", itmS["value"].As<string>() }
+                                { "posttxid", PocketSchema::Scores::posttxid.String(itmS) },
+                                { "upvoteVal", PocketSchema::Scores::value.String(itmS) }
                             };
 
-                            PrepareWSMessage(messages, "event", itmP["address"].As<string>(), txid, txtime, cFields);
+                            PrepareWSMessage(messages, "event", PocketSchema::Posts::address.String(itmP), txid, txtime, cFields);
                         }
                     }
                 }
@@ -2867,7 +2872,7 @@ void CChainState::NotifyWSClients(const CBlock& block, CBlockIndex* blockIndex)
                         reindexer::Item itmS(queryResS[0].GetItem());
                         reindexer::Error errP = g_pocketdb->DB()->Select(
                             reindexer::Query("Comment", 0, 1)
-                            .Where("otxid", CondEq, itmS["commentid"].As<string>())
+                            .Where("otxid", CondEq, PocketSchema::CommentScores::commentid.String(itmS))
                             .Where("last", CondEq, true),
                             queryResP);
 
@@ -2877,11 +2882,11 @@ void CChainState::NotifyWSClients(const CBlock& block, CBlockIndex* blockIndex)
                             custom_fields cFields {
                                 { "mesType", optype },
                                 { "addrFrom", addr.first },
-                                { "commentid", itmS["commentid"].As<string>() },
-                                { "upvoteVal", itmS["value"].As<string>() }
+                                { "commentid", PocketSchema::CommentScores::commentid.String(itmS) },
+                                { "upvoteVal", PocketSchema::CommentScores::value.String(itmS) }
                             };
 
-                            PrepareWSMessage(messages, "event", itmP["address"].As<string>(), txid, txtime, cFields);
+                            PrepareWSMessage(messages, "event", PocketSchema::Comment::address.String(itmP), txid, txtime, cFields);
                         }
                     }
                 }
@@ -2901,7 +2906,7 @@ void CChainState::NotifyWSClients(const CBlock& block, CBlockIndex* blockIndex)
                             reindexer::QueryResults queryResP;
                             reindexer::Error errP = g_pocketdb->DB()->Select(
                                 reindexer::Query("Posts", 0, 1)
-                                    .Where("txid", CondEq, itmS["postid"].As<string>()),
+                                    .Where("txid", CondEq, PocketSchema::Comment::postid.String(itmS)),
                                 queryResP);
 
                             if (errP.ok() && queryResP.Count() > 0) {
@@ -2910,13 +2915,13 @@ void CChainState::NotifyWSClients(const CBlock& block, CBlockIndex* blockIndex)
                                 custom_fields cFields {
                                     { "mesType", optype },
                                     { "addrFrom", addr.first },
-                                    { "posttxid", itmS["postid"].As<string>() },
-                                    { "parentid", itmS["parentid"].As<string>() },
-                                    { "answerid", itmS["answerid"].As<string>() },
+                                    { "posttxid", PocketSchema::Comment::postid.String(itmS) },
+                                    { "parentid", PocketSchema::Comment::parentid.String(itmS) },
+                                    { "answerid", PocketSchema::Comment::answerid.String(itmS) },
                                     { "reason", "post" },
                                 };
 
-                                PrepareWSMessage(messages, "event", itmP["address"].As<string>(), itmS["otxid"].As<string>(), txtime, cFields);
+                                PrepareWSMessage(messages, "event", PocketSchema::Posts::address.String(itmP), PocketSchema::Comment::otxid.String(itmS), txtime, cFields);
                             }
                         }
 
@@ -2925,7 +2930,7 @@ void CChainState::NotifyWSClients(const CBlock& block, CBlockIndex* blockIndex)
                             reindexer::QueryResults queryResP;
                             reindexer::Error errP = g_pocketdb->DB()->Select(
                                 reindexer::Query("Comment", 0, 1)
-                                    .Where("otxid", CondEq, itmS["answerid"].As<string>())
+                                    .Where("otxid", CondEq, PocketSchema::Comment::answerid.String(itmS))
                                     .Where("last", CondEq, true),
                                 queryResP);
 
@@ -2935,13 +2940,13 @@ void CChainState::NotifyWSClients(const CBlock& block, CBlockIndex* blockIndex)
                                 custom_fields cFields {
                                     { "mesType", optype },
                                     { "addrFrom", addr.first },
-                                    { "posttxid", itmS["postid"].As<string>() },
-                                    { "parentid", itmS["parentid"].As<string>() },
-                                    { "answerid", itmS["answerid"].As<string>() },
+                                    { "posttxid", PocketSchema::Comment::postid.String(itmS) },
+                                    { "parentid", PocketSchema::Comment::parentid.String(itmS) },
+                                    { "answerid", PocketSchema::Comment::answerid.String(itmS) },
                                     { "reason", "answer" },
                                 };
 
-                                PrepareWSMessage(messages, "event", itmP["address"].As<string>(), itmS["otxid"].As<string>(), txtime, cFields);
+                                PrepareWSMessage(messages, "event", PocketSchema::Comment::address.String(itmP), PocketSchema::Comment::otxid.String(itmS), txtime, cFields);
                             }
                         }
                     }
@@ -4722,6 +4727,9 @@ bool CChainState::LoadBlockIndex(const Consensus::Params& consensus_params, CBlo
 			pindexBestInvalid = pindex;
 		if (pindex->pprev)
 			pindex->BuildSkip();
+		// Flags and stake modifier are final once the block was connected
+		if (pindex->IsValid(BLOCK_VALID_SCRIPTS) || !pindex->pprev)
+			BuildStakeIndex(pindex);
 		if (pindex->IsValid(BLOCK_VALID_TREE) && (pindexBestHeader == nullptr || CBlockIndexWorkComparator()(pindexBestHeader, pindex)))
 			pindexBestHeader = pindex;
 	}
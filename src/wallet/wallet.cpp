@@ -864,6 +864,8 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFlushOnClose)
 		wtx.m_it_wtxOrdered = wtxOrdered.insert(std::make_pair(wtx.nOrderPos, &wtx));
 		wtx.nTimeSmart = ComputeTimeSmart(wtx);
 		AddToSpends(hash);
+		for (const CTxIn& txin : wtx.tx->vin)
+			mapStakeCandidates.erase(txin.prevout);
 	}
 
 	bool fUpdated = false;
@@ -873,6 +875,8 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFlushOnClose)
 		if (!wtxIn.hashUnset() && wtxIn.hashBlock != wtx.hashBlock)
 		{
 			wtx.hashBlock = wtxIn.hashBlock;
+			for (unsigned int i = 0; i < wtx.tx->vout.size(); i++)
+				mapStakeCandidates.erase(COutPoint(hash, i));
 			fUpdated = true;
 		}
 		// If no longer abandoned, update
@@ -1229,6 +1233,9 @@ void CWallet::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock) {
 
 	for (const CTransactionRef& ptx : pblock->vtx) {
 		SyncTransaction(ptx);
+		// Coins of disconnected transactions are not confirmed anymore
+		for (unsigned int i = 0; i < ptx->vout.size(); i++)
+			mapStakeCandidates.erase(COutPoint(ptx->GetHash(), i));
 	}
 }
 
@@ -4472,6 +4479,28 @@ void CWallet::AvailableCoinsForStaking(std::vector<COutput>& vCoins, unsigned in
 	}
 }
 
+bool CWallet::GetStakeCandidate(const CWalletTx& wtx, unsigned int n, CStakeCandidate& candidate) const
+{
+	AssertLockHeld(cs_main);
+	AssertLockHeld(cs_wallet);
+
+	COutPoint prevout(wtx.GetHash(), n);
+	auto it = mapStakeCandidates.find(prevout);
+	if (it != mapStakeCandidates.end() && it->second.hashBlock == wtx.hashBlock) {
+		candidate = it->second;
+		return true;
+	}
+
+	// Wallet keeps the transaction and its block, no need to read them from disk
+	if (wtx.hashUnset() || n >= wtx.tx->vout.size()) return false;
+	auto mi = mapBlockIndex.find(wtx.hashBlock);
+	if (mi == mapBlockIndex.end() || !chainActive.Contains(mi->second)) return false;
+
+	candidate = CStakeCandidate{prevout, wtx.tx->vout[n].nValue, (unsigned int)mi->second->GetBlockTime(), wtx.tx->nTime, wtx.hashBlock};
+	mapStakeCandidates[prevout] = candidate;
+	return true;
+}
+
 // Select some coins without random shuffle or best subset approximation
 bool CWallet::SelectCoinsForStaking(int64_t nTargetValue, unsigned int nSpendTime, std::set<std::pair<const CWalletTx*, unsigned int>> & setCoinsRet, int64_t & nValueRet) const
 {
@@ -4547,6 +4576,32 @@ bool CWallet::SelectCoinsForStaking(int64_t nTargetValue, unsigned int nSpendTim
 }
 
 
+bool CWallet::GetStakeCandidates(unsigned int nTime, std::vector<CStakeCandidate>& vCandidates) const
+{
+	vCandidates.clear();
+
+	int64_t nBalance = GetBalance();
+	if (nBalance < Params().GetConsensus().nStakeMinimumThreshold) {
+		return false;
+	}
+
+	std::set<std::pair<const CWalletTx*, unsigned int> > setCoins;
+	int64_t nValueIn = 0;
+	if (!SelectCoinsForStaking(nBalance, nTime, setCoins, nValueIn)) {
+		return false;
+	}
+
+	LOCK2(cs_main, cs_wallet);
+	vCandidates.reserve(setCoins.size());
+	for (auto & pcoin : setCoins) {
+		CStakeCandidate candidate;
+		if (GetStakeCandidate(*pcoin.first, pcoin.second, candidate)) {
+			vCandidates.push_back(candidate);
+		}
+	}
+	return !vCandidates.empty();
+}
+
 bool CWallet::CreateCoinStake(const CKeyStore& keystore, unsigned int nBits, int64_t nSearchInterval, int64_t nFees, CMutableTransaction& txNew, CKey& key)
 {
     // We need create new coin after current chain
@@ -4587,19 +4642,31 @@ bool CWallet::CreateCoinStake(const CKeyStore& keystore, unsigned int nBits, int
 		return false;
 	}
 
+	// Kernel inputs of selected coins, the search below only hashes them
+	std::vector<std::pair<std::pair<const CWalletTx*, unsigned int>, CStakeCandidate>> vCandidates;
+	{
+		LOCK2(cs_main, cs_wallet);
+		for (auto & pcoin : setCoins) {
+			CStakeCandidate candidate;
+			if (GetStakeCandidate(*pcoin.first, pcoin.second, candidate))
+				vCandidates.emplace_back(pcoin, candidate);
+		}
+	}
+
 	int64_t nCredit = 0;
 	CScript scriptPubKeyKernel;
 	CDataStream hashProofOfStakeSource(SER_GETHASH, 0);
-	for (auto & pcoin : setCoins) {
+	for (auto & entry : vCandidates) {
+		const auto& pcoin = entry.first;
 		static int nMaxStakeSearchInterval = 60;
 		bool fKernelFound = false;
+		CStakeKernelHasher hasher(pindexPrev, nBits, entry.second);
 		for (unsigned int n = 0; n < fmin(nSearchInterval, (int64_t)nMaxStakeSearchInterval) && !fKernelFound && pindexPrev == chainActive.Tip(); n++) {
 			boost::this_thread::interruption_point();
 			// Search backward in time from the given txNew timestamp
 			// Search nSearchInterval seconds back up to nMaxStakeSearchInterval
-			COutPoint prevoutStake = COutPoint(pcoin.first->tx->GetHash(), pcoin.second);
-			int64_t nBlockTime;
-			if (CheckKernel(pindexPrev, nBits, txNew.nTime - n, prevoutStake, &nBlockTime, this, hashProofOfStakeSource)) {
+			if (hasher.Check(txNew.nTime - n)) {
+				hashProofOfStakeSource = hasher.GetSource(txNew.nTime - n);
 				// Found a kernel
 				// LogPrintf("CreateCoinStake : kernel found\n");
 				std::vector<std::vector<unsigned char>> vSolutions;
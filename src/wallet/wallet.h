@@ -9,6 +9,7 @@
 #include <amount.h>
 #include <outputtype.h>
 #include <policy/feerate.h>
+#include <pos.h>
 #include <streams.h>
 #include <tinyformat.h>
 #include <ui_interface.h>
@@ -718,6 +719,13 @@ public:
                     const CCoinControl& coin_control, CoinSelectionParams& coin_selection_params, bool& bnb_used) const;
     bool SelectCoinsForStaking(int64_t nTargetValue, unsigned int nSpendTime, std::set<std::pair<const CWalletTx*,unsigned int> >& setCoinsRet, int64_t& nValueRet) const;
     void AvailableCoinsForStaking(std::vector<COutput>& vCoins, unsigned int nSpendTime) const;
+    /**
+     * Kernel inputs of confirmed wallet coin taken from wallet and block index,
+     * cached until the coin is spent or its transaction moves to another block
+     */
+    bool GetStakeCandidate(const CWalletTx& wtx, unsigned int n, CStakeCandidate& candidate) const EXCLUSIVE_LOCKS_REQUIRED(cs_main, cs_wallet);
+    /** Kernel inputs of all coins CreateCoinStake would search at nTime */
+    bool GetStakeCandidates(unsigned int nTime, std::vector<CStakeCandidate>& vCandidates) const;
 
     /** Get a name for this wallet for logging/debugging purposes.
      */
@@ -759,6 +767,9 @@ public:
 
     std::set<COutPoint> setLockedCoins;
 
+    /** Cache of GetStakeCandidate */
+    mutable std::map<COutPoint, CStakeCandidate> mapStakeCandidates;
+
     const CWalletTx* GetWalletTx(const uint256& hash) const;
 
     //! check whether we are allowed to upgrade (or already support) to the named feature